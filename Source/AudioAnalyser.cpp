@@ -0,0 +1,510 @@
+#include "AudioAnalyser.h"
+
+namespace {
+// log2 from the float's exponent plus a polynomial fit of the mantissa (error about 1e-4).
+// Branch free, so the loop compiles to SIMD instead of calling log10 per bin.
+void powerToDecibels(const float *power, float *decibels, int numValues, float offsetDb, float floorDb) {
+    constexpr float decibelsPerLog2 = 3.0102999566f; // 10 * log10(2)
+
+    for (int i = 0; i < numValues; ++i) {
+        auto value = juce::jmax(power[i], 1.0e-30f);
+
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        auto exponent = (float)((int)(bits >> 23) - 127);
+        bits = (bits & 0x007fffffu) | 0x3f800000u;
+
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+        auto log2Mantissa =
+            -2.5056146f +
+            (4.0496166f + (-2.0994020f + (0.63551097f - 0.080010852f * mantissa) * mantissa) * mantissa) * mantissa;
+
+        decibels[i] = juce::jmax(floorDb, (exponent + log2Mantissa) * decibelsPerLog2 + offsetDb);
+    }
+}
+} // namespace
+
+//==============================================================================
+AudioAnalyser::AudioAnalyser(int maximumChannels) : juce::Thread("Audio analysis"), maxChannels(maximumChannels) {
+    displayPower.assign((size_t)numDisplayBins, 0.0f);
+
+    published.spectrumSize = numDisplayBins;
+    published.minFrequency = minDisplayFrequency;
+    published.maxFrequency = maxDisplayFrequency;
+    published.peakLevels.assign((size_t)maxChannels, 0.0f);
+    published.rmsLevels.assign((size_t)maxChannels, 0.0f);
+    published.truePeakLevels.assign((size_t)maxChannels, 0.0f);
+    published.spectrum.assign((size_t)maxChannels * (size_t)numDisplayBins, spectrumFloorDb);
+    published.goniometer.assign((size_t)numGoniometerPoints * 2, 0.0f);
+    goniometerPoints.assign((size_t)numGoniometerPoints * 2, 0.0f);
+    spectrogramColumn.assign((size_t)numDisplayBins, spectrumFloorDb);
+}
+
+AudioAnalyser::~AudioAnalyser() { release(); }
+
+void AudioAnalyser::prepare(double newSampleRate, int maximumBlockSize, int channels) {
+    release();
+
+    sampleRate = newSampleRate;
+    numChannels = juce::jlimit(1, maxChannels, channels);
+
+    // A multiple of 16 samples, so every channel has the same SIMD alignment
+    auto ringSize = juce::jmax(1 << maxFFTOrder, (int)(sampleRate * ringSeconds), maximumBlockSize * 4);
+    ringSize = (ringSize + 15) & ~15;
+    ringBuffer.setSize(numChannels, ringSize);
+    ringBuffer.clear();
+    ringFifo.setTotalSize(ringSize);
+
+    channelPointers.resize((size_t)numChannels);
+    hopPeaks.assign((size_t)numChannels, 0.0f);
+    hopSumsOfSquares.assign((size_t)numChannels, 0.0f);
+    frameSpectrum.assign((size_t)numChannels * (size_t)numDisplayBins, spectrumFloorDb);
+
+    loudnessMeter.prepare(sampleRate, numChannels);
+
+    hopStereoSums = stereoSums = {};
+    std::fill(goniometerPoints.begin(), goniometerPoints.end(), 0.0f);
+    goniometerPosition = samplesUntilPoint = 0;
+    goniometerStride = juce::jmax(1, juce::roundToInt(sampleRate * goniometerSeconds / numGoniometerPoints));
+
+    publishLock.beginWrite();
+    published.numChannels = numChannels;
+    std::fill(published.peakLevels.begin(), published.peakLevels.end(), 0.0f);
+    std::fill(published.rmsLevels.begin(), published.rmsLevels.end(), 0.0f);
+    std::fill(published.truePeakLevels.begin(), published.truePeakLevels.end(), 0.0f);
+    std::fill(published.spectrum.begin(), published.spectrum.end(), spectrumFloorDb);
+    std::fill(published.goniometer.begin(), published.goniometer.end(), 0.0f);
+    published.correlation = 0.0f;
+    publishLock.endWrite();
+
+    // Forces the stages and display bins to be rebuilt for the new sample rate
+    activeFFTOrder = 0;
+
+    startThread(juce::Thread::Priority::low);
+}
+
+void AudioAnalyser::release() { stopThread(1000); }
+
+//==============================================================================
+void AudioAnalyser::pushSamples(const juce::AudioBuffer<float> &buffer) {
+    auto numSamples = buffer.getNumSamples();
+    auto numToWrite = juce::jmin(numSamples, ringFifo.getFreeSpace());
+    if (numToWrite < numSamples)
+        numDroppedSamples += numSamples - numToWrite;
+
+    int start1, size1, start2, size2;
+    ringFifo.prepareToWrite(numToWrite, start1, size1, start2, size2);
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        if (channel < buffer.getNumChannels()) {
+            if (size1 > 0)
+                ringBuffer.copyFrom(channel, start1, buffer, channel, 0, size1);
+            if (size2 > 0)
+                ringBuffer.copyFrom(channel, start2, buffer, channel, size1, size2);
+        } else {
+            ringBuffer.clear(channel, start1, size1);
+            ringBuffer.clear(channel, start2, size2);
+        }
+    }
+
+    ringFifo.finishedWrite(size1 + size2);
+}
+
+//==============================================================================
+void AudioAnalyser::setFFTOrder(int order) { fftOrder = juce::jlimit(minFFTOrder, maxFFTOrder, order); }
+
+void AudioAnalyser::setHopSize(int samples) { hopSize = juce::jlimit(1, 1 << maxFFTOrder, samples); }
+
+bool AudioAnalyser::getSnapshot(AnalysisSnapshot &snapshot) const {
+    if (snapshot.spectrum.size() != published.spectrum.size()) {
+        snapshot.peakLevels.resize(published.peakLevels.size());
+        snapshot.rmsLevels.resize(published.rmsLevels.size());
+        snapshot.truePeakLevels.resize(published.truePeakLevels.size());
+        snapshot.spectrum.resize(published.spectrum.size());
+        snapshot.goniometer.resize(published.goniometer.size());
+    }
+
+    return publishLock.read(snapshot.version, [&] {
+        // Only the channels in use. A torn channel count is caught by the retry, and the
+        // vectors are allocated for the maximum, so it can never index past their end.
+        auto channels = (size_t)juce::jlimit(0, maxChannels, published.numChannels);
+        auto spectrumValues = channels * (size_t)numDisplayBins;
+
+        snapshot.numChannels = (int)channels;
+        snapshot.spectrumSize = published.spectrumSize;
+        snapshot.minFrequency = published.minFrequency;
+        snapshot.maxFrequency = published.maxFrequency;
+        std::copy_n(published.peakLevels.begin(), channels, snapshot.peakLevels.begin());
+        std::copy_n(published.rmsLevels.begin(), channels, snapshot.rmsLevels.begin());
+        std::copy_n(published.truePeakLevels.begin(), channels, snapshot.truePeakLevels.begin());
+        snapshot.momentaryLoudness = published.momentaryLoudness;
+        snapshot.shortTermLoudness = published.shortTermLoudness;
+        snapshot.integratedLoudness = published.integratedLoudness;
+        std::copy_n(published.spectrum.begin(), spectrumValues, snapshot.spectrum.begin());
+        snapshot.correlation = published.correlation;
+        std::copy(published.goniometer.begin(), published.goniometer.end(), snapshot.goniometer.begin());
+    });
+}
+
+//==============================================================================
+void AudioAnalyser::run() {
+    while (!threadShouldExit()) {
+        applySettings();
+
+        // Polled rather than signalled - waking a thread isn't real-time safe on every platform
+        auto numReady = ringFifo.getNumReady();
+        if (numReady == 0) {
+            wait(pollIntervalMs);
+            continue;
+        }
+
+        readFromRing(numReady);
+    }
+}
+
+void AudioAnalyser::applySettings() {
+    if (loudnessResetPending.exchange(false))
+        loudnessMeter.reset();
+
+    auto order = fftOrder.load();
+    auto size = 1 << order;
+    auto hop = juce::jmin(hopSize.load(), size);
+
+    auto engine = fftEngine.load();
+    if (order != activeFFTOrder || engine != activeFFTEngine) {
+        activeFFTEngine = engine;
+        fft = std::make_unique<RealFFT>(order, engine);
+    }
+
+    if (order != activeFFTOrder) {
+        activeFFTOrder = order;
+
+        window.resize((size_t)size);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t)size,
+                                                                 juce::dsp::WindowingFunction<float>::hann, false);
+        fftData.assign((size_t)size * 2, 0.0f);
+
+        createStages();
+        createDisplayBins();
+
+        publishLock.beginWrite();
+        std::fill(published.spectrum.begin(), published.spectrum.end(), spectrumFloorDb);
+        publishLock.endWrite();
+
+        activeHopSize = 0;
+    }
+
+    if (hop != activeHopSize) {
+        activeHopSize = hop;
+
+        // Lower stages run at the same frame rate where they can, but never overlap by more than 75%
+        for (auto &stage : stages) {
+            stage.hopSize = stage.decimation == 1 ? hop : juce::jmax(hop / stage.decimation, size / 4);
+            stage.samplesSinceFrame = juce::jmin(stage.samplesSinceFrame, stage.hopSize);
+        }
+
+        // Same smoothing and decay times whatever the frame rate
+        spectrumSmoothing = (float)std::exp(-(double)hop / (sampleRate * spectrumSmoothingSeconds));
+        peakDecay = (float)std::exp(-(double)hop / (sampleRate * peakDecaySeconds));
+        correlationDecay = std::exp(-(double)hop / (sampleRate * correlationSeconds));
+    }
+}
+
+void AudioAnalyser::createStages() {
+    auto size = 1 << activeFFTOrder;
+    auto maxInputSize = ringBuffer.getNumSamples();
+
+    stages.clear();
+    stages.resize((size_t)numStages);
+
+    for (size_t index = 0; index < stages.size(); ++index) {
+        auto &stage = stages[index];
+        auto inputRate = sampleRate;
+
+        if (index > 0) {
+            stage.decimation = stages[index - 1].decimation * stageDecimation;
+            inputRate = sampleRate / stages[index - 1].decimation;
+
+            // Elliptic low-pass: flat up to the passband edge, 80 dB down at the new Nyquist frequency
+            auto cutoff = (float)(inputRate * 0.5 / stageDecimation * stagePassband);
+            auto transitionWidth = (float)(0.5 / stageDecimation * (1.0 - stagePassband));
+            auto coefficients = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderEllipticMethod(
+                cutoff, inputRate, transitionWidth, -0.1f, -80.0f);
+
+            stage.antiAliasFilters.resize((size_t)numChannels);
+            for (auto &filters : stage.antiAliasFilters)
+                for (auto *sectionCoefficients : coefficients)
+                    filters.emplace_back(sectionCoefficients);
+
+            maxInputSize = maxInputSize / stageDecimation + 1;
+            stage.input.setSize(numChannels, maxInputSize);
+        }
+
+        auto stageRate = sampleRate / stage.decimation;
+        stage.binWidth = stageRate / size;
+        stage.maxFrequency = index == 0 ? sampleRate * 0.5 : stageRate * 0.5 * stagePassband;
+
+        stage.history.setSize(numChannels, size);
+        stage.history.clear();
+        stage.power.assign((size_t)numChannels * (size_t)size / 2, 0.0f);
+    }
+}
+
+void AudioAnalyser::createDisplayBins() {
+    auto maxFrequency = juce::jmin((double)maxDisplayFrequency, sampleRate * 0.5);
+    auto binRatio = std::pow(maxFrequency / minDisplayFrequency, 1.0 / numDisplayBins);
+    auto numFFTBins = (1 << activeFFTOrder) / 2;
+
+    displayBins.resize((size_t)numDisplayBins);
+
+    for (int index = 0; index < numDisplayBins; ++index) {
+        auto low = minDisplayFrequency * std::pow(binRatio, index);
+        auto high = low * binRatio;
+
+        // The deepest stage that still covers the whole display bin has the finest resolution
+        auto stageIndex = 0;
+        while (stageIndex + 1 < numStages && high <= stages[(size_t)stageIndex + 1].maxFrequency)
+            ++stageIndex;
+
+        auto &stage = stages[(size_t)stageIndex];
+        auto &bin = displayBins[(size_t)index];
+        bin.stage = stageIndex;
+        bin.firstBin = juce::jlimit(0, numFFTBins - 1, (int)std::ceil(low / stage.binWidth));
+        bin.endBin = juce::jlimit(0, numFFTBins, (int)std::floor(high / stage.binWidth) + 1);
+        bin.position = (float)juce::jlimit(0.0, numFFTBins - 2.0, std::sqrt(low * high) / stage.binWidth);
+    }
+
+    publishLock.beginWrite();
+    published.maxFrequency = (float)maxFrequency;
+    publishLock.endWrite();
+}
+
+//==============================================================================
+void AudioAnalyser::readFromRing(int numReady) {
+    int start1, size1, start2, size2;
+    ringFifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+    for (auto [start, size] : {std::make_pair(start1, size1), std::make_pair(start2, size2)}) {
+        if (size == 0)
+            continue;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            channelPointers[(size_t)channel] = ringBuffer.getReadPointer(channel, start);
+
+        feedStage(0, channelPointers.data(), size);
+        loudnessMeter.process(channelPointers.data(), size);
+    }
+
+    ringFifo.finishedRead(size1 + size2);
+}
+
+void AudioAnalyser::feedStage(size_t stageIndex, const float *const *channels, int numSamples) {
+    auto &stage = stages[stageIndex];
+    auto size = stage.history.getNumSamples();
+
+    for (int offset = 0; offset < numSamples;) {
+        // Copy up to the next frame boundary or the end of the history, whichever comes first
+        auto numToCopy = juce::jmin(numSamples - offset, stage.hopSize - stage.samplesSinceFrame,
+                                    size - stage.historyPosition);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            stage.history.copyFrom(channel, stage.historyPosition, channels[channel] + offset, numToCopy);
+
+        if (stageIndex == 0) {
+            measureLevels(channels, offset, numToCopy);
+            measureStereoField(channels, offset, numToCopy);
+        }
+
+        stage.historyPosition = (stage.historyPosition + numToCopy) % size;
+        stage.samplesSinceFrame += numToCopy;
+        offset += numToCopy;
+
+        if (stage.samplesSinceFrame == stage.hopSize) {
+            stage.samplesSinceFrame = 0;
+            analyseStage(stage);
+
+            // The top stage runs most often and drives the published frame rate
+            if (stageIndex == 0)
+                publishFrame();
+        }
+    }
+
+    if (stageIndex + 1 < stages.size()) {
+        auto &nextStage = stages[stageIndex + 1];
+        auto numDecimated = decimateInto(nextStage, channels, numSamples);
+        feedStage(stageIndex + 1, nextStage.input.getArrayOfReadPointers(), numDecimated);
+    }
+}
+
+int AudioAnalyser::decimateInto(Stage &stage, const float *const *channels, int numSamples) {
+    auto numDecimated = 0;
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        auto &filters = stage.antiAliasFilters[(size_t)channel];
+        auto *source = channels[channel];
+        auto *destination = stage.input.getWritePointer(channel);
+        auto phase = stage.decimationPhase;
+        numDecimated = 0;
+
+        for (int i = 0; i < numSamples; ++i) {
+            auto sample = source[i];
+            for (auto &filter : filters)
+                sample = filter.processSample(sample);
+
+            if (++phase == stageDecimation) {
+                phase = 0;
+                destination[numDecimated++] = sample;
+            }
+        }
+    }
+
+    stage.decimationPhase = (stage.decimationPhase + numSamples) % stageDecimation;
+    return numDecimated;
+}
+
+void AudioAnalyser::measureLevels(const float *const *channels, int offset, int numSamples) {
+    for (int channel = 0; channel < numChannels; ++channel) {
+        // Peak and sum of squares in one vectorised pass
+        auto index = (size_t)channel;
+        SignalKernels::Levels levels;
+        levels.peak = hopPeaks[index];
+        SignalKernels::measureLevels(channels[channel] + offset, numSamples, levels);
+
+        hopPeaks[index] = levels.peak;
+        hopSumsOfSquares[index] += (float)levels.sumOfSquares;
+    }
+}
+
+void AudioAnalyser::measureStereoField(const float *const *channels, int offset, int numSamples) {
+    auto *left = channels[0] + offset;
+    auto *right = channels[juce::jmin(1, numChannels - 1)] + offset;
+
+    SignalKernels::measureStereo(left, right, numSamples, hopStereoSums);
+
+    // Every goniometerStride-th sample, as side and mid (rotated by 45 degrees, same scale)
+    constexpr auto scale = juce::MathConstants<float>::sqrt2 * 0.5f;
+    auto *points = goniometerPoints.data();
+
+    for (auto i = samplesUntilPoint; i < numSamples; i += goniometerStride) {
+        points[goniometerPosition * 2] = (right[i] - left[i]) * scale;
+        points[goniometerPosition * 2 + 1] = (left[i] + right[i]) * scale;
+        goniometerPosition = (goniometerPosition + 1) % numGoniometerPoints;
+        samplesUntilPoint = i + goniometerStride;
+    }
+
+    samplesUntilPoint = juce::jmax(0, samplesUntilPoint - numSamples);
+}
+
+void AudioAnalyser::analyseStage(Stage &stage) {
+    auto size = stage.history.getNumSamples();
+    auto numBins = size / 2;
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        // Unroll the circular history, oldest sample first, and window it
+        auto *samples = stage.history.getReadPointer(channel);
+        auto numToEnd = size - stage.historyPosition;
+        juce::FloatVectorOperations::multiply(fftData.data(), samples + stage.historyPosition, window.data(),
+                                              numToEnd);
+        juce::FloatVectorOperations::multiply(fftData.data() + numToEnd, samples, window.data() + numToEnd,
+                                              stage.historyPosition);
+
+        fft->performForward(fftData.data());
+
+        // Interleaved re/im pairs -> power
+        auto *power = stage.power.data() + (size_t)channel * (size_t)numBins;
+        for (int bin = 0; bin < numBins; ++bin) {
+            auto re = fftData[(size_t)bin * 2];
+            auto im = fftData[(size_t)bin * 2 + 1];
+            power[bin] = re * re + im * im;
+        }
+    }
+}
+
+void AudioAnalyser::publishFrame() {
+    auto numFFTBins = (1 << activeFFTOrder) / 2;
+
+    // A full scale sine through a Hann window peaks at size / 4
+    auto offsetDb = juce::Decibels::gainToDecibels(2.0f / (float)numFFTBins);
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        for (size_t index = 0; index < displayBins.size(); ++index) {
+            const auto &bin = displayBins[index];
+            auto *power = stages[(size_t)bin.stage].power.data() + (size_t)channel * (size_t)numFFTBins;
+
+            if (bin.endBin > bin.firstBin) {
+                displayPower[index] =
+                    juce::FloatVectorOperations::findMaximum(power + bin.firstBin, bin.endBin - bin.firstBin);
+            } else {
+                auto lower = (int)bin.position;
+                auto fraction = bin.position - (float)lower;
+                displayPower[index] = power[lower] + (power[lower + 1] - power[lower]) * fraction;
+            }
+        }
+
+        powerToDecibels(displayPower.data(), frameSpectrum.data() + (size_t)channel * (size_t)numDisplayBins,
+                        numDisplayBins, offsetDb, spectrumFloorDb);
+    }
+
+    addToSpectrogram();
+
+    auto resetLevels = levelResetPending.exchange(false);
+
+    stereoSums.leftSquares = stereoSums.leftSquares * correlationDecay + hopStereoSums.leftSquares;
+    stereoSums.rightSquares = stereoSums.rightSquares * correlationDecay + hopStereoSums.rightSquares;
+    stereoSums.products = stereoSums.products * correlationDecay + hopStereoSums.products;
+    hopStereoSums = {};
+
+    // Only the cheap part happens inside the write, so readers rarely have to retry
+    publishLock.beginWrite();
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        auto index = (size_t)channel;
+
+        auto heldPeak = resetLevels ? 0.0f : published.peakLevels[index] * peakDecay;
+        published.peakLevels[index] = juce::jmax(hopPeaks[index], heldPeak);
+        published.rmsLevels[index] = std::sqrt(hopSumsOfSquares[index] / (float)activeHopSize);
+        published.truePeakLevels[index] = loudnessMeter.getTruePeak(channel);
+
+        auto *spectrum = published.spectrum.data() + index * (size_t)numDisplayBins;
+        juce::FloatVectorOperations::multiply(spectrum, spectrumSmoothing, numDisplayBins);
+        juce::FloatVectorOperations::addWithMultiply(spectrum, frameSpectrum.data() + index * (size_t)numDisplayBins,
+                                                     1.0f - spectrumSmoothing, numDisplayBins);
+    }
+
+    published.momentaryLoudness = loudnessMeter.getMomentaryLoudness();
+    published.shortTermLoudness = loudnessMeter.getShortTermLoudness();
+    published.integratedLoudness = loudnessMeter.getIntegratedLoudness();
+
+    // Unrolled, oldest point first
+    auto numToEnd = (size_t)(numGoniometerPoints - goniometerPosition) * 2;
+    std::copy(goniometerPoints.begin() + (std::ptrdiff_t)goniometerPosition * 2, goniometerPoints.end(),
+              published.goniometer.begin());
+    std::copy(goniometerPoints.begin(), goniometerPoints.begin() + (std::ptrdiff_t)goniometerPosition * 2,
+              published.goniometer.begin() + (std::ptrdiff_t)numToEnd);
+    published.correlation = stereoSums.getCorrelation();
+
+    publishLock.endWrite();
+
+    std::fill(hopPeaks.begin(), hopPeaks.end(), 0.0f);
+    std::fill(hopSumsOfSquares.begin(), hopSumsOfSquares.end(), 0.0f);
+}
+
+void AudioAnalyser::addToSpectrogram() {
+    for (int channel = 0; channel < numChannels; ++channel)
+        juce::FloatVectorOperations::max(spectrogramColumn.data(), spectrogramColumn.data(),
+                                         frameSpectrum.data() + (size_t)channel * (size_t)numDisplayBins,
+                                         numDisplayBins);
+
+    // Fixed column rate whatever the hop size - frames in between are combined, keeping short events visible
+    auto samplesPerColumn = sampleRate / spectrogramColumnsPerSecond;
+    samplesSinceColumn += activeHopSize;
+    if (samplesSinceColumn < samplesPerColumn)
+        return;
+
+    spectrogram.addColumn(spectrogramColumn.data());
+    std::fill(spectrogramColumn.begin(), spectrogramColumn.end(), spectrumFloorDb);
+    samplesSinceColumn = std::fmod(samplesSinceColumn, samplesPerColumn);
+}
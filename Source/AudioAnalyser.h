@@ -0,0 +1,249 @@
+#pragma once
+
+#include "LoudnessMeter.h"
+#include "RealFFT.h"
+#include "SeqLock.h"
+#include "SignalKernels.h"
+#include "SpectrogramHistory.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    One consistent frame of analysis results: levels and spectrum of every
+    channel, all computed from the same samples.
+*/
+struct AnalysisSnapshot {
+    juce::uint64 version = 0; // 0 until the first frame was copied
+    int numChannels = 0;      // The per-channel vectors have room for more; only these are valid
+    int spectrumSize = 0;
+
+    // The spectrum bins are log spaced between these frequencies
+    float minFrequency = 0.0f;
+    float maxFrequency = 0.0f;
+
+    std::vector<float> peakLevels; // Gain, held with a decay
+    std::vector<float> rmsLevels;  // Gain, over the last hop
+    std::vector<float> spectrum;   // dB, spectrumSize bins per channel, channel after channel
+
+    // EBU R128 loudness in LUFS, and true peak (gain) per channel since the last loudness reset
+    float momentaryLoudness = LoudnessMeter::minimumLoudness;
+    float shortTermLoudness = LoudnessMeter::minimumLoudness;
+    float integratedLoudness = LoudnessMeter::minimumLoudness;
+    std::vector<float> truePeakLevels;
+
+    // Stereo field of the first two channels (a mono signal reads as both)
+    float correlation = 0.0f;        // -1 to +1, smoothed
+    std::vector<float> goniometer;   // x, y pairs, oldest first: side (R - L) on x, mid (L + R) on y
+
+    int getNumGoniometerPoints() const { return (int)goniometer.size() / 2; }
+
+    const float *getSpectrum(int channel) const { return spectrum.data() + (size_t)channel * (size_t)spectrumSize; }
+
+    // Centre frequency of a spectrum bin
+    float getBinFrequency(int bin) const {
+        return minFrequency * std::pow(maxFrequency / minFrequency, ((float)bin + 0.5f) / (float)spectrumSize);
+    }
+};
+
+//==============================================================================
+/**
+    Runs the audio analysis (levels and spectrum) on its own thread.
+
+    The audio thread only copies samples into a lock-free single producer,
+    single consumer ring - a flat memcpy per block, however expensive the
+    analysis is. The analysis thread drains the ring and measures peak and RMS
+    levels over each hop, EBU R128 loudness and true peaks (see LoudnessMeter),
+    the stereo field, and a log-frequency spectrum of numDisplayBins bins.
+
+    The spectrum is multi-resolution: the signal is low-passed and decimated by
+    4 for each further stage, and every stage runs an FFT of the same size. The
+    deepest stage covering a display bin supplies it, so a 1024 point FFT gets
+    3 Hz resolution at the bottom (16x decimated) and 43 Hz at the top, at a
+    fraction of the cost of one large FFT. Lower stages update less often,
+    matching their longer windows.
+
+    - FFT frames overlap: the top stage runs every hop size samples
+    - FFT bins are reduced to display bins (peak of the bins inside each
+      display bin, interpolated where the display bin is narrower) before the
+      vectorised dB conversion, so only numDisplayBins values are converted
+    - The spectrum is smoothed with a time constant, so it looks the same for
+      any FFT or hop size
+    - Correlation of the first two channels from SIMD dot products, averaged
+      over correlationSeconds; the goniometer gets the last
+      numGoniometerPoints points of a decimated sample stream spanning
+      goniometerSeconds, a fixed size whatever the sample rate
+
+    The unsmoothed spectrum (loudest channel per bin) also goes into a
+    SpectrogramHistory of spectrogramColumnsPerSecond columns per second,
+    holding the last spectrogramSeconds.
+
+    Each frame is published under a SeqLock. getSnapshot() copies a complete
+    frame without ever blocking the analysis thread, and tells the caller
+    whether the frame is new.
+
+    FFT size, FFT engine and hop size can be changed at any time; the analysis
+    thread picks up the new settings before its next frame. Spectrum levels are
+    normalised so a full scale sine reads about 0 dB.
+
+    The channel count is set by prepare(), up to the maximum given to the
+    constructor. The published frame is allocated for the maximum once, so a
+    reader copying it can never see it reallocated.
+*/
+class AudioAnalyser : private juce::Thread {
+  public:
+    //==============================================================================
+    explicit AudioAnalyser(int maxChannels);
+    ~AudioAnalyser() override;
+
+    // Allocates everything for numChannels channels and starts the analysis thread. Not real-time safe.
+    void prepare(double sampleRate, int maximumBlockSize, int numChannels);
+    void release();
+
+    // Audio thread: copies the block into the ring. Never blocks or allocates.
+    void pushSamples(const juce::AudioBuffer<float> &buffer);
+
+    // Settings (any thread)
+    void setFFTOrder(int order);
+    void setHopSize(int samples);
+    void setFFTEngine(RealFFT::Engine engine) { fftEngine = engine; }
+    int getFFTSize() const { return 1 << fftOrder.load(); }
+    RealFFT::Engine getFFTEngine() const { return fftEngine.load(); }
+    int getHopSize() const { return hopSize.load(); }
+
+    // Clears the held peaks with the next frame
+    void resetLevels() { levelResetPending = true; }
+
+    // Restarts the integrated loudness and clears the true peaks
+    void resetLoudness() { loudnessResetPending = true; }
+
+    // Copies the latest frame if it is newer than snapshot.version. Any thread;
+    // the first call allocates the snapshot's storage.
+    bool getSnapshot(AnalysisSnapshot &snapshot) const;
+
+    // Spectrogram columns, written by the analysis thread. One reader at a time.
+    const SpectrogramHistory &getSpectrogram() const { return spectrogram; }
+
+    // Samples dropped because the analysis thread fell behind
+    juce::int64 getNumDroppedSamples() const { return numDroppedSamples.load(); }
+
+    static constexpr int minFFTOrder = 8;
+    static constexpr int maxFFTOrder = 14;
+    static constexpr int defaultFFTOrder = 10;
+
+    static constexpr int numDisplayBins = 200;
+    static constexpr float minDisplayFrequency = 20.0f;
+    static constexpr float maxDisplayFrequency = 20000.0f;
+
+    static constexpr int numGoniometerPoints = 512;
+
+    static constexpr int spectrogramColumnsPerSecond = 50;
+    static constexpr int spectrogramSeconds = 300;
+
+  private:
+    //==============================================================================
+    // One resolution of the multi-resolution spectrum
+    struct Stage {
+        int decimation = 1; // Relative to the input
+        int hopSize = 0;    // In this stage's samples
+        double binWidth = 0.0;
+        double maxFrequency = 0.0; // Highest frequency this stage is used for
+
+        // Anti-alias filter sections per channel, run before decimating from the previous stage
+        std::vector<std::vector<juce::dsp::IIR::Filter<float>>> antiAliasFilters;
+        int decimationPhase = 0;
+        juce::AudioBuffer<float> input; // This stage's decimated input
+
+        juce::AudioBuffer<float> history; // Last FFT size samples per channel, circular
+        int historyPosition = 0;
+        int samplesSinceFrame = 0;
+
+        std::vector<float> power; // Bin power of the latest frame, channel after channel
+    };
+
+    // FFT bins making up a display bin
+    struct DisplayBin {
+        int stage = 0;
+        int firstBin = 0, endBin = 0; // Peak over [firstBin, endBin) if not empty...
+        float position = 0.0f;        // ...otherwise interpolated at this bin position
+    };
+
+    const int maxChannels;
+    int numChannels = 0;
+    double sampleRate = 44100.0;
+
+    // Sample ring, audio thread -> analysis thread
+    juce::AbstractFifo ringFifo{1};
+    juce::AudioBuffer<float> ringBuffer;
+    std::atomic<juce::int64> numDroppedSamples{0};
+
+    // Settings as requested, and as used by the analysis thread
+    std::atomic<int> fftOrder{defaultFFTOrder};
+    std::atomic<int> hopSize{(1 << defaultFFTOrder) / 2};
+    std::atomic<RealFFT::Engine> fftEngine{RealFFT::getDefaultEngine()};
+    std::atomic<bool> levelResetPending{false};
+    std::atomic<bool> loudnessResetPending{false};
+    int activeFFTOrder = 0;
+    int activeHopSize = 0;
+    RealFFT::Engine activeFFTEngine = RealFFT::Engine::juce;
+
+    // Analysis thread state
+    std::unique_ptr<RealFFT> fft;
+    std::vector<float> window;
+    std::vector<float> fftData;
+    std::vector<Stage> stages;
+    std::vector<DisplayBin> displayBins;
+    std::vector<float> displayPower;
+    std::vector<float> frameSpectrum;
+    std::vector<float> hopPeaks, hopSumsOfSquares;
+    std::vector<const float *> channelPointers;
+    LoudnessMeter loudnessMeter;
+    float spectrumSmoothing = 0.8f;
+    float peakDecay = 0.95f;
+
+    // Stereo field: dot products of the current hop and their running average, goniometer points (circular)
+    SignalKernels::StereoSums hopStereoSums, stereoSums;
+    double correlationDecay = 0.9;
+    std::vector<float> goniometerPoints;
+    int goniometerPosition = 0;
+    int goniometerStride = 1;
+    int samplesUntilPoint = 0;
+
+    // Spectrogram: loudest value per bin since the last column
+    SpectrogramHistory spectrogram{numDisplayBins, spectrogramColumnsPerSecond * spectrogramSeconds, spectrumFloorDb};
+    std::vector<float> spectrogramColumn;
+    double samplesSinceColumn = 0.0;
+
+    // Published frame, allocated once so it never moves
+    AnalysisSnapshot published;
+    SeqLock publishLock;
+
+    // How long the thread sleeps when the ring is empty
+    static constexpr int pollIntervalMs = 5;
+    static constexpr double ringSeconds = 0.25;
+    static constexpr double spectrumSmoothingSeconds = 0.1;
+    static constexpr double peakDecaySeconds = 0.23;
+    static constexpr double correlationSeconds = 0.3;
+    static constexpr double goniometerSeconds = 0.05;
+    static constexpr float spectrumFloorDb = -100.0f;
+
+    static constexpr int numStages = 3;
+    static constexpr int stageDecimation = 4;
+    static constexpr double stagePassband = 0.8; // Of each stage's Nyquist frequency
+
+    void run() override;
+    void applySettings();
+    void createStages();
+    void createDisplayBins();
+    void readFromRing(int numReady);
+    void feedStage(size_t stageIndex, const float *const *channels, int numSamples);
+    int decimateInto(Stage &stage, const float *const *channels, int numSamples);
+    void measureLevels(const float *const *channels, int offset, int numSamples);
+    void measureStereoField(const float *const *channels, int offset, int numSamples);
+    void analyseStage(Stage &stage);
+    void publishFrame();
+    void addToSpectrogram();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioAnalyser)
+};
@@ -1,31 +1,62 @@
 #include "AudioInputManager.h"
+#include "JackAudioDevice.h"
+#include "SimulatedAudioDevice.h"
 
 //==============================================================================
 AudioInputManager::AudioInputManager() {
-    // Initialize input levels
-    for (auto &level : inputLevels)
-        level = 0.0f;
-
     // Don't initialize AudioDeviceManager here - do it lazily when needed
 }
 
-AudioInputManager::~AudioInputManager() { stop(); }
+AudioInputManager::~AudioInputManager() {
+    stop();
+    bridgedInputs.close();
+}
 
 //==============================================================================
+bool AudioInputManager::initialiseDevices() {
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    const juce::ScopedLock lock(initialisationLock);
+
+    if (isInitialized)
+        return true;
+
+    // Creates the platform's device types and scans each of them for devices. The simulated device
+    // goes last, so it's only the default on machines without any other.
+    audioDeviceManager.getAvailableDeviceTypes();
+#if AUDIOCHAIN_JACK
+    audioDeviceManager.addAudioDeviceType(std::make_unique<JackAudioDeviceType>());
+#endif
+    audioDeviceManager.addAudioDeviceType(std::make_unique<SimulatedAudioDeviceType>());
+
+    juce::String error = audioDeviceManager.initialiseWithDefaultDevices(2, 2);
+    if (error.isNotEmpty()) {
+        DBG("Failed to initialize AudioDeviceManager: " + error);
+        return false;
+    }
+
+#if AUDIOCHAIN_JACK
+    // A running JACK (or PipeWire-JACK) server beats opening the hardware directly: its period can be
+    // negotiated, and the chain's ports can be routed to other clients
+    for (auto *deviceType : audioDeviceManager.getAvailableDeviceTypes()) {
+        if (deviceType->getTypeName() == JackAudioDeviceType::typeName && !deviceType->getDeviceNames(false).isEmpty())
+            audioDeviceManager.setCurrentAudioDeviceType(JackAudioDeviceType::typeName, true);
+    }
+#endif
+
+    isInitialized = true;
+    return true;
+}
+
 juce::StringArray AudioInputManager::getAvailableInputDevices() {
     // Ensure AudioDeviceManager is initialized
-    if (!isInitialized) {
-        juce::String error = audioDeviceManager.initialiseWithDefaultDevices(2, 2);
-        if (error.isNotEmpty()) {
-            DBG("Failed to initialize AudioDeviceManager: " + error);
-            return juce::StringArray();
-        }
-        isInitialized = true;
+    if (!initialiseDevices()) {
+        return juce::StringArray();
     }
 
     juce::StringArray devices;
 
-    for (auto *deviceType : audioDeviceManager.getAvailableDeviceTypes()) {
+    for (auto *deviceType : getDeviceTypesInListOrder()) {
         if (deviceType != nullptr) {
             auto inputDevices = deviceType->getDeviceNames(true); // true for input devices
             for (const auto &device : inputDevices) {
@@ -47,18 +78,13 @@ juce::StringArray AudioInputManager::getAvailableInputDevices() {
 
 juce::StringArray AudioInputManager::getAvailableOutputDevices() {
     // Ensure AudioDeviceManager is initialized
-    if (!isInitialized) {
-        juce::String error = audioDeviceManager.initialiseWithDefaultDevices(2, 2);
-        if (error.isNotEmpty()) {
-            DBG("Failed to initialize AudioDeviceManager: " + error);
-            return juce::StringArray();
-        }
-        isInitialized = true;
+    if (!initialiseDevices()) {
+        return juce::StringArray();
     }
 
     juce::StringArray devices;
 
-    for (auto *deviceType : audioDeviceManager.getAvailableDeviceTypes()) {
+    for (auto *deviceType : getDeviceTypesInListOrder()) {
         if (deviceType != nullptr) {
             auto outputDevices = deviceType->getDeviceNames(false); // false for output devices
             for (const auto &device : outputDevices) {
@@ -78,156 +104,233 @@ juce::StringArray AudioInputManager::getAvailableOutputDevices() {
     return devices;
 }
 
+juce::Array<juce::AudioIODeviceType *> AudioInputManager::getDeviceTypesInListOrder() {
+    // The current type's devices first, so picking the first device in a list keeps it
+    juce::Array<juce::AudioIODeviceType *> deviceTypes;
+    for (auto *deviceType : audioDeviceManager.getAvailableDeviceTypes())
+        deviceTypes.add(deviceType);
+
+    if (auto *currentType = audioDeviceManager.getCurrentDeviceTypeObject())
+        deviceTypes.move(deviceTypes.indexOf(currentType), 0);
+
+    return deviceTypes;
+}
+
 bool AudioInputManager::setInputDevice(const juce::String &deviceName) {
     if (deviceName.isEmpty())
         return false;
 
+    return setInputDevices(juce::StringArray(deviceName));
+}
+
+bool AudioInputManager::setInputDevices(const juce::StringArray &deviceNames) {
+    if (deviceNames.isEmpty() || deviceNames.contains({}))
+        return false;
+
+    if (openDevices(deviceNames, currentOutputDeviceName, false)) {
+        DBG("Successfully set input device(s): " + deviceNames.joinIntoString(", "));
+        return true;
+    }
+
+    DBG("Failed to set input device(s): " + deviceNames.joinIntoString(", "));
+    return false;
+}
+
+juce::String AudioInputManager::getCurrentInputDevice() const { return currentInputDeviceNames.joinIntoString(" + "); }
+
+bool AudioInputManager::setOutputDevice(const juce::String &deviceName) {
+    if (deviceName.isEmpty())
+        return false;
+
+    if (openDevices(currentInputDeviceNames, deviceName, true)) {
+        DBG("Successfully set output device: " + deviceName);
+        return true;
+    }
+
+    DBG("Failed to set output device: " + deviceName);
+    return false;
+}
+
+juce::String AudioInputManager::getCurrentOutputDevice() const { return currentOutputDeviceName; }
+
+void AudioInputManager::setDriftCompensationEnabled(bool shouldCompensate) {
+    if (shouldCompensate == driftCompensationEnabled)
+        return;
+
+    driftCompensationEnabled = shouldCompensate;
+
+    if (isInitialized && !currentInputDeviceNames.isEmpty() && currentOutputDeviceName.isNotEmpty())
+        openDevices(currentInputDeviceNames, currentOutputDeviceName, true);
+}
+
+bool AudioInputManager::openDevices(const juce::StringArray &inputDeviceNames, const juce::String &outputDeviceName,
+                                    bool outputLeads) {
     // Stop current device if running
     bool wasRunning = isRunning;
     if (wasRunning)
         stop();
 
-    // First, try to determine the device's capabilities
-    int availableInputChannels = 1; // Default to mono
+    // Inputs on a clock of their own - another device than the output, or several devices - go through a drift
+    // bridge each. Otherwise the device manager opens input and output as one device.
+    auto inputNames = inputDeviceNames;
+    auto outputName = outputDeviceName;
+    auto shouldBridge = driftCompensationEnabled && outputName.isNotEmpty() &&
+                        (inputNames.size() > 1 || (inputNames.size() == 1 && inputNames[0] != outputName));
 
-    for (auto *deviceType : audioDeviceManager.getAvailableDeviceTypes()) {
-        if (deviceType != nullptr) {
-            auto device = deviceType->createDevice(deviceName, deviceName);
-            if (device != nullptr) {
-                availableInputChannels = device->getInputChannelNames().size();
-                DBG("Device '" + deviceName + "' has " + juce::String(availableInputChannels) + " input channels");
-                break;
-            }
+    bridgedInputs.close();
+
+    if (shouldBridge) {
+        // The device manager only opens the output; the inputs open through their own device types
+        selectDeviceType(outputName, false, {});
+
+        auto error = bridgedInputs.open(inputNames, currentSampleRate, currentBufferSize);
+        if (error.isNotEmpty()) {
+            DBG("Failed to open bridged inputs: " + error);
+            return false;
         }
+
+        // Reopened even if its setup didn't change, so the callback sees the new channel count
+        audioDeviceManager.closeAudioDevice();
+    } else if (outputLeads) {
+        // Devices of different types can't be combined - the input follows if it's of another type
+        auto inputName = selectDeviceType(outputName, false, inputNames[0]);
+        inputNames.clearQuick();
+        if (inputName.isNotEmpty())
+            inputNames.add(inputName);
+    } else {
+        // Devices of different types can't be combined - the output follows if it's of another type
+        outputName = selectDeviceType(inputNames[0], true, outputName);
+        inputNames = juce::StringArray(inputNames[0]);
     }
 
     // Configure audio device setup
     juce::AudioDeviceManager::AudioDeviceSetup setup;
     audioDeviceManager.getAudioDeviceSetup(setup);
 
-    setup.inputDeviceName = deviceName;
-    setup.outputDeviceName = currentOutputDeviceName; // Use current output device
-    setup.useDefaultInputChannels = false;            // We'll set channels manually
-    setup.useDefaultOutputChannels = false;           // We'll set output channels manually
-    setup.inputChannels.clear();
+    setup.inputDeviceName = shouldBridge ? juce::String() : inputNames[0];
+    setup.outputDeviceName = outputName;
+    setup.useDefaultInputChannels = false;  // We'll set channels manually
+    setup.useDefaultOutputChannels = false; // We'll set output channels manually
 
-    // Configure input channels based on what the device actually supports
-    if (availableInputChannels >= 2) {
-        // Stereo device - enable both channels
-        setup.inputChannels.setRange(0, 2, true);
-        DBG("Configuring for stereo input (2 channels)");
-    } else {
-        // Mono device - enable only the first channel
-        setup.inputChannels.setRange(0, 1, true);
-        DBG("Configuring for mono input (1 channel)");
-    }
+    // Every channel the devices actually support
+    setup.inputChannels.clear();
+    if (setup.inputDeviceName.isNotEmpty())
+        setup.inputChannels.setRange(0, getDeviceChannelCount(setup.inputDeviceName, true), true);
 
     setup.outputChannels.clear();
-    if (!currentOutputDeviceName.isEmpty()) {
-        setup.outputChannels.setRange(0, 2, true); // Enable first 2 output channels if output device is set
-    }
+    if (outputName.isNotEmpty())
+        setup.outputChannels.setRange(0, getDeviceChannelCount(outputName, false), true);
+
     setup.sampleRate = currentSampleRate;
     setup.bufferSize = currentBufferSize;
 
     DBG("Attempting to set audio device setup:");
-    DBG("  Input device: " + setup.inputDeviceName);
+    DBG("  Input device: " + (shouldBridge ? "bridged " + inputNames.joinIntoString(", ") : setup.inputDeviceName));
+    DBG("  Output device: " + setup.outputDeviceName);
     DBG("  Sample rate: " + juce::String(setup.sampleRate));
     DBG("  Buffer size: " + juce::String(setup.bufferSize));
     DBG("  Input channels: " + setup.inputChannels.toString(2));
+    DBG("  Output channels: " + setup.outputChannels.toString(2));
 
     juce::String error = audioDeviceManager.setAudioDeviceSetup(setup, true);
+    if (error.isNotEmpty()) {
+        DBG("Failed to set audio device setup: " + error);
+        bridgedInputs.close();
+        return false;
+    }
 
-    if (error.isEmpty()) {
-        currentInputDeviceName = deviceName;
-        isInitialized = true;
-
-        // Get the actual device that was opened
-        auto *currentDevice = audioDeviceManager.getCurrentAudioDevice();
-        if (currentDevice) {
-            DBG("Successfully set input device: " + deviceName);
-            DBG("Actual device opened: " + currentDevice->getName());
-            DBG("Device sample rate: " + juce::String(currentDevice->getCurrentSampleRate()));
-            DBG("Device buffer size: " + juce::String(currentDevice->getCurrentBufferSizeSamples()));
-            DBG("Device input channels: " + juce::String(currentDevice->getActiveInputChannels().toInteger()));
-            DBG("Device available input channels: " + juce::String(currentDevice->getInputChannelNames().size()));
-        } else {
-            DBG("WARNING: Device setup succeeded but no current device found!");
+    currentInputDeviceNames = inputNames;
+    currentOutputDeviceName = outputName;
+    isInitialized = true;
+
+    // Get the actual device that was opened
+    auto *currentDevice = audioDeviceManager.getCurrentAudioDevice();
+    if (currentDevice) {
+        DBG("Actual device opened: " + currentDevice->getName());
+        DBG("Device sample rate: " + juce::String(currentDevice->getCurrentSampleRate()));
+        DBG("Device buffer size: " + juce::String(currentDevice->getCurrentBufferSizeSamples()));
+        DBG("Device input channels: " + juce::String(getNumActiveInputChannels()));
+        DBG("Device output channels: " + juce::String(currentDevice->getActiveOutputChannels().toInteger()));
+
+        // The bridges were set up for the rate and block size asked for - the output may have opened with others
+        auto sampleRate = currentDevice->getCurrentSampleRate();
+        auto bufferSize = currentDevice->getCurrentBufferSizeSamples();
+        if (shouldBridge && (sampleRate != currentSampleRate || bufferSize != currentBufferSize)) {
+            error = bridgedInputs.open(inputNames, sampleRate, bufferSize);
+            if (error.isNotEmpty())
+                DBG("Failed to reopen bridged inputs: " + error);
         }
-
-        // Restart if it was running before
-        if (wasRunning)
-            start();
-
-        return true;
     } else {
-        DBG("Failed to set input device: " + error);
-        return false;
+        DBG("WARNING: Device setup succeeded but no current device found!");
     }
+
+    // Restart if it was running before
+    if (wasRunning)
+        start();
+
+    return true;
 }
 
-juce::String AudioInputManager::getCurrentInputDevice() const { return currentInputDeviceName; }
+int AudioInputManager::getNumActiveInputChannels() const {
+    if (bridgedInputs.isOpen())
+        return bridgedInputs.getNumChannels();
 
-bool AudioInputManager::setOutputDevice(const juce::String &deviceName) {
-    if (deviceName.isEmpty())
-        return false;
+    auto *device = audioDeviceManager.getCurrentAudioDevice();
+    return device != nullptr ? device->getActiveInputChannels().countNumberOfSetBits() : 0;
+}
 
-    // Stop current device if running
-    bool wasRunning = isRunning;
-    if (wasRunning)
-        stop();
+int AudioInputManager::getNumActiveOutputChannels() const {
+    auto *device = audioDeviceManager.getCurrentAudioDevice();
+    return device != nullptr ? device->getActiveOutputChannels().countNumberOfSetBits() : 0;
+}
 
-    // Configure audio device setup
-    juce::AudioDeviceManager::AudioDeviceSetup setup;
-    audioDeviceManager.getAudioDeviceSetup(setup);
+juce::String AudioInputManager::selectDeviceType(const juce::String &deviceName, bool isInput,
+                                                 const juce::String &otherDeviceName) {
+    for (auto *deviceType : audioDeviceManager.getAvailableDeviceTypes()) {
+        if (deviceType == nullptr || !deviceType->getDeviceNames(isInput).contains(deviceName))
+            continue;
 
-    setup.inputDeviceName = currentInputDeviceName; // Keep current input device
-    setup.outputDeviceName = deviceName;
-    setup.useDefaultInputChannels = false;
-    setup.useDefaultOutputChannels = false;
-    setup.inputChannels.clear();
-    if (!currentInputDeviceName.isEmpty()) {
-        setup.inputChannels.setRange(0, 2, true); // Enable input channels if input device is set
+        if (deviceType->getTypeName() != audioDeviceManager.getCurrentAudioDeviceType()) {
+            DBG("Switching to device type: " + deviceType->getTypeName());
+            audioDeviceManager.setCurrentAudioDeviceType(deviceType->getTypeName(), true);
+        }
+
+        // The other side's device if this type has it, otherwise the same device or the type's default
+        auto otherNames = deviceType->getDeviceNames(!isInput);
+        if (otherDeviceName.isEmpty() || otherNames.contains(otherDeviceName))
+            return otherDeviceName;
+
+        return otherNames.contains(deviceName) ? deviceName : otherNames[deviceType->getDefaultDeviceIndex(!isInput)];
     }
-    setup.outputChannels.clear();
-    setup.outputChannels.setRange(0, 2, true); // Enable first 2 output channels
-    setup.sampleRate = currentSampleRate;
-    setup.bufferSize = currentBufferSize;
 
-    DBG("Attempting to set output device setup:");
-    DBG("  Output device: " + setup.outputDeviceName);
-    DBG("  Input device: " + setup.inputDeviceName);
-    DBG("  Sample rate: " + juce::String(setup.sampleRate));
-    DBG("  Buffer size: " + juce::String(setup.bufferSize));
-    DBG("  Output channels: " + setup.outputChannels.toString(2));
+    return otherDeviceName;
+}
 
-    juce::String error = audioDeviceManager.setAudioDeviceSetup(setup, true);
+int AudioInputManager::getDeviceChannelCount(const juce::String &deviceName, bool isInput) {
+    auto key = (isInput ? "in:" : "out:") + deviceName;
+    auto cached = deviceChannelCounts.find(key);
+    if (cached != deviceChannelCounts.end())
+        return cached->second;
 
-    if (error.isEmpty()) {
-        currentOutputDeviceName = deviceName;
-        isInitialized = true;
-
-        // Get the actual device that was opened
-        auto *currentDevice = audioDeviceManager.getCurrentAudioDevice();
-        if (currentDevice) {
-            DBG("Successfully set output device: " + deviceName);
-            DBG("Actual device opened: " + currentDevice->getName());
-            DBG("Device output channels: " + juce::String(currentDevice->getActiveOutputChannels().toInteger()));
-        } else {
-            DBG("WARNING: Output device setup succeeded but no current device found!");
-        }
+    // Default to mono if the device can't be opened
+    auto numChannels = 1;
 
-        // Restart if it was running before
-        if (wasRunning)
-            start();
+    for (auto *deviceType : audioDeviceManager.getAvailableDeviceTypes()) {
+        if (deviceType != nullptr && deviceType->getDeviceNames(isInput).contains(deviceName)) {
+            std::unique_ptr<juce::AudioIODevice> device(
+                deviceType->createDevice(isInput ? juce::String() : deviceName, isInput ? deviceName : juce::String()));
 
-        return true;
-    } else {
-        DBG("Failed to set output device: " + error);
-        return false;
+            if (device != nullptr) {
+                auto names = isInput ? device->getInputChannelNames() : device->getOutputChannelNames();
+                numChannels = juce::jlimit(1, maxChannels, names.size());
+                break;
+            }
+        }
     }
-}
 
-juce::String AudioInputManager::getCurrentOutputDevice() const { return currentOutputDeviceName; }
+    deviceChannelCounts[key] = numChannels;
+    return numChannels;
+}
 
 //==============================================================================
 bool AudioInputManager::start() {
@@ -243,7 +346,7 @@ bool AudioInputManager::start() {
     // We just need to mark ourselves as running
     isRunning = true;
 
-    DBG("AudioInputManager started with device: " + currentInputDeviceName);
+    DBG("AudioInputManager started with device: " + getCurrentInputDevice());
     return true;
 }
 
@@ -258,23 +361,24 @@ void AudioInputManager::stop() {
 
 //==============================================================================
 void AudioInputManager::setSampleRate(double sampleRate) {
-    if (sampleRate > 0) {
+    // Unchanged when the device reports the rate it opened with - reopening would restart the bridges for nothing
+    if (sampleRate > 0 && sampleRate != currentSampleRate) {
         currentSampleRate = sampleRate;
 
         // Update device if it's already set
-        if (isInitialized && !currentInputDeviceName.isEmpty()) {
-            setInputDevice(currentInputDeviceName);
+        if (isInitialized && !currentInputDeviceNames.isEmpty()) {
+            setInputDevices(currentInputDeviceNames);
         }
     }
 }
 
 void AudioInputManager::setBufferSize(int bufferSize) {
-    if (bufferSize > 0) {
+    if (bufferSize > 0 && bufferSize != currentBufferSize) {
         currentBufferSize = bufferSize;
 
         // Update device if it's already set
-        if (isInitialized && !currentInputDeviceName.isEmpty()) {
-            setInputDevice(currentInputDeviceName);
+        if (isInitialized && !currentInputDeviceNames.isEmpty()) {
+            setInputDevices(currentInputDeviceNames);
         }
     }
 }
@@ -284,55 +388,10 @@ juce::String AudioInputManager::getStatusString() const {
     if (!isRunning)
         return "Stopped";
 
-    if (!isInitialized || currentInputDeviceName.isEmpty())
+    if (!isInitialized || currentInputDeviceNames.isEmpty())
         return "No input device selected";
 
-    return "Recording from: " + currentInputDeviceName;
+    return "Recording from: " + getCurrentInputDevice() + (isInputBridged() ? " (bridged)" : "");
 }
 
-bool AudioInputManager::hasValidInputDevice() const { return isInitialized && !currentInputDeviceName.isEmpty(); }
-
-//==============================================================================
-float AudioInputManager::getInputLevel(int channel) const {
-    if (channel >= 0 && channel < numChannels)
-        return inputLevels[channel].load();
-
-    return 0.0f;
-}
-
-bool AudioInputManager::hasInputSignal() const {
-    const float threshold = 0.001f; // -60dB roughly
-
-    for (int i = 0; i < numChannels; ++i) {
-        if (inputLevels[i].load() > threshold)
-            return true;
-    }
-
-    return false;
-}
-
-//==============================================================================
-void AudioInputManager::updateInputLevels(const float *const *inputChannelData, int numInputChannels, int numSamples) {
-    for (int channel = 0; channel < juce::jmin(numInputChannels, numChannels); ++channel) {
-        if (inputChannelData[channel]) {
-            float peak = 0.0f;
-
-            for (int sample = 0; sample < numSamples; ++sample) {
-                float sampleValue = std::abs(inputChannelData[channel][sample]);
-                peak = juce::jmax(peak, sampleValue);
-            }
-
-            // Simple peak hold with decay
-            float currentLevel = inputLevels[channel].load();
-            float newLevel = juce::jmax(peak, currentLevel * 0.98f); // Slow decay
-
-            inputLevels[channel] = newLevel;
-        }
-    }
-
-    // Handle mono input: duplicate the mono signal to both channels for level display
-    if (numInputChannels == 1 && inputChannelData[0]) {
-        float monoLevel = inputLevels[0].load();
-        inputLevels[1] = monoLevel; // Duplicate left channel level to right channel
-    }
-}
\ No newline at end of file
+bool AudioInputManager::hasValidInputDevice() const { return isInitialized && !currentInputDeviceNames.isEmpty(); }
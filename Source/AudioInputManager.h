@@ -1,9 +1,12 @@
 #pragma once
 
+#include "BoundaryTelemetry.h"
+#include "BridgedInputs.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
+#include <map>
 
 //==============================================================================
 /**
@@ -12,20 +15,56 @@
 
     This replaces the complex VirtualAudioDriver approach with a simpler
     user-selectable input device approach.
+
+    Every channel a device offers is opened (up to maxChannels). Channel counts
+    are looked up once per device and cached, as that means opening it.
+
+    The lists include a simulated device (see SimulatedAudioDevice), for
+    machines without a sound card. On Linux builds with JACK, they include the
+    JACK server while one is running (see JackAudioDevice), and it's the
+    default device then.
+
+    An input on other hardware than the output runs on its own clock, and so
+    do several inputs aggregated into one chain. With drift compensation on
+    (the default), such inputs are opened next to the output device and
+    bridged into its clock domain (see BridgedInputs), instead of being opened
+    together with it.
 */
 class AudioInputManager {
   public:
+    // Widest device layout that is opened
+    static constexpr int maxChannels = BoundaryTelemetry::maxChannels;
+
     AudioInputManager();
     ~AudioInputManager();
 
+    // Creates and scans the device types and opens the default devices. Message thread only: some
+    // platform device types listen for hot-plugging through the thread that creates them.
+    bool initialiseDevices();
+
     // Device selection
     juce::StringArray getAvailableInputDevices();
     juce::StringArray getAvailableOutputDevices();
     bool setInputDevice(const juce::String &deviceName);
     bool setOutputDevice(const juce::String &deviceName);
-    juce::String getCurrentInputDevice() const;
+    juce::String getCurrentInputDevice() const; // Several devices joined with " + "
     juce::String getCurrentOutputDevice() const;
 
+    // Aggregates several input devices into one chain: the first device's channels, then the second's, ...
+    bool setInputDevices(const juce::StringArray &deviceNames);
+    juce::StringArray getCurrentInputDevices() const { return currentInputDeviceNames; }
+
+    // Drift compensation for inputs on another clock than the output. Without it, only one input device can
+    // be used, opened together with the output.
+    void setDriftCompensationEnabled(bool shouldCompensate);
+    bool isDriftCompensationEnabled() const { return driftCompensationEnabled; }
+    bool isInputBridged() const { return bridgedInputs.isOpen(); }
+    BridgedInputs &getBridgedInputs() { return bridgedInputs; }
+
+    // Channels open on the current device
+    int getNumActiveInputChannels() const;
+    int getNumActiveOutputChannels() const;
+
     // Audio device management
     bool start();
     void stop();
@@ -41,32 +80,47 @@ class AudioInputManager {
     juce::String getStatusString() const;
     bool hasValidInputDevice() const;
 
-    // Audio level monitoring
-    float getInputLevel(int channel) const;
-    bool hasInputSignal() const;
-
     // Audio device manager access (for MainComponent to use)
     juce::AudioDeviceManager &getAudioDeviceManager() { return audioDeviceManager; }
 
-    // Audio level updating (called by MainComponent)
-    void updateInputLevels(const float *const *inputChannelData, int numInputChannels, int numSamples);
+    // What the devices deliver and receive - measured by the audio callback, read by meters and diagnostics
+    BoundaryTelemetry &getInputTelemetry() { return inputTelemetry; }
+    BoundaryTelemetry &getOutputTelemetry() { return outputTelemetry; }
 
   private:
     juce::AudioDeviceManager audioDeviceManager;
 
     // Current settings
-    juce::String currentInputDeviceName;
+    juce::StringArray currentInputDeviceNames;
     juce::String currentOutputDeviceName;
+    bool driftCompensationEnabled = true;
     double currentSampleRate = 44100.0;
     int currentBufferSize = 512;
 
     // Status
     std::atomic<bool> isRunning{false};
-    bool isInitialized = false;
+    std::atomic<bool> isInitialized{false};
+    juce::CriticalSection initialisationLock;
+
+    // Channel counts per device, "in:" or "out:" followed by the device name
+    std::map<juce::String, int> deviceChannelCounts;
+
+    BoundaryTelemetry inputTelemetry, outputTelemetry;
+
+    BridgedInputs bridgedInputs{audioDeviceManager};
+
+    // Opens the devices for a selection. outputLeads picks which side keeps its device type when they're opened
+    // together and the other side's device is of another type.
+    bool openDevices(const juce::StringArray &inputDeviceNames, const juce::String &outputDeviceName,
+                     bool outputLeads);
+
+    int getDeviceChannelCount(const juce::String &deviceName, bool isInput);
+
+    juce::Array<juce::AudioIODeviceType *> getDeviceTypesInListOrder();
 
-    // Input level monitoring
-    static constexpr int numChannels = 2;
-    std::array<std::atomic<float>, numChannels> inputLevels;
+    // Makes the device type listing the device the current one. Returns the device to use for the other
+    // direction: otherDeviceName if that type has it, a device of that type otherwise.
+    juce::String selectDeviceType(const juce::String &deviceName, bool isInput, const juce::String &otherDeviceName);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioInputManager)
 };
\ No newline at end of file
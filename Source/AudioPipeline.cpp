@@ -0,0 +1,137 @@
+#include "AudioPipeline.h"
+#include "StartupProfiler.h"
+
+//==============================================================================
+AudioPipeline::AudioPipeline(PluginHost &host, AudioProcessor &processor, BoundaryTelemetry &input,
+                             BoundaryTelemetry &output)
+    : pluginHost(host), audioProcessor(processor), inputTelemetry(input), outputTelemetry(output) {}
+
+void AudioPipeline::audioDeviceIOCallbackWithContext(const float *const *inputChannelData, int numInputChannels,
+                                                     float *const *outputChannelData, int numOutputChannels,
+                                                     int numSamples, const juce::AudioIODeviceCallbackContext &) {
+    StartupProfiler::getInstance().addMilestone(StartupProfiler::RealtimeMilestone::firstAudioCallback);
+
+    // Flush denormals to zero (FTZ/DAZ) for everything the callback runs, plugins included
+    juce::ScopedNoDenormals noDenormals;
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    process(inputChannelData, numInputChannels, outputChannelData, numOutputChannels, numSamples);
+    auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    auto load = elapsedSeconds * sampleRate / juce::jmax(1, numSamples);
+    numCallbacks.store(numCallbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    numSamplesProcessed.store(numSamplesProcessed.load(std::memory_order_relaxed) + numSamples,
+                              std::memory_order_relaxed);
+    totalLoad.store(totalLoad.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+    if (load > maxLoad.load(std::memory_order_relaxed))
+        maxLoad.store(load, std::memory_order_relaxed);
+    if (load > 1.0)
+        numOverruns.store(numOverruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void AudioPipeline::process(const float *const *inputChannelData, int numInputChannels,
+                            float *const *outputChannelData, int numOutputChannels, int numSamples) {
+    // Clear output buffers first
+    for (int channel = 0; channel < numOutputChannels; ++channel) {
+        if (outputChannelData[channel])
+            juce::FloatVectorOperations::clear(outputChannelData[channel], numSamples);
+    }
+
+    // Bridged inputs replace the device's. The device manager holds its callback lock, so they can't change
+    // during the callback.
+    if (bridgedInputs != nullptr && bridgedInputs->isOpen()) {
+        numInputChannels = juce::jmin(bridgedInputs->getNumChannels(), bridgedInputBuffer.getNumChannels());
+        bridgedInputBuffer.setSize(bridgedInputBuffer.getNumChannels(), numSamples, false, false, true);
+        bridgedInputs->pull(bridgedInputBuffer.getArrayOfWritePointers(), numInputChannels, numSamples);
+        inputChannelData = bridgedInputBuffer.getArrayOfReadPointers();
+    }
+
+    // One pass over what comes in, one over what goes out - the meters and diagnostics read the results
+    if (inputChannelData != nullptr)
+        inputTelemetry.measure(inputChannelData, numInputChannels, numSamples);
+
+    if (inputChannelData != nullptr && numInputChannels > 0) {
+        // Use the buffer allocated when the device started - at least 2 channels for stereo processing.
+        // Only reallocates if the device delivers more channels than it said it would.
+        int processingChannels = juce::jmax(juce::jmax(numInputChannels, numOutputChannels), 2);
+        processingBuffer.setSize(processingChannels, numSamples, false, false, true);
+
+        // Copy input to processing buffer, silence in the channels without input
+        for (int channel = 0; channel < processingChannels; ++channel) {
+            if (channel < numInputChannels && inputChannelData[channel]) {
+                processingBuffer.copyFrom(channel, 0, inputChannelData[channel], numSamples);
+            } else {
+                processingBuffer.clear(channel, 0, numSamples);
+            }
+        }
+
+        // Handle mono-to-stereo conversion: if we only have 1 input channel, duplicate it to channel 1
+        if (numInputChannels == 1 && processingBuffer.getNumChannels() >= 2) {
+            if (inputChannelData[0])
+                processingBuffer.copyFrom(1, 0, inputChannelData[0], numSamples);
+        }
+
+        // Process through VST plugins, then our audio processor
+        pluginHost.processAudio(processingBuffer);
+        audioProcessor.processAudio(processingBuffer);
+
+        // Copy processed audio to output
+        for (int channel = 0; channel < numOutputChannels && channel < processingBuffer.getNumChannels(); ++channel) {
+            if (outputChannelData[channel]) {
+                juce::FloatVectorOperations::copy(outputChannelData[channel], processingBuffer.getReadPointer(channel),
+                                                  numSamples);
+            }
+        }
+    }
+
+    outputTelemetry.measure(outputChannelData, numOutputChannels, numSamples);
+}
+
+//==============================================================================
+void AudioPipeline::audioDeviceAboutToStart(juce::AudioIODevice *device) {
+    DBG("Audio device about to start: " + device->getName());
+
+    sampleRate = device->getCurrentSampleRate();
+    int bufferSize = device->getCurrentBufferSizeSamples();
+
+    // The chain is as wide as the device's open inputs (or the bridged ones) or outputs, whichever has more
+    auto numBridgedChannels = bridgedInputs != nullptr ? bridgedInputs->getNumChannels() : 0;
+    int numChannels = juce::jmax(device->getActiveInputChannels().countNumberOfSetBits(), numBridgedChannels,
+                                 device->getActiveOutputChannels().countNumberOfSetBits(), 2);
+    processingBuffer.setSize(numChannels, bufferSize);
+
+    if (bridgedInputs != nullptr)
+        bridgedInputBuffer.setSize(BridgedInputs::maxChannels, bufferSize);
+
+    audioProcessor.prepareToPlay(bufferSize, sampleRate, numChannels);
+    pluginHost.prepareToPlay(bufferSize, sampleRate, numChannels);
+
+    numCallbacks = 0;
+    numSamplesProcessed = 0;
+    totalLoad = 0.0;
+    maxLoad = 0.0;
+    numOverruns = 0;
+
+    if (onDeviceStarted)
+        onDeviceStarted(sampleRate, bufferSize);
+
+    DBG("Audio prepared - Sample rate: " + juce::String(sampleRate) + ", Buffer size: " + juce::String(bufferSize) +
+        ", Channels: " + juce::String(numChannels));
+}
+
+void AudioPipeline::audioDeviceStopped() {
+    DBG("Audio device stopped");
+
+    audioProcessor.releaseResources();
+    pluginHost.releaseResources();
+}
+
+AudioPipeline::Statistics AudioPipeline::getStatistics() const {
+    Statistics statistics;
+    statistics.numCallbacks = numCallbacks.load();
+    statistics.numSamples = numSamplesProcessed.load();
+    statistics.meanLoad = statistics.numCallbacks > 0 ? totalLoad.load() / (double)statistics.numCallbacks : 0.0;
+    statistics.maxLoad = maxLoad.load();
+    statistics.numOverruns = numOverruns.load();
+    return statistics;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "AudioProcessor.h"
+#include "BoundaryTelemetry.h"
+#include "BridgedInputs.h"
+#include "PluginHost.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <functional>
+
+//==============================================================================
+/**
+    The device callback: device input -> plugin chain -> audio processor ->
+    device output, with the boundary telemetry measured on the way in and out.
+
+    Doesn't care which device drives it, so the main window runs it on the
+    selected device and the headless pipeline benchmark on a simulated one.
+    With bridged inputs, the chain's input comes from them rather than from
+    the device.
+
+    It also times itself: each callback's duration as a share of the block's
+    duration (its load), and how many callbacks overran their block.
+*/
+class AudioPipeline : public juce::AudioIODeviceCallback {
+  public:
+    //==============================================================================
+    AudioPipeline(PluginHost &pluginHost, AudioProcessor &audioProcessor, BoundaryTelemetry &inputTelemetry,
+                  BoundaryTelemetry &outputTelemetry);
+
+    void audioDeviceIOCallbackWithContext(const float *const *inputChannelData, int numInputChannels,
+                                          float *const *outputChannelData, int numOutputChannels, int numSamples,
+                                          const juce::AudioIODeviceCallbackContext &context) override;
+
+    void audioDeviceAboutToStart(juce::AudioIODevice *device) override;
+    void audioDeviceStopped() override;
+
+    //==============================================================================
+    struct Statistics {
+        juce::int64 numCallbacks = 0;
+        juce::int64 numSamples = 0; // Per channel
+        double meanLoad = 0.0;      // Callback duration / block duration
+        double maxLoad = 0.0;
+        juce::int64 numOverruns = 0; // Callbacks that took longer than their block lasts
+    };
+
+    // Since the device last started. Any thread; the values may be from different callbacks.
+    Statistics getStatistics() const;
+
+    // Called from audioDeviceAboutToStart, after the chain is prepared
+    std::function<void(double sampleRate, int blockSize)> onDeviceStarted;
+
+    // Input devices on other clocks than the one driving the pipeline. Set before the pipeline is registered
+    // with a device; used whenever they're open.
+    void setBridgedInputs(BridgedInputs *inputs) { bridgedInputs = inputs; }
+
+  private:
+    //==============================================================================
+    PluginHost &pluginHost;
+    AudioProcessor &audioProcessor;
+    BoundaryTelemetry &inputTelemetry;
+    BoundaryTelemetry &outputTelemetry;
+
+    BridgedInputs *bridgedInputs = nullptr;
+
+    // Chain buffer, sized in audioDeviceAboutToStart for the device's channels (at least stereo)
+    juce::AudioBuffer<float> processingBuffer;
+
+    // What the bridged inputs deliver, room for all of them
+    juce::AudioBuffer<float> bridgedInputBuffer;
+    double sampleRate = 44100.0;
+
+    // Written by the audio thread only
+    std::atomic<juce::int64> numCallbacks{0};
+    std::atomic<juce::int64> numSamplesProcessed{0};
+    std::atomic<double> totalLoad{0.0};
+    std::atomic<double> maxLoad{0.0};
+    std::atomic<juce::int64> numOverruns{0};
+
+    void process(const float *const *inputChannelData, int numInputChannels, float *const *outputChannelData,
+                 int numOutputChannels, int numSamples);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPipeline)
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AudioAnalyser.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_audio_processors/juce_audio_processors.h>
@@ -26,8 +27,8 @@ class AudioProcessor {
     AudioProcessor();
     ~AudioProcessor();
 
-    // Audio processing
-    void prepareToPlay(int samplesPerBlock, double sampleRate);
+    // Audio processing - numChannels is the channel count the device negotiated
+    void prepareToPlay(int samplesPerBlock, double sampleRate, int numChannels);
     void processAudio(juce::AudioBuffer<float> &buffer);
     void releaseResources();
 
@@ -43,14 +44,18 @@ class AudioProcessor {
     void setEnabled(bool enabled);
     bool isEnabled() const { return processingEnabled; }
 
-    // Metering
-    float getPeakLevel(int channel) const;
-    float getRMSLevel(int channel) const;
-    void resetMeters();
+    // Metering and analysis - computed on the analyser's thread, so the audio thread only copies samples.
+    // Returns true if the snapshot was updated with a newer frame.
+    bool getAnalysisSnapshot(AnalysisSnapshot &snapshot) const { return analyser.getSnapshot(snapshot); }
+    void resetMeters() { analyser.resetLevels(); }
+    void resetLoudness() { analyser.resetLoudness(); }
+
+    // Spectrogram columns, for one view at a time
+    const SpectrogramHistory &getSpectrogram() const { return analyser.getSpectrogram(); }
 
-    // Analysis
-    const float *getSpectrumData(int channel) const;
-    int getSpectrumSize() const { return fftSize / 2; }
+    void setSpectrumFFTOrder(int order) { analyser.setFFTOrder(order); }
+    void setSpectrumHopSize(int samples) { analyser.setHopSize(samples); }
+    void setSpectrumFFTEngine(RealFFT::Engine engine) { analyser.setFFTEngine(engine); }
 
   private:
     // Audio parameters
@@ -61,32 +66,17 @@ class AudioProcessor {
     // Audio processing
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
+    int currentNumChannels = 2;
     bool isPrepared = false;
 
-    // Metering
-    static constexpr int numChannels = 2;
-    std::array<std::atomic<float>, numChannels> peakLevels;
-    std::array<std::atomic<float>, numChannels> rmsLevels;
-
     juce::LinearSmoothedValue<float> gainSmoothed;
 
-    // FFT Analysis
-    static constexpr int fftOrder = 10;
-    static constexpr int fftSize = 1 << fftOrder;
-
-    std::array<juce::dsp::FFT, numChannels> fftObjects;
-    std::array<juce::dsp::WindowingFunction<float>, numChannels> windowing;
-    std::array<std::array<float, fftSize * 2>, numChannels> fftData;
-    std::array<std::array<float, fftSize / 2>, numChannels> spectrumData;
-    std::array<int, numChannels> fftIndex;
+    // Metering and spectrum analysis, of up to maxAnalysedChannels channels
+    static constexpr int maxAnalysedChannels = 64;
+    AudioAnalyser analyser{maxAnalysedChannels};
 
     // Thread safety
     juce::CriticalSection processingLock;
 
-    // Helper methods
-    void updateMeters(const juce::AudioBuffer<float> &buffer);
-    void updateSpectrum(const juce::AudioBuffer<float> &buffer);
-    void processFFT(int channel);
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioProcessor)
 };
\ No newline at end of file
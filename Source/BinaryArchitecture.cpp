@@ -0,0 +1,266 @@
+#include "BinaryArchitecture.h"
+
+namespace {
+// Bounds-checked reads from a mapped header. Returns 0 when out of range.
+juce::uint16 readUint16(const juce::uint8 *data, size_t size, size_t offset, bool bigEndian) {
+    if (offset + 2 > size)
+        return 0;
+    return bigEndian ? juce::ByteOrder::bigEndianShort(data + offset) : juce::ByteOrder::littleEndianShort(data + offset);
+}
+
+juce::uint32 readUint32(const juce::uint8 *data, size_t size, size_t offset, bool bigEndian) {
+    if (offset + 4 > size)
+        return 0;
+    return bigEndian ? juce::ByteOrder::bigEndianInt(data + offset) : juce::ByteOrder::littleEndianInt(data + offset);
+}
+
+BinaryArchitecture::Cpu machOCpu(juce::uint32 cpuType) {
+    constexpr juce::uint32 abi64 = 0x01000000;
+
+    switch (cpuType) {
+    case 7:
+        return BinaryArchitecture::Cpu::x86;
+    case 7 | abi64:
+        return BinaryArchitecture::Cpu::x64;
+    case 12:
+        return BinaryArchitecture::Cpu::arm;
+    case 12 | abi64:
+        return BinaryArchitecture::Cpu::arm64;
+    case 18:
+        return BinaryArchitecture::Cpu::ppc;
+    case 18 | abi64:
+        return BinaryArchitecture::Cpu::ppc64;
+    default:
+        return BinaryArchitecture::Cpu::unknown;
+    }
+}
+} // namespace
+
+//==============================================================================
+juce::String BinaryArchitecture::Info::toString() const {
+    if (cpus.isEmpty())
+        return "Unknown";
+
+    juce::StringArray names;
+    for (auto cpu : cpus)
+        names.addIfNotAlreadyThere(getCpuName(cpu));
+
+    return names.joinIntoString("+");
+}
+
+//==============================================================================
+BinaryArchitecture::BinaryArchitecture() = default;
+
+BinaryArchitecture::~BinaryArchitecture() = default;
+
+BinaryArchitecture::Info BinaryArchitecture::getArchitecture(const juce::File &binaryFile) const {
+    auto identity = PluginScanCache::getFileIdentity(binaryFile);
+
+    {
+        juce::ScopedLock lock(cacheLock);
+        auto it = cache.find(binaryFile.getFullPathName());
+        if (it != cache.end() && it->second.identity == identity)
+            return it->second.info;
+    }
+
+    auto info = probe(binaryFile);
+
+    juce::ScopedLock lock(cacheLock);
+    cache[binaryFile.getFullPathName()] = {identity, info};
+    return info;
+}
+
+void BinaryArchitecture::clearCache() {
+    juce::ScopedLock lock(cacheLock);
+    cache.clear();
+}
+
+//==============================================================================
+BinaryArchitecture::Info BinaryArchitecture::probe(const juce::File &binaryFile) {
+    if (!binaryFile.existsAsFile())
+        return {};
+
+    // Mapping is lazy - only the pages holding the headers are actually read
+    juce::MemoryMappedFile mappedFile(binaryFile, juce::MemoryMappedFile::readOnly);
+    auto *data = static_cast<const juce::uint8 *>(mappedFile.getData());
+    auto size = mappedFile.getSize();
+
+    if (data == nullptr || size < 4) {
+        DBG("    Could not map binary for architecture probe: " + binaryFile.getFullPathName());
+        return {};
+    }
+
+    if (data[0] == 0x7f && data[1] == 'E' && data[2] == 'L' && data[3] == 'F')
+        return parseELF(data, size);
+
+    if (data[0] == 'M' && data[1] == 'Z')
+        return parsePE(data, size);
+
+    return parseMachO(data, size);
+}
+
+BinaryArchitecture::Info BinaryArchitecture::parseELF(const juce::uint8 *data, size_t size) {
+    Info info;
+    info.binaryFormat = "ELF";
+
+    if (size < 20)
+        return info;
+
+    auto is64Bit = data[4] == 2;   // EI_CLASS: ELFCLASS64
+    auto bigEndian = data[5] == 2; // EI_DATA: ELFDATA2MSB
+
+    // e_machine
+    switch (readUint16(data, size, 18, bigEndian)) {
+    case 3: // EM_386
+        info.cpus.add(Cpu::x86);
+        break;
+    case 62: // EM_X86_64
+        info.cpus.add(is64Bit ? Cpu::x64 : Cpu::unknown); // x32 ABI can't be loaded by either host
+        break;
+    case 40: // EM_ARM
+        info.cpus.add(Cpu::arm);
+        break;
+    case 183: // EM_AARCH64
+        info.cpus.add(Cpu::arm64);
+        break;
+    case 20: // EM_PPC
+        info.cpus.add(Cpu::ppc);
+        break;
+    case 21: // EM_PPC64
+        info.cpus.add(Cpu::ppc64);
+        break;
+    default:
+        info.cpus.add(Cpu::unknown);
+        break;
+    }
+
+    return info;
+}
+
+BinaryArchitecture::Info BinaryArchitecture::parseMachO(const juce::uint8 *data, size_t size) {
+    Info info;
+
+    auto magic = readUint32(data, size, 0, true);
+
+    // Fat (universal) binary: big-endian header followed by one entry per slice.
+    // Java class files share the 32-bit magic, but never have a small slice count.
+    if (magic == 0xcafebabe || magic == 0xcafebabf) {
+        auto numSlices = readUint32(data, size, 4, true);
+        if (numSlices == 0 || numSlices > 32)
+            return info;
+
+        info.binaryFormat = "Mach-O";
+        auto entrySize = (size_t)(magic == 0xcafebabf ? 32 : 20); // fat_arch_64 / fat_arch
+
+        for (juce::uint32 i = 0; i < numSlices; ++i)
+            info.cpus.add(machOCpu(readUint32(data, size, 8 + i * entrySize, true)));
+
+        return info;
+    }
+
+    // Thin binary: the magic tells the byte order of the rest of the header
+    magic = readUint32(data, size, 0, false);
+    if (magic == 0xfeedface || magic == 0xfeedfacf || magic == 0xcefaedfe || magic == 0xcffaedfe) {
+        auto bigEndian = magic == 0xcefaedfe || magic == 0xcffaedfe;
+
+        info.binaryFormat = "Mach-O";
+        info.cpus.add(machOCpu(readUint32(data, size, 4, bigEndian)));
+    }
+
+    return info;
+}
+
+BinaryArchitecture::Info BinaryArchitecture::parsePE(const juce::uint8 *data, size_t size) {
+    Info info;
+
+    // e_lfanew points at the PE signature, followed by the COFF machine type
+    auto peOffset = (size_t)readUint32(data, size, 0x3c, false);
+    if (peOffset + 6 > size || memcmp(data + peOffset, "PE\0\0", 4) != 0)
+        return info;
+
+    info.binaryFormat = "PE";
+
+    switch (readUint16(data, size, peOffset + 4, false)) {
+    case 0x8664: // IMAGE_FILE_MACHINE_AMD64
+        info.cpus.add(Cpu::x64);
+        break;
+    case 0x014c: // IMAGE_FILE_MACHINE_I386
+        info.cpus.add(Cpu::x86);
+        break;
+    case 0xaa64: // IMAGE_FILE_MACHINE_ARM64
+        info.cpus.add(Cpu::arm64);
+        break;
+    case 0x01c0: // IMAGE_FILE_MACHINE_ARM
+    case 0x01c4: // IMAGE_FILE_MACHINE_ARMNT
+        info.cpus.add(Cpu::arm);
+        break;
+    default:
+        info.cpus.add(Cpu::unknown);
+        break;
+    }
+
+    return info;
+}
+
+//==============================================================================
+BinaryArchitecture::Cpu BinaryArchitecture::getHostCpu() {
+#if JUCE_INTEL && JUCE_64BIT
+    return Cpu::x64;
+#elif JUCE_INTEL
+    return Cpu::x86;
+#elif JUCE_ARM && JUCE_64BIT
+    return Cpu::arm64;
+#elif JUCE_ARM
+    return Cpu::arm;
+#elif JUCE_PPC && JUCE_64BIT
+    return Cpu::ppc64;
+#elif JUCE_PPC
+    return Cpu::ppc;
+#else
+    return Cpu::unknown;
+#endif
+}
+
+juce::String BinaryArchitecture::getCpuName(Cpu cpu) {
+    switch (cpu) {
+    case Cpu::x86:
+        return "x86";
+    case Cpu::x64:
+        return "x64";
+    case Cpu::arm:
+        return "ARM";
+    case Cpu::arm64:
+        return "ARM64";
+    case Cpu::ppc:
+        return "PPC";
+    case Cpu::ppc64:
+        return "PPC64";
+    case Cpu::unknown:
+    default:
+        return "Unsupported";
+    }
+}
+
+juce::String BinaryArchitecture::getVST3BundleFolder(Cpu cpu) {
+#if JUCE_WINDOWS
+    const juce::String platform("-win");
+#else
+    const juce::String platform("-linux");
+#endif
+
+    switch (cpu) {
+    case Cpu::x86:
+        return (platform == "-win" ? "x86" : "i386") + platform;
+    case Cpu::x64:
+        return "x86_64" + platform;
+    case Cpu::arm:
+        return (platform == "-win" ? "arm" : "armv7l") + platform;
+    case Cpu::arm64:
+        return (platform == "-win" ? "arm64" : "aarch64") + platform;
+    case Cpu::ppc:
+    case Cpu::ppc64:
+    case Cpu::unknown:
+    default:
+        return {};
+    }
+}
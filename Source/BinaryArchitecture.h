@@ -0,0 +1,68 @@
+#pragma once
+
+#include "PluginScanCache.h"
+#include <juce_core/juce_core.h>
+#include <map>
+
+//==============================================================================
+/**
+    Detects the CPU architectures of a plugin binary from its file header,
+    without loading it.
+
+    - ELF (Linux): e_machine and class
+    - Mach-O (macOS): thin binaries and every slice of fat/universal binaries
+    - PE (Windows): COFF machine type
+
+    Binaries are memory mapped and only the header pages are touched. Results are
+    cached per file and reused until the file's modification time or size changes.
+*/
+class BinaryArchitecture {
+  public:
+    //==============================================================================
+    enum class Cpu { unknown, x86, x64, arm, arm64, ppc, ppc64 };
+
+    struct Info {
+        juce::String binaryFormat; // "ELF", "Mach-O" or "PE", empty if not recognised
+        juce::Array<Cpu> cpus;     // More than one for universal binaries
+
+        bool isKnown() const { return !cpus.isEmpty(); }
+        bool contains(Cpu cpu) const { return cpus.contains(cpu); }
+
+        // Architecture string as shown to the user, e.g. "x64" or "x64+ARM64"
+        juce::String toString() const;
+    };
+
+    //==============================================================================
+    BinaryArchitecture();
+    ~BinaryArchitecture();
+
+    // Cached probe - reads the header again only if the file changed
+    Info getArchitecture(const juce::File &binaryFile) const;
+    void clearCache();
+
+    // Uncached header parse
+    static Info probe(const juce::File &binaryFile);
+
+    // Architecture this process was built for
+    static Cpu getHostCpu();
+    static juce::String getCpuName(Cpu cpu);
+
+    // VST3 bundle folder names for an architecture, e.g. "x86_64-linux", "x86_64-win"
+    static juce::String getVST3BundleFolder(Cpu cpu);
+
+  private:
+    //==============================================================================
+    struct CacheEntry {
+        PluginScanCache::FileIdentity identity;
+        Info info;
+    };
+
+    mutable std::map<juce::String, CacheEntry> cache;
+    mutable juce::CriticalSection cacheLock;
+
+    static Info parseELF(const juce::uint8 *data, size_t size);
+    static Info parseMachO(const juce::uint8 *data, size_t size);
+    static Info parsePE(const juce::uint8 *data, size_t size);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BinaryArchitecture)
+};
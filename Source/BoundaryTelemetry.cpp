@@ -0,0 +1,37 @@
+#include "BoundaryTelemetry.h"
+
+//==============================================================================
+void BoundaryTelemetry::measure(const float *const *channels, int numChannels, int numSamples) {
+    numChannels = juce::jmin(numChannels, maxChannels);
+    auto resetCounts = countResetPending.exchange(false);
+
+    publishLock.beginWrite();
+    published.numChannels = numChannels;
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        SignalKernels::Telemetry telemetry;
+        if (channels[channel] != nullptr)
+            SignalKernels::measureTelemetry(channels[channel], numSamples, telemetry);
+
+        auto &result = published.channels[(size_t)channel];
+        if (resetCounts)
+            result.numNaNs = result.numInfinities = result.numDenormals = 0;
+
+        result.peak = juce::jmax(telemetry.peak, result.peak * peakDecay);
+        result.rms = telemetry.getRMS();
+        result.dcOffset = telemetry.getDCOffset();
+        result.numNaNs += telemetry.numNaNs;
+        result.numInfinities += telemetry.numInfinities;
+        result.numDenormals += telemetry.numDenormals;
+    }
+
+    publishLock.endWrite();
+}
+
+bool BoundaryTelemetry::getSnapshot(TelemetrySnapshot &snapshot) const {
+    return publishLock.read(snapshot.version, [&] {
+        // A torn channel count is caught by the retry
+        snapshot.numChannels = juce::jlimit(0, maxChannels, published.numChannels);
+        std::copy_n(published.channels.begin(), snapshot.numChannels, snapshot.channels.begin());
+    });
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "SeqLock.h"
+#include "SignalKernels.h"
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/**
+    Levels and sample health of one channel at a boundary: peak held with a
+    slow decay, RMS and DC offset of the last block, and how many NaN,
+    infinite and denormal samples went through since the last reset.
+*/
+struct ChannelTelemetry {
+    float peak = 0.0f;
+    float rms = 0.0f;
+    float dcOffset = 0.0f;
+    juce::int64 numNaNs = 0;
+    juce::int64 numInfinities = 0;
+    juce::int64 numDenormals = 0;
+};
+
+struct TelemetrySnapshot {
+    static constexpr int maxChannels = 64;
+
+    juce::uint64 version = 0; // 0 until the first block was copied
+    int numChannels = 0;      // Only these channels are valid
+    std::array<ChannelTelemetry, maxChannels> channels;
+
+    // NaNs and infinities on any channel since the last reset
+    juce::int64 getNumNonFinite() const {
+        juce::int64 total = 0;
+        for (int channel = 0; channel < numChannels; ++channel)
+            total += channels[(size_t)channel].numNaNs + channels[(size_t)channel].numInfinities;
+        return total;
+    }
+};
+
+//==============================================================================
+/**
+    Telemetry of the samples crossing one boundary of the app, e.g. what the
+    input device delivers or what goes to the output device.
+
+    The audio thread measures each block once, with the fused
+    SignalKernels::measureTelemetry() pass per channel, and publishes the
+    result under a SeqLock - no locks, no allocation. Meters and diagnostics
+    read the snapshot instead of scanning the samples again.
+*/
+class BoundaryTelemetry {
+  public:
+    //==============================================================================
+    BoundaryTelemetry() = default;
+
+    // Audio thread: measures a block. Null channel pointers read as silence.
+    void measure(const float *const *channels, int numChannels, int numSamples);
+
+    // Copies the latest block's telemetry if it is newer than snapshot.version. Any thread.
+    bool getSnapshot(TelemetrySnapshot &snapshot) const;
+
+    // Zeroes the sample counts with the next block
+    void resetCounts() { countResetPending = true; }
+
+    static constexpr int maxChannels = TelemetrySnapshot::maxChannels;
+
+  private:
+    //==============================================================================
+    TelemetrySnapshot published;
+    SeqLock publishLock;
+    std::atomic<bool> countResetPending{false};
+
+    // Held peaks fall by this much per block
+    static constexpr float peakDecay = 0.98f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BoundaryTelemetry)
+};
@@ -0,0 +1,128 @@
+#include "BridgedInputs.h"
+
+//==============================================================================
+BridgedInputs::Input::~Input() {
+    if (device != nullptr)
+        device->close();
+}
+
+void BridgedInputs::Input::audioDeviceIOCallbackWithContext(const float *const *inputChannelData, int numInputChannels,
+                                                            float *const *, int, int numSamples,
+                                                            const juce::AudioIODeviceCallbackContext &) {
+    bridge.push(inputChannelData, numInputChannels, numSamples);
+}
+
+//==============================================================================
+BridgedInputs::BridgedInputs(juce::AudioDeviceManager &manager) : deviceManager(manager) {}
+
+BridgedInputs::~BridgedInputs() { close(); }
+
+juce::String BridgedInputs::open(const juce::StringArray &deviceNames, double outputSampleRate, int outputBlockSize) {
+    juce::OwnedArray<Input> opened;
+    auto totalChannels = 0;
+
+    for (const auto &deviceName : deviceNames) {
+        auto input = std::make_unique<Input>();
+        input->device.reset(createInputDevice(deviceName));
+        if (input->device == nullptr)
+            return "Input device not found: " + deviceName;
+
+        auto &device = *input->device;
+        auto numDeviceChannels = juce::jmin(device.getInputChannelNames().size(), maxChannels - totalChannels);
+        if (numDeviceChannels <= 0)
+            return "No input channels left for " + deviceName;
+
+        // At the output's rate, only the drift needs resampling
+        auto sampleRate = outputSampleRate;
+        auto sampleRates = device.getAvailableSampleRates();
+        if (!sampleRates.isEmpty() && !sampleRates.contains(outputSampleRate)) {
+            sampleRate = sampleRates.getFirst();
+            for (auto rate : sampleRates) {
+                if (std::abs(rate - outputSampleRate) < std::abs(sampleRate - outputSampleRate))
+                    sampleRate = rate;
+            }
+        }
+
+        auto bufferSizes = device.getAvailableBufferSizes();
+        auto bufferSize = bufferSizes.contains(outputBlockSize) ? outputBlockSize : device.getDefaultBufferSize();
+
+        juce::BigInteger channels;
+        channels.setRange(0, numDeviceChannels, true);
+        auto error = device.open(channels, {}, sampleRate, bufferSize);
+        if (error.isNotEmpty())
+            return deviceName + ": " + error;
+
+        input->numChannels = device.getActiveInputChannels().countNumberOfSetBits();
+        input->bridge.prepare(input->numChannels, device.getCurrentSampleRate(), device.getCurrentBufferSizeSamples(),
+                              outputSampleRate, outputBlockSize);
+
+        DBG("Bridged input: " + deviceName + ", " + juce::String(input->numChannels) + " channels at " +
+            juce::String(device.getCurrentSampleRate()) + " Hz, " + juce::String(device.getCurrentBufferSizeSamples()) +
+            " samples");
+
+        // Fills the ring until the output starts pulling, which then drops the surplus
+        device.start(input.get());
+        totalChannels += input->numChannels;
+        opened.add(input.release());
+    }
+
+    {
+        const juce::ScopedLock lock(deviceManager.getAudioCallbackLock());
+        inputs.swapWith(opened);
+        numChannels = totalChannels;
+    }
+
+    // The previous devices close here, outside the lock
+    return {};
+}
+
+void BridgedInputs::close() {
+    juce::OwnedArray<Input> closed;
+    {
+        const juce::ScopedLock lock(deviceManager.getAudioCallbackLock());
+        inputs.swapWith(closed);
+        numChannels = 0;
+    }
+}
+
+void BridgedInputs::pull(float *const *channels, int numChannelsToFill, int numSamples) {
+    auto channel = 0;
+    for (auto *input : inputs) {
+        auto numToFill = juce::jmin(input->numChannels, numChannelsToFill - channel);
+        if (numToFill <= 0)
+            break;
+
+        input->bridge.pull(channels + channel, numToFill, numSamples);
+        channel += numToFill;
+    }
+
+    for (; channel < numChannelsToFill; ++channel)
+        juce::FloatVectorOperations::clear(channels[channel], numSamples);
+}
+
+juce::Array<BridgedInputs::DeviceStatus> BridgedInputs::getStatus() const {
+    juce::Array<DeviceStatus> status;
+    for (auto *input : inputs) {
+        DeviceStatus deviceStatus;
+        deviceStatus.name = input->device->getName();
+        deviceStatus.numChannels = input->numChannels;
+        deviceStatus.sampleRate = input->device->getCurrentSampleRate();
+        deviceStatus.bridge = input->bridge.getStatus();
+        status.add(deviceStatus);
+    }
+    return status;
+}
+
+juce::AudioIODevice *BridgedInputs::createInputDevice(const juce::String &deviceName) const {
+    for (auto *deviceType : deviceManager.getAvailableDeviceTypes()) {
+        if (deviceType == nullptr || !deviceType->getDeviceNames(true).contains(deviceName))
+            continue;
+
+        // Types without separate inputs and outputs name the device on both sides
+        auto outputName = deviceType->hasSeparateInputsAndOutputs() ? juce::String() : deviceName;
+        if (auto *device = deviceType->createDevice(outputName, deviceName))
+            return device;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BoundaryTelemetry.h"
+#include "DriftBridge.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/**
+    Input devices opened next to the device manager's output device, each on
+    its own clock, and brought into the output's clock domain by a
+    DriftBridge each. Their channels are concatenated into one set: the first
+    device's, then the second's and so on, up to maxChannels. That lets an
+    input and an output on separate hardware run without clicks, and several
+    input devices feed one chain.
+
+    The output device's callback pulls the channels. The device list is
+    swapped under the device manager's audio callback lock, so open() and
+    close() can run while the output plays.
+*/
+class BridgedInputs {
+  public:
+    //==============================================================================
+    explicit BridgedInputs(juce::AudioDeviceManager &deviceManager);
+    ~BridgedInputs();
+
+    // Message thread. Opens each device with every input channel, at the output's sample rate where the device
+    // supports it, and starts it. Replaces the devices opened before. Returns the first error, opening none.
+    juce::String open(const juce::StringArray &deviceNames, double outputSampleRate, int outputBlockSize);
+    void close();
+
+    // Message thread, or the output device's callback
+    bool isOpen() const { return !inputs.isEmpty(); }
+    int getNumChannels() const { return numChannels; }
+
+    // Output device's callback: numSamples of every bridged channel, silence in the channels beyond them
+    void pull(float *const *channels, int numChannelsToFill, int numSamples);
+
+    //==============================================================================
+    struct DeviceStatus {
+        juce::String name;
+        int numChannels = 0;
+        double sampleRate = 0.0;
+        DriftBridge::Status bridge;
+    };
+
+    // Message thread
+    juce::Array<DeviceStatus> getStatus() const;
+
+    static constexpr int maxChannels = BoundaryTelemetry::maxChannels;
+
+  private:
+    //==============================================================================
+    // One input device and the bridge its callback pushes into
+    struct Input : public juce::AudioIODeviceCallback {
+        DriftBridge bridge;
+        std::unique_ptr<juce::AudioIODevice> device;
+        int numChannels = 0;
+
+        ~Input() override;
+
+        void audioDeviceIOCallbackWithContext(const float *const *inputChannelData, int numInputChannels,
+                                              float *const *outputChannelData, int numOutputChannels, int numSamples,
+                                              const juce::AudioIODeviceCallbackContext &context) override;
+        void audioDeviceAboutToStart(juce::AudioIODevice *) override {}
+        void audioDeviceStopped() override {}
+    };
+
+    juce::AudioDeviceManager &deviceManager;
+    juce::OwnedArray<Input> inputs;
+    int numChannels = 0;
+
+    juce::AudioIODevice *createInputDevice(const juce::String &deviceName) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BridgedInputs)
+};
@@ -0,0 +1,612 @@
+#include "CommandLineTools.h"
+#include "AudioPipeline.h"
+#include "AudioProcessor.h"
+#include "BoundaryTelemetry.h"
+#include "JackAudioDevice.h"
+#include "PluginCatalog.h"
+#include "PluginHost.h"
+#include "PluginSearchIndex.h"
+#include "RealFFT.h"
+#include "SessionFile.h"
+#include "SimulatedAudioDevice.h"
+#include "UserConfig.h"
+#include <iostream>
+
+namespace {
+const juce::String scanPluginsOption("--scan-plugins");
+const juce::String convertSessionOption("--convert-session");
+const juce::String benchmarkSessionOption("--benchmark-session");
+const juce::String benchmarkFFTOption("--benchmark-fft");
+const juce::String benchmarkPipelineOption("--benchmark-pipeline");
+const juce::String benchmarkSearchOption("--benchmark-search");
+
+enum ExitCode { success = 0, outputNotWritten = 1, badArguments = 2, checkFailed = 3 };
+
+juce::var toVar(const juce::StringArray &strings) {
+    juce::Array<juce::var> values;
+    for (const auto &string : strings)
+        values.add(string);
+    return values;
+}
+
+juce::var toVar(const TelemetrySnapshot &snapshot) {
+    juce::Array<juce::var> channels;
+    for (int channel = 0; channel < snapshot.numChannels; ++channel) {
+        const auto &telemetry = snapshot.channels[(size_t)channel];
+        auto *result = new juce::DynamicObject();
+        result->setProperty("peak", telemetry.peak);
+        result->setProperty("rms", telemetry.rms);
+        result->setProperty("dcOffset", telemetry.dcOffset);
+        result->setProperty("nans", telemetry.numNaNs);
+        result->setProperty("infinities", telemetry.numInfinities);
+        result->setProperty("denormals", telemetry.numDenormals);
+        channels.add(juce::var(result));
+    }
+    return channels;
+}
+
+double getMillisecondsSince(juce::int64 startTicks) {
+    return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+}
+
+// Stand-in chain for benchmarking when no session file is given
+juce::ValueTree createSyntheticSession(int numPlugins, int stateSize) {
+    juce::ValueTree session("PluginChain");
+    juce::Random random(42);
+
+    for (int i = 0; i < numPlugins; ++i) {
+        // Half noise, half repeated parameter-like values - typical plugin state is somewhere in between
+        juce::MemoryBlock state((size_t)stateSize);
+        auto *bytes = static_cast<juce::uint8 *>(state.getData());
+        for (int b = 0; b < stateSize; ++b)
+            bytes[b] = b < stateSize / 2 ? (juce::uint8)random.nextInt(256) : (juce::uint8)(b % 16);
+
+        juce::ValueTree pluginState("Plugin");
+        pluginState.setProperty("name", "Plugin " + juce::String(i + 1), nullptr);
+        pluginState.setProperty("manufacturer", "Benchmark", nullptr);
+        pluginState.setProperty("version", "1.0", nullptr);
+        pluginState.setProperty("fileOrIdentifier", "/plugins/Plugin" + juce::String(i + 1) + ".vst3", nullptr);
+        pluginState.setProperty("identifier", "VST3-Plugin" + juce::String(i + 1), nullptr);
+        pluginState.setProperty("bypassed", false, nullptr);
+        pluginState.setProperty("state", juce::var(std::move(state)), nullptr);
+        session.appendChild(pluginState, nullptr);
+    }
+
+    return session;
+}
+
+// Stand-in catalog for benchmarking the plugin search: made-up names from a few hundred manufacturers
+void fillSyntheticCatalog(PluginCatalog &catalog, int numPlugins, UserConfig::PluginUsageMap &usage) {
+    static const char *const syllables[] = {"com", "pre", "ver", "b", "ta", "lo", "phi", "sat", "ur", "ex",
+                                            "pan", "del", "ay", "rev", "erb", "chor", "us", "dyn", "eq", "max"};
+    static const char *const kinds[] = {"Compressor", "Equalizer", "Reverb", "Delay", "Limiter",
+                                        "Saturator", "Chorus", "Gate", "Filter", "Analyzer"};
+    static const char *const formats[] = {"VST3", "VST", "AudioUnit"};
+    juce::Random random(42);
+
+    auto makeWord = [&random](int numSyllables) {
+        juce::String word;
+        for (int i = 0; i < numSyllables; ++i)
+            word << syllables[random.nextInt((int)std::size(syllables))];
+        return word.substring(0, 1).toUpperCase() + word.substring(1);
+    };
+
+    juce::StringArray manufacturers;
+    for (int i = 0; i < 300; ++i)
+        manufacturers.add(makeWord(2) + " Audio");
+
+    for (int i = 0; i < numPlugins; ++i) {
+        PluginCatalog::ShellRecord shell;
+        shell.formatName = formats[i % (int)std::size(formats)];
+        shell.file = "/plugins/Plugin" + juce::String(i) + "." + shell.formatName.toLowerCase();
+        shell.numPlugins = 1;
+
+        PluginCatalog::Record record;
+        record.name = makeWord(1 + random.nextInt(3)) + " " + kinds[random.nextInt((int)std::size(kinds))];
+        record.manufacturer = manufacturers[random.nextInt(manufacturers.size())];
+        record.version = "1.0";
+        record.formatName = shell.formatName;
+        record.fileOrIdentifier = shell.file;
+        record.identifier = shell.formatName + "-" + record.name + "-" + juce::String(i);
+        record.flags = PluginCatalog::Record::compatibleFlag;
+        record.shell = catalog.addShell(shell);
+        catalog.addRecord(record);
+
+        // A full recently used list, as the ranking reads it for every result
+        if (i % (numPlugins / 100 + 1) == 0)
+            usage[record.identifier] = {shell.file, juce::Time::getCurrentTime(), 1 + random.nextInt(20)};
+    }
+}
+} // namespace
+
+//==============================================================================
+bool CommandLineTools::handlesCommandLine(const juce::String &commandLine) {
+    juce::ArgumentList arguments("AudioChain", commandLine);
+    return arguments.containsOption(scanPluginsOption) || arguments.containsOption(convertSessionOption) ||
+           arguments.containsOption(benchmarkSessionOption) || arguments.containsOption(benchmarkFFTOption) ||
+           arguments.containsOption(benchmarkPipelineOption) || arguments.containsOption(benchmarkSearchOption);
+}
+
+int CommandLineTools::run(const juce::String &commandLine) {
+    juce::ArgumentList arguments("AudioChain", commandLine);
+
+    if (arguments.containsOption(scanPluginsOption))
+        return scanPlugins(arguments);
+
+    if (arguments.containsOption(convertSessionOption))
+        return convertSession(arguments);
+
+    if (arguments.containsOption(benchmarkSessionOption))
+        return benchmarkSession(arguments);
+
+    if (arguments.containsOption(benchmarkFFTOption))
+        return benchmarkFFT(arguments);
+
+    if (arguments.containsOption(benchmarkPipelineOption))
+        return benchmarkPipeline(arguments);
+
+    if (arguments.containsOption(benchmarkSearchOption))
+        return benchmarkSearch(arguments);
+
+    printUsage();
+    return badArguments;
+}
+
+//==============================================================================
+int CommandLineTools::scanPlugins(const juce::ArgumentList &arguments) {
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    juce::StringArray searchPaths;
+    if (arguments.containsOption("--paths")) {
+        searchPaths = juce::StringArray::fromTokens(arguments.getValueForOption("--paths"), ";", "\"");
+        searchPaths.trim();
+        searchPaths.removeEmptyStrings();
+
+        if (searchPaths.isEmpty()) {
+            std::cerr << "--paths needs at least one directory" << std::endl;
+            printUsage();
+            return badArguments;
+        }
+    } else {
+        searchPaths = UserConfig().getVSTSearchPaths();
+    }
+
+    PluginHost pluginHost;
+
+    if (arguments.containsOption("--cache")) {
+        auto cachePath = arguments.getValueForOption("--cache");
+        if (cachePath.isEmpty()) {
+            std::cerr << "--cache needs a file name" << std::endl;
+            printUsage();
+            return badArguments;
+        }
+        pluginHost.setScanCacheFile(juce::File::getCurrentWorkingDirectory().getChildFile(cachePath));
+    }
+
+    // Reuse shells from an existing cache unless asked to enumerate everything again
+    if (arguments.containsOption("--clean")) {
+        pluginHost.getScanCacheFile().deleteFile();
+    } else {
+        pluginHost.loadScanCache();
+    }
+
+    pluginHost.scanForPlugins(searchPaths);
+
+    const auto &statistics = pluginHost.getLastScanStatistics();
+    auto cacheFile = pluginHost.getScanCacheFile();
+    auto cacheWritten = statistics.cacheWritten;
+
+    auto *summary = new juce::DynamicObject();
+    summary->setProperty("status", cacheWritten ? "ok" : "cache-not-written");
+    summary->setProperty("cacheFile", cacheFile.getFullPathName());
+    summary->setProperty("searchPaths", toVar(searchPaths));
+    summary->setProperty("files", statistics.numFiles);
+    summary->setProperty("cachedShells", statistics.numCached);
+    summary->setProperty("enumeratedShells", statistics.numEnumerated);
+    summary->setProperty("plugins", statistics.numPlugins);
+    summary->setProperty("failed", toVar(statistics.failedFiles));
+    summary->setProperty("incompatible", toVar(statistics.incompatibleFiles));
+    summary->setProperty("scanMs", statistics.elapsedMs);
+    summary->setProperty("totalMs", getMillisecondsSince(startTicks));
+
+    std::cout << juce::JSON::toString(juce::var(summary)) << std::endl;
+
+    return cacheWritten ? success : outputNotWritten;
+}
+
+//==============================================================================
+int CommandLineTools::convertSession(const juce::ArgumentList &arguments) {
+    auto index = arguments.indexOfOption(convertSessionOption);
+    if (index < 0 || index + 2 >= arguments.size()) {
+        printUsage();
+        return badArguments;
+    }
+
+    auto inputFile = arguments[index + 1].resolveAsFile();
+    auto outputFile = arguments[index + 2].resolveAsFile();
+
+    auto session = SessionFile::read(inputFile, &PluginStateStore::getInstance());
+    if (!session.isValid()) {
+        std::cerr << "Could not read session: " << inputFile.getFullPathName() << std::endl;
+        return badArguments;
+    }
+
+    // The output format follows the extension - XML for .xml, binary otherwise. Either way the
+    // states are written into the file itself, so it can be moved to another machine.
+    auto written = outputFile.hasFileExtension("xml") ? SessionFile::writeXml(session, outputFile)
+                                                      : SessionFile::write(session, outputFile);
+
+    if (!written) {
+        std::cerr << "Could not write session: " << outputFile.getFullPathName() << std::endl;
+        return outputNotWritten;
+    }
+
+    return success;
+}
+
+int CommandLineTools::benchmarkSession(const juce::ArgumentList &arguments) {
+    auto index = arguments.indexOfOption(benchmarkSessionOption);
+    auto iterations =
+        arguments.containsOption("--iterations") ? juce::jmax(1, arguments.getValueForOption("--iterations").getIntValue())
+                                                 : 20;
+
+    // A real session if one is given, otherwise a synthetic 8 plugin chain with 64 kB states
+    juce::ValueTree session;
+    juce::String source("synthetic");
+    if (index >= 0 && index + 1 < arguments.size() && !arguments[index + 1].isOption()) {
+        auto sessionFile = arguments[index + 1].resolveAsFile();
+        session = SessionFile::read(sessionFile, &PluginStateStore::getInstance());
+        source = sessionFile.getFullPathName();
+
+        if (!session.isValid()) {
+            std::cerr << "Could not read session: " << source << std::endl;
+            return badArguments;
+        }
+    } else {
+        session = createSyntheticSession(8, 64 * 1024);
+    }
+
+    juce::TemporaryFile xmlFile(".xml"), binaryFile(".acsn"), compressedFile(".acsn");
+    SessionFile::writeXml(session, xmlFile.getFile());
+    SessionFile::write(session, binaryFile.getFile(), SessionFile::Compression::none);
+    SessionFile::write(session, compressedFile.getFile(), SessionFile::Compression::zlib);
+
+    auto measure = [iterations](const juce::File &file) {
+        // One untimed load to warm the file cache
+        SessionFile::read(file);
+
+        auto startTicks = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < iterations; ++i)
+            SessionFile::read(file);
+
+        auto *result = new juce::DynamicObject();
+        result->setProperty("bytes", file.getSize());
+        result->setProperty("loadMs", getMillisecondsSince(startTicks) / iterations);
+        return juce::var(result);
+    };
+
+    auto *summary = new juce::DynamicObject();
+    summary->setProperty("source", source);
+    summary->setProperty("plugins", session.getNumChildren());
+    summary->setProperty("iterations", iterations);
+    summary->setProperty("xml", measure(xmlFile.getFile()));
+    summary->setProperty("binary", measure(binaryFile.getFile()));
+    summary->setProperty("binaryCompressed", measure(compressedFile.getFile()));
+
+    std::cout << juce::JSON::toString(juce::var(summary)) << std::endl;
+    return success;
+}
+
+int CommandLineTools::benchmarkFFT(const juce::ArgumentList &arguments) {
+    auto iterations = arguments.containsOption("--iterations")
+                          ? juce::jmax(1, arguments.getValueForOption("--iterations").getIntValue())
+                          : 1000;
+
+    // Largest error relative to the largest magnitude of JUCE's result
+    constexpr auto tolerance = 1.0e-4f;
+    auto allPassed = true;
+    juce::Random random(42);
+    juce::Array<juce::var> results;
+
+    for (int order = 6; order <= 14; ++order) {
+        auto size = 1 << order;
+        std::vector<float> input((size_t)size);
+        for (auto &sample : input)
+            sample = random.nextFloat() * 2.0f - 1.0f;
+
+        std::vector<float> reference((size_t)size * 2), data((size_t)size * 2);
+        auto transform = [&](RealFFT &fft, std::vector<float> &output) {
+            std::copy(input.begin(), input.end(), output.begin());
+            fft.performForward(output.data());
+        };
+
+        // Every timed run transforms the same input - transforming the previous output over and over overflows to
+        // infinities within a few runs. The copy's own cost is timed separately and taken off.
+        auto measure = [&](RealFFT &fft, std::vector<float> &output) {
+            transform(fft, output);
+
+            auto copyTicks = juce::Time::getHighResolutionTicks();
+            for (int i = 0; i < iterations; ++i) {
+                std::copy(input.begin(), input.end(), output.begin());
+                juce::ignoreUnused(*(volatile float *)output.data());
+            }
+            auto copyMs = getMillisecondsSince(copyTicks);
+
+            auto startTicks = juce::Time::getHighResolutionTicks();
+            for (int i = 0; i < iterations; ++i)
+                transform(fft, output);
+            auto transformMs = getMillisecondsSince(startTicks);
+
+            return juce::jmax(0.0, transformMs - copyMs) * 1000.0 / iterations;
+        };
+
+        RealFFT juceFFT(order, RealFFT::Engine::juce);
+        auto *result = new juce::DynamicObject();
+        result->setProperty("size", size);
+        result->setProperty("juceUs", measure(juceFFT, reference));
+
+        auto largestMagnitude = 0.0f;
+        for (int bin = 0; bin <= size / 2; ++bin)
+            largestMagnitude = juce::jmax(largestMagnitude, std::hypot(reference[(size_t)bin * 2],
+                                                                       reference[(size_t)bin * 2 + 1]));
+
+        for (auto instructionSet : RealFFT::getSupportedInstructionSets()) {
+            RealFFT fft(order, instructionSet);
+            auto microseconds = measure(fft, data);
+
+            auto error = 0.0f;
+            for (int i = 0; i < size + 2; ++i)
+                error = juce::jmax(error, std::abs(data[(size_t)i] - reference[(size_t)i]));
+            error /= juce::jmax(largestMagnitude, 1.0e-9f);
+            allPassed = allPassed && error <= tolerance;
+
+            auto *engineResult = new juce::DynamicObject();
+            engineResult->setProperty("us", microseconds);
+            engineResult->setProperty("relativeError", error);
+            result->setProperty(RealFFT::getName(instructionSet), juce::var(engineResult));
+        }
+
+        results.add(juce::var(result));
+    }
+
+    auto *summary = new juce::DynamicObject();
+    summary->setProperty("status", allPassed ? "ok" : "error-above-tolerance");
+    summary->setProperty("defaultEngine", RealFFT::getDefaultEngine() == RealFFT::Engine::juce ? "juce" : "inTree");
+    summary->setProperty("bestInstructionSet", RealFFT::getName(RealFFT::getBestInstructionSet()));
+    summary->setProperty("iterations", iterations);
+    summary->setProperty("tolerance", tolerance);
+    summary->setProperty("sizes", results);
+
+    std::cout << juce::JSON::toString(juce::var(summary)) << std::endl;
+    return allPassed ? success : checkFailed;
+}
+
+int CommandLineTools::benchmarkPipeline(const juce::ArgumentList &arguments) {
+    auto useJack = arguments.containsOption("--jack");
+#if !AUDIOCHAIN_JACK
+    if (useJack) {
+        std::cerr << "Built without JACK support" << std::endl;
+        return badArguments;
+    }
+#endif
+
+    // Back to back callbacks unless the device spec asks for real time
+    SimulatedDeviceSettings settings;
+    settings.realTime = false;
+
+    if (arguments.containsOption("--device")) {
+        juce::String error;
+        if (!SimulatedDeviceSettings::fromString(arguments.getValueForOption("--device"), settings, error)) {
+            std::cerr << error << std::endl;
+            printUsage();
+            return badArguments;
+        }
+    }
+
+    auto seconds = arguments.containsOption("--seconds")
+                       ? juce::jmax(0.1, arguments.getValueForOption("--seconds").getDoubleValue())
+                       : 10.0;
+
+    // The session's chain, or no plugins to measure the pipeline's own cost
+    PluginHost pluginHost;
+    juce::String source("none");
+    if (arguments.containsOption("--session")) {
+        auto sessionFile = juce::File::getCurrentWorkingDirectory().getChildFile(
+            arguments.getValueForOption("--session"));
+        auto session = SessionFile::read(sessionFile, &PluginStateStore::getInstance());
+        source = sessionFile.getFullPathName();
+
+        if (!session.isValid()) {
+            std::cerr << "Could not read session: " << source << std::endl;
+            return badArguments;
+        }
+
+        pluginHost.loadScanCache();
+        pluginHost.loadCatalogFromCache();
+        pluginHost.setState(session);
+    }
+
+    AudioProcessor audioProcessor;
+    audioProcessor.start();
+
+    BoundaryTelemetry inputTelemetry, outputTelemetry;
+    AudioPipeline pipeline(pluginHost, audioProcessor, inputTelemetry, outputTelemetry);
+
+    // A client of the running JACK server, in its real-time callback, or the simulated device
+    std::unique_ptr<juce::AudioIODevice> device;
+    auto sampleRate = settings.sampleRate;
+    auto blockSize = settings.blockSize;
+
+#if AUDIOCHAIN_JACK
+    if (useJack) {
+        JackAudioDeviceType jackType;
+        jackType.setAutoConnect(!arguments.containsOption("--no-connect"));
+        jackType.scanForDevices();
+        device.reset(jackType.createDevice(JackAudioDeviceType::deviceName, JackAudioDeviceType::deviceName));
+        if (device == nullptr) {
+            std::cerr << "No JACK server running" << std::endl;
+            return checkFailed;
+        }
+
+        // The server's rate; its period unless another is asked for
+        sampleRate = 0.0;
+        blockSize = arguments.containsOption("--period") ? arguments.getValueForOption("--period").getIntValue() : 0;
+    }
+#endif
+
+    if (device == nullptr)
+        device = std::make_unique<SimulatedAudioDevice>(SimulatedAudioDeviceType::deviceName, settings);
+
+    juce::BigInteger inputChannels, outputChannels;
+    inputChannels.setRange(0, device->getInputChannelNames().size(), true);
+    outputChannels.setRange(0, device->getOutputChannelNames().size(), true);
+
+    auto error = device->open(inputChannels, outputChannels, sampleRate, blockSize);
+    if (error.isNotEmpty()) {
+        std::cerr << "Could not open " << device->getName() << ": " << error << std::endl;
+        return checkFailed;
+    }
+
+    sampleRate = device->getCurrentSampleRate();
+    blockSize = device->getCurrentBufferSizeSamples();
+
+    // Gives up on chains that run at less than a quarter of real time
+    auto samplesToRender = (juce::int64)(seconds * sampleRate);
+    auto timeoutMs = juce::jmax(seconds * 4.0, seconds + 10.0) * 1000.0;
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    device->start(&pipeline);
+    while (pipeline.getStatistics().numSamples < samplesToRender && getMillisecondsSince(startTicks) < timeoutMs)
+        juce::Thread::sleep(5);
+    device->stop();
+
+    auto wallSeconds = getMillisecondsSince(startTicks) / 1000.0;
+    auto statistics = pipeline.getStatistics();
+    auto renderedSeconds = (double)statistics.numSamples / sampleRate;
+
+    TelemetrySnapshot input, output;
+    inputTelemetry.getSnapshot(input);
+    outputTelemetry.getSnapshot(output);
+
+    auto timedOut = statistics.numSamples < samplesToRender;
+    auto nonFiniteOutput = output.getNumNonFinite() > 0;
+
+    auto *pipelineResult = new juce::DynamicObject();
+    pipelineResult->setProperty("callbacks", statistics.numCallbacks);
+    pipelineResult->setProperty("meanLoad", statistics.meanLoad);
+    pipelineResult->setProperty("maxLoad", statistics.maxLoad);
+    pipelineResult->setProperty("overruns", statistics.numOverruns);
+
+    auto *deviceResult = new juce::DynamicObject();
+    deviceResult->setProperty("sampleRate", sampleRate);
+    deviceResult->setProperty("blockSize", blockSize);
+    deviceResult->setProperty("xruns", device->getXRunCount());
+    deviceResult->setProperty("inputLatency", device->getInputLatencyInSamples());
+    deviceResult->setProperty("outputLatency", device->getOutputLatencyInSamples());
+
+    auto deviceDescription = device->getName();
+    if (auto *simulatedDevice = dynamic_cast<SimulatedAudioDevice *>(device.get())) {
+        deviceDescription = settings.toString();
+        deviceResult->setProperty("callbacks", simulatedDevice->getNumCallbacks());
+        deviceResult->setProperty("lateCallbacks", simulatedDevice->getNumLateCallbacks());
+        deviceResult->setProperty("stalls", simulatedDevice->getNumStalls());
+    }
+#if AUDIOCHAIN_JACK
+    if (auto *jackDevice = dynamic_cast<JackAudioDevice *>(device.get()))
+        deviceResult->setProperty("client", jackDevice->getClientName());
+#endif
+
+    auto *summary = new juce::DynamicObject();
+    summary->setProperty("status", timedOut ? "timed-out" : nonFiniteOutput ? "non-finite-output" : "ok");
+    summary->setProperty("device", deviceDescription);
+    summary->setProperty("session", source);
+    summary->setProperty("plugins", pluginHost.getNumPlugins());
+    summary->setProperty("renderedSeconds", renderedSeconds);
+    summary->setProperty("wallSeconds", wallSeconds);
+    summary->setProperty("realTimeFactor", wallSeconds > 0.0 ? renderedSeconds / wallSeconds : 0.0);
+    summary->setProperty("pipeline", juce::var(pipelineResult));
+    summary->setProperty("deviceStatistics", juce::var(deviceResult));
+    summary->setProperty("input", toVar(input));
+    summary->setProperty("output", toVar(output));
+
+    std::cout << juce::JSON::toString(juce::var(summary)) << std::endl;
+
+    device->close();
+    return timedOut || nonFiniteOutput ? checkFailed : success;
+}
+
+int CommandLineTools::benchmarkSearch(const juce::ArgumentList &arguments) {
+    auto numPlugins = arguments.containsOption("--plugins")
+                          ? juce::jmax(1, arguments.getValueForOption("--plugins").getIntValue())
+                          : 10000;
+    auto iterations = arguments.containsOption("--iterations")
+                          ? juce::jmax(1, arguments.getValueForOption("--iterations").getIntValue())
+                          : 200;
+
+    // The browser's budget per keystroke
+    constexpr auto targetMs = 1.0;
+
+    PluginCatalog catalog;
+    UserConfig::PluginUsageMap usage;
+    fillSyntheticCatalog(catalog, numPlugins, usage);
+
+    auto buildTicks = juce::Time::getHighResolutionTicks();
+    PluginSearchIndex index;
+    index.setRecentUsage(usage);
+    index.update(catalog.getView());
+    auto buildMs = getMillisecondsSince(buildTicks);
+
+    // What typing produces: an empty box, short prefixes, whole words, several terms and typos
+    const juce::StringArray queries{"",       "c",          "co",         "comp",           "compressor",
+                                    "verb",   "ta delay",   "com audio",  "compresor",      "rverb",
+                                    "xyzzy",  "eq vst3",    "pre limiter", "phi sat chorus", "audio"};
+
+    auto allPassed = true;
+    auto slowestMs = 0.0;
+    juce::Array<juce::var> results;
+
+    for (const auto &query : queries) {
+        // One untimed search to size the scratch buffers
+        auto numResults = (int)index.search(query).size();
+
+        auto startTicks = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < iterations; ++i)
+            numResults = (int)index.search(query).size();
+        auto meanMs = getMillisecondsSince(startTicks) / iterations;
+
+        slowestMs = juce::jmax(slowestMs, meanMs);
+        allPassed = allPassed && meanMs <= targetMs;
+
+        auto *result = new juce::DynamicObject();
+        result->setProperty("query", query);
+        result->setProperty("results", numResults);
+        result->setProperty("meanMs", meanMs);
+        results.add(juce::var(result));
+    }
+
+    auto *summary = new juce::DynamicObject();
+    summary->setProperty("status", allPassed ? "ok" : "above-target");
+    summary->setProperty("plugins", index.size());
+    summary->setProperty("iterations", iterations);
+    summary->setProperty("buildMs", buildMs);
+    summary->setProperty("targetMs", targetMs);
+    summary->setProperty("slowestMs", slowestMs);
+    summary->setProperty("queries", results);
+
+    std::cout << juce::JSON::toString(juce::var(summary)) << std::endl;
+    return allPassed ? success : checkFailed;
+}
+
+void CommandLineTools::printUsage() {
+    std::cerr << "Usage: AudioChain --scan-plugins [--paths \"dir1;dir2\"] [--cache file] [--clean]" << std::endl
+              << "       AudioChain --convert-session <input> <output(.xml)>" << std::endl
+              << "       AudioChain --benchmark-session [session file] [--iterations n]" << std::endl
+              << "       AudioChain --benchmark-fft [--iterations n]" << std::endl
+              << "       AudioChain --benchmark-pipeline [--device \"rate=48000,block=256,...\"] [--seconds n] "
+                 "[--session file]"
+              << std::endl
+              << "       AudioChain --benchmark-search [--plugins n] [--iterations n]" << std::endl
+              << "       AudioChain --benchmark-pipeline --jack [--period n] [--no-connect] [--seconds n] "
+                 "[--session file]"
+              << std::endl;
+}
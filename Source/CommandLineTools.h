@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/**
+    Headless command line modes, run instead of opening the main window.
+
+    --scan-plugins [--paths "dir1;dir2"] [--cache file] [--clean]
+        Scans the search paths (default: the configured VST search paths) and
+        writes the persistent plugin cache, then prints a JSON summary to stdout:
+        counts, failed and incompatible files, and timings. Useful to build the
+        cache once when provisioning a machine - the GUI loads it at startup
+        without scanning again.
+
+    --convert-session <input> <output>
+        Converts a session between the binary format and XML. The input format is
+        detected, the output is XML if its extension is .xml, binary otherwise.
+
+    --benchmark-session [session file] [--iterations n]
+        Writes the session (or a synthetic one) as XML, binary and compressed
+        binary, and prints each file's size and average load time as JSON.
+
+    --benchmark-fft [--iterations n]
+        Checks the in-tree real FFT against JUCE's for sizes 64 to 16384, with
+        every instruction set this CPU supports, and prints the time per
+        transform and the relative error as JSON.
+
+    --benchmark-pipeline [--device "spec"] [--seconds n] [--session file]
+        Runs the audio callback path (input telemetry, plugin chain, analyser,
+        output telemetry) on a simulated device for n seconds of audio (default
+        10), with the session's plugins or none. The device spec is that of
+        SimulatedDeviceSettings; callbacks run back to back unless it has
+        realtime=1. Prints the rendered and wall clock time, the callback load,
+        the device's late callbacks and stalls, and the boundary telemetry as
+        JSON. The check fails if the device can't be opened, the chain runs at
+        less than a quarter of real time or non-finite samples reach the output.
+
+    --benchmark-pipeline --jack [--period n] [--no-connect] [--seconds n] [--session file]
+        The same on a client of the running JACK server (Linux builds with
+        JACK), in the server's real-time callback: at its rate, with a period
+        of n samples if the server accepts it, and with the ports connected to
+        the physical ones unless --no-connect. Also prints the xruns the server
+        reported and the port latencies. Fails if no server is running.
+
+    --benchmark-search [--plugins n] [--iterations n]
+        Indexes a synthetic catalog of n plugins (default 10000) and times the
+        plugin browser's search for a set of typical queries. Prints the index
+        build time and each query's mean time as JSON. The check fails if any
+        query takes more than 1 ms on average.
+
+    Exit codes: 0 on success, 1 if the output couldn't be written, 2 for bad arguments,
+    3 if a check failed.
+*/
+class CommandLineTools {
+  public:
+    //==============================================================================
+    // True if the command line asks for a headless mode
+    static bool handlesCommandLine(const juce::String &commandLine);
+
+    // Runs the requested mode on the calling (message) thread and returns the exit code
+    static int run(const juce::String &commandLine);
+
+  private:
+    //==============================================================================
+    static int scanPlugins(const juce::ArgumentList &arguments);
+    static int convertSession(const juce::ArgumentList &arguments);
+    static int benchmarkSession(const juce::ArgumentList &arguments);
+    static int benchmarkFFT(const juce::ArgumentList &arguments);
+    static int benchmarkPipeline(const juce::ArgumentList &arguments);
+    static int benchmarkSearch(const juce::ArgumentList &arguments);
+    static void printUsage();
+
+    CommandLineTools() = delete;
+};
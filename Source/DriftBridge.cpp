@@ -0,0 +1,181 @@
+#include "DriftBridge.h"
+
+namespace {
+// Time constant of the fill estimate, long enough to average out both devices' block sawtooth
+constexpr double fillSmoothingSeconds = 0.25;
+
+// PI gains for a loop with a natural frequency of 0.1 Hz and a damping of 0.7: slow enough that the ratio
+// changes are inaudible, fast enough to lock within about 15 seconds of the devices starting
+constexpr double proportionalGain = 0.89; // Per second
+constexpr double integralGain = 0.39;     // Per second squared
+} // namespace
+
+//==============================================================================
+void DriftBridge::prepare(int channels, double inputRate, int inputBlockSize, double outputRate,
+                          int outputBlockSize) {
+    numChannels = juce::jmax(0, channels);
+    inputSampleRate = inputRate;
+    outputSampleRate = outputRate;
+    nominalRatio = inputRate / outputRate;
+    maxPullSize = juce::jmax(1, outputBlockSize);
+
+    // Input samples one pull can consume, at the largest correction
+    auto maxPullInput = (int)std::ceil(maxPullSize * nominalRatio * (1.0 + maxCorrection)) + 1;
+
+    // Just before an input block arrives, the ring is a block below the average fill - a pull must still find
+    // enough samples then
+    targetFill = inputBlockSize + maxPullInput + juce::roundToInt(safetyMarginMs * inputRate / 1000.0);
+    maxFill = 2 * targetFill + inputBlockSize;
+
+    ringBuffer.setSize(numChannels, maxFill + inputBlockSize + 1);
+    ringBuffer.clear();
+    ringFifo.setTotalSize(ringBuffer.getNumSamples());
+
+    inputScratch.setSize(numChannels, maxPullInput);
+    outputScratch.setSize(numChannels, maxPullSize);
+    interpolators.resize((size_t)numChannels);
+    for (auto &interpolator : interpolators)
+        interpolator.reset();
+
+    lastPushTicks = juce::Time::getHighResolutionTicks();
+    lastPushSize = 0;
+    isPrimed = false;
+    filteredFill = targetFill;
+    driftEstimate = 0.0;
+
+    publishedDrift = 0.0;
+    publishedFill = 0.0;
+    publishedLock = false;
+    numUnderruns = 0;
+    numOverruns = 0;
+}
+
+void DriftBridge::push(const float *const *channels, int numInputChannels, int numSamples) {
+    auto numToWrite = juce::jmin(numSamples, ringFifo.getFreeSpace());
+    if (numToWrite < numSamples)
+        ++numOverruns;
+
+    int start1, size1, start2, size2;
+    ringFifo.prepareToWrite(numToWrite, start1, size1, start2, size2);
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        if (channel < numInputChannels && channels[channel] != nullptr) {
+            ringBuffer.copyFrom(channel, start1, channels[channel], size1);
+            ringBuffer.copyFrom(channel, start2, channels[channel] + size1, size2);
+        } else {
+            ringBuffer.clear(channel, start1, size1);
+            ringBuffer.clear(channel, start2, size2);
+        }
+    }
+
+    ringFifo.finishedWrite(size1 + size2);
+
+    lastPushSize = numSamples;
+    lastPushTicks = juce::Time::getHighResolutionTicks();
+}
+
+void DriftBridge::pull(float *const *channels, int numOutputChannels, int numSamples) {
+    for (int offset = 0; offset < numSamples; offset += maxPullSize)
+        pullBlock(channels, numOutputChannels, offset, juce::jmin(maxPullSize, numSamples - offset));
+
+    for (int channel = numChannels; channel < numOutputChannels; ++channel)
+        juce::FloatVectorOperations::clear(channels[channel], numSamples);
+}
+
+void DriftBridge::pullBlock(float *const *channels, int numOutputChannels, int offset, int numSamples) {
+    auto numToFill = juce::jmin(numChannels, numOutputChannels);
+    auto clearOutputs = [&] {
+        for (int channel = 0; channel < numToFill; ++channel)
+            juce::FloatVectorOperations::clear(channels[channel] + offset, numSamples);
+    };
+
+    auto numReady = ringFifo.getNumReady();
+
+    if (!isPrimed) {
+        if (numReady < targetFill) {
+            clearOutputs();
+            return;
+        }
+
+        // Start at the target, not with whatever piled up while waiting
+        ringFifo.finishedRead(numReady - targetFill);
+        numReady = targetFill;
+        filteredFill = targetFill;
+        for (auto &interpolator : interpolators)
+            interpolator.reset();
+        isPrimed = true;
+    } else if (numReady > maxFill) {
+        // The output stalled, or the input delivered a burst - drop back to the target to bound the latency
+        ringFifo.finishedRead(numReady - targetFill);
+        numReady = targetFill;
+        filteredFill = targetFill;
+        ++numOverruns;
+    }
+
+    auto ratio = updateControlLoop(numReady, numSamples);
+    auto numNeeded = (int)std::ceil(numSamples * ratio) + 1;
+
+    if (numReady < numNeeded) {
+        // Ran dry - silence until the ring is back at the target
+        ++numUnderruns;
+        isPrimed = false;
+        clearOutputs();
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    ringFifo.prepareToRead(numNeeded, start1, size1, start2, size2);
+
+    // Every channel consumes the same number of samples, as they share the ratio
+    auto numUsed = 0;
+    for (int channel = 0; channel < numChannels; ++channel) {
+        inputScratch.copyFrom(channel, 0, ringBuffer, channel, start1, size1);
+        inputScratch.copyFrom(channel, size1, ringBuffer, channel, start2, size2);
+
+        auto *output = channel < numToFill ? channels[channel] + offset : outputScratch.getWritePointer(channel);
+        numUsed = interpolators[(size_t)channel].process(ratio, inputScratch.getReadPointer(channel), output,
+                                                         numSamples);
+    }
+
+    ringFifo.finishedRead(numUsed);
+}
+
+double DriftBridge::updateControlLoop(int numReady, int numSamples) {
+    // Input blocks arrive whole, but the input's clock runs continuously: count what it captured since the
+    // last block too, so the estimate doesn't follow the block sawtooth
+    auto secondsSincePush =
+        juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - lastPushTicks.load());
+    auto undelivered = juce::jlimit(0.0, (double)lastPushSize.load(), secondsSincePush * inputSampleRate);
+
+    auto blockSeconds = numSamples / outputSampleRate;
+    filteredFill += (numReady + undelivered - filteredFill) * (1.0 - std::exp(-blockSeconds / fillSmoothingSeconds));
+
+    // Too full means the input runs fast: consume more input per output sample
+    auto errorSeconds = (filteredFill - targetFill) / inputSampleRate;
+    driftEstimate =
+        juce::jlimit(-maxCorrection, maxCorrection, driftEstimate + integralGain * errorSeconds * blockSeconds);
+    auto correction = juce::jlimit(-maxCorrection, maxCorrection, driftEstimate + proportionalGain * errorSeconds);
+
+    publishedDrift.store(driftEstimate * 1.0e6, std::memory_order_relaxed);
+    publishedFill.store(filteredFill, std::memory_order_relaxed);
+    publishedLock.store(std::abs(errorSeconds) * 1000.0 < lockToleranceMs, std::memory_order_relaxed);
+
+    return nominalRatio * (1.0 + correction);
+}
+
+//==============================================================================
+DriftBridge::Status DriftBridge::getStatus() const {
+    Status status;
+    if (inputSampleRate <= 0.0)
+        return status;
+
+    auto toMs = 1000.0 / inputSampleRate;
+    status.driftPpm = publishedDrift.load();
+    status.fillMs = publishedFill.load() * toMs;
+    status.targetFillMs = targetFill * toMs;
+    status.latencyMs = status.fillMs + juce::WindowedSincInterpolator::getBaseLatency() * toMs;
+    status.numUnderruns = numUnderruns.load();
+    status.numOverruns = numOverruns.load();
+    status.isLocked = publishedLock.load();
+    return status;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/**
+    Carries audio from a device on one clock to a device on another, e.g. an
+    input and an output that are separate hardware. Two crystals never run at
+    exactly the same rate, so a plain FIFO between them slowly fills up or
+    runs dry and clicks when it does.
+
+    The input side pushes into a lock-free ring; the output side pulls through
+    a windowed sinc resampler whose ratio a control loop adjusts to keep the
+    ring at its target fill. The fill is estimated continuously (the input's
+    samples that were captured but not delivered yet are counted too) and
+    smoothed, and a PI loop turns its error into a ratio correction; the
+    integral term settles on the drift between the two clocks.
+
+    The target is the smallest fill that survives both devices' block sizes
+    plus a small safety margin, so the added latency is about one input block,
+    one output block and the resampler's delay. It's bounded: if the ring gets
+    much fuller than the target (e.g. after the output stalled), the surplus is
+    dropped; if it runs dry, the output is silent until it's back at the
+    target.
+
+    The devices may also run at different nominal rates; the loop only
+    corrects the drift around their ratio.
+*/
+class DriftBridge {
+  public:
+    //==============================================================================
+    DriftBridge() = default;
+
+    // Not while either side runs. Block sizes are the largest each side delivers or asks for.
+    void prepare(int numChannels, double inputSampleRate, int inputBlockSize, double outputSampleRate,
+                 int outputBlockSize);
+
+    // Input device's audio thread. Null channel pointers, and channels beyond numChannels, read as silence.
+    void push(const float *const *channels, int numChannels, int numSamples);
+
+    // Output device's audio thread: numSamples at the output rate into each of the channels. Channels beyond
+    // the bridge's are cleared.
+    void pull(float *const *channels, int numChannels, int numSamples);
+
+    //==============================================================================
+    struct Status {
+        double driftPpm = 0.0;     // How much faster the input's clock runs than the output's, as estimated
+        double fillMs = 0.0;       // Smoothed ring fill
+        double targetFillMs = 0.0;
+        double latencyMs = 0.0;    // Fill plus the resampler's delay
+        juce::int64 numUnderruns = 0; // Times the ring ran dry
+        juce::int64 numOverruns = 0;  // Times samples were dropped to bring the fill back down
+        bool isLocked = false;        // Fill within lockToleranceMs of the target
+    };
+
+    // Any thread
+    Status getStatus() const;
+
+    static constexpr double safetyMarginMs = 2.0;
+    static constexpr double lockToleranceMs = 0.5;
+    static constexpr double maxCorrection = 0.002; // +-2000 ppm, far beyond real clock tolerances
+
+  private:
+    //==============================================================================
+    int numChannels = 0;
+    double inputSampleRate = 0.0;
+    double outputSampleRate = 0.0;
+    double nominalRatio = 1.0; // Input samples per output sample
+    int maxPullSize = 0;       // Output samples resampled in one go - longer pulls are split
+    int targetFill = 0;        // Input samples
+    int maxFill = 0;
+
+    juce::AudioBuffer<float> ringBuffer;
+    juce::AbstractFifo ringFifo{1};
+    std::atomic<juce::int64> lastPushTicks{0};
+    std::atomic<int> lastPushSize{0};
+
+    // Output thread only
+    juce::AudioBuffer<float> inputScratch, outputScratch;
+    std::vector<juce::WindowedSincInterpolator> interpolators;
+    bool isPrimed = false;
+    double filteredFill = 0.0;
+    double driftEstimate = 0.0; // The loop's integral term
+
+    // Published for getStatus()
+    std::atomic<double> publishedDrift{0.0};
+    std::atomic<double> publishedFill{0.0};
+    std::atomic<bool> publishedLock{false};
+    std::atomic<juce::int64> numUnderruns{0};
+    std::atomic<juce::int64> numOverruns{0};
+
+    void pullBlock(float *const *channels, int numOutputChannels, int offset, int numSamples);
+    double updateControlLoop(int numReady, int numSamples);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DriftBridge)
+};
@@ -0,0 +1,334 @@
+#include "JackAudioDevice.h"
+
+#if AUDIOCHAIN_JACK
+
+#include <cerrno>
+
+namespace {
+// Widest layout a JACK device offers, as wide as the pipeline measures
+constexpr int maxJackChannels = 64;
+
+// libjack reports to stderr by default - e.g. on every scan while no server runs
+void logJackError(const char *message) { DBG("JACK: " + juce::String(message)); }
+
+juce::String getPortName(bool isInput, int channel) {
+    return (isInput ? "in_" : "out_") + juce::String(channel + 1);
+}
+} // namespace
+
+//==============================================================================
+JackAudioDevice::JackAudioDevice(const juce::String &deviceName, int numInputChannels, int numOutputChannels,
+                                 double serverSampleRate, int serverBufferSize, bool shouldAutoConnect)
+    : juce::AudioIODevice(deviceName, JackAudioDeviceType::typeName), numDeviceInputs(numInputChannels),
+      numDeviceOutputs(numOutputChannels), autoConnect(shouldAutoConnect), currentSampleRate(serverSampleRate),
+      bufferSize(serverBufferSize) {}
+
+JackAudioDevice::~JackAudioDevice() { close(); }
+
+juce::StringArray JackAudioDevice::getOutputChannelNames() {
+    juce::StringArray names;
+    for (int channel = 0; channel < numDeviceOutputs; ++channel)
+        names.add(getPortName(false, channel));
+    return names;
+}
+
+juce::StringArray JackAudioDevice::getInputChannelNames() {
+    juce::StringArray names;
+    for (int channel = 0; channel < numDeviceInputs; ++channel)
+        names.add(getPortName(true, channel));
+    return names;
+}
+
+// The server's rate only - a client can't change it
+juce::Array<double> JackAudioDevice::getAvailableSampleRates() { return {currentSampleRate}; }
+
+juce::Array<int> JackAudioDevice::getAvailableBufferSizes() {
+    juce::Array<int> sizes;
+    for (int size = minBufferSize; size <= maxBufferSize; size *= 2)
+        sizes.add(size);
+    return sizes;
+}
+
+// The server's current period, so opening with the defaults leaves it alone
+int JackAudioDevice::getDefaultBufferSize() { return bufferSize.load(); }
+
+juce::String JackAudioDevice::open(const juce::BigInteger &inputChannels, const juce::BigInteger &outputChannels,
+                                   double sampleRate, int bufferSizeSamples) {
+    close();
+
+    jack_status_t status;
+    client = jack_client_open(JackAudioDeviceType::clientName, JackNoStartServer, &status);
+    if (client == nullptr) {
+        lastError = (status & JackServerFailed) != 0 ? "No JACK server running" : "Could not connect to JACK";
+        return lastError;
+    }
+
+    currentSampleRate = (double)jack_get_sample_rate(client);
+    if (sampleRate > 0.0 && sampleRate != currentSampleRate)
+        DBG("JACK runs at " + juce::String(currentSampleRate) + " Hz, not " + juce::String(sampleRate));
+
+    // Only the channels the device has
+    activeInputChannels = inputChannels;
+    activeInputChannels.setRange(numDeviceInputs,
+                                 juce::jmax(0, activeInputChannels.getHighestBit() + 1 - numDeviceInputs), false);
+    activeOutputChannels = outputChannels;
+    activeOutputChannels.setRange(numDeviceOutputs,
+                                  juce::jmax(0, activeOutputChannels.getHighestBit() + 1 - numDeviceOutputs), false);
+
+    if (!registerPorts(activeInputChannels, true) || !registerPorts(activeOutputChannels, false)) {
+        close();
+        lastError = "Could not register the JACK ports";
+        return lastError;
+    }
+
+    // Sized here, so the process callback never allocates
+    inputPointers.resize(inputPorts.size());
+    outputPointers.resize(outputPorts.size());
+
+    numXRuns = 0;
+    bufferSize = (int)jack_get_buffer_size(client);
+
+    jack_set_process_callback(client, processCallback, this);
+    jack_set_buffer_size_callback(client, bufferSizeCallback, this);
+    jack_set_xrun_callback(client, xrunCallback, this);
+    jack_on_shutdown(client, shutdownCallback, this);
+
+    // Ports only connect once the client is active; until start() the process callback outputs silence
+    if (jack_activate(client) != 0) {
+        close();
+        lastError = "Could not activate the JACK client";
+        return lastError;
+    }
+
+    // The period is the server's, so asking for another one changes it for every client
+    if (bufferSizeSamples > 0 && bufferSizeSamples != bufferSize.load()) {
+        auto requested = juce::jlimit(minBufferSize, maxBufferSize, juce::nextPowerOfTwo(bufferSizeSamples));
+        if (jack_set_buffer_size(client, (jack_nframes_t)requested) != 0)
+            DBG("JACK refused a period of " + juce::String(requested) + " samples");
+
+        bufferSize = (int)jack_get_buffer_size(client);
+    }
+
+    if (autoConnect)
+        connectToPhysicalPorts();
+
+    DBG("JACK client " + getClientName() + ": " + juce::String(currentSampleRate) + " Hz, " +
+        juce::String(bufferSize.load()) + " samples, " + juce::String((int)inputPorts.size()) + " in, " +
+        juce::String((int)outputPorts.size()) + " out");
+
+    lastError.clear();
+    return {};
+}
+
+void JackAudioDevice::close() {
+    stop();
+
+    if (client != nullptr) {
+        jack_deactivate(client);
+
+        // Unregisters the ports too
+        jack_client_close(client);
+        client = nullptr;
+    }
+
+    inputPorts.clear();
+    outputPorts.clear();
+    inputPointers.clear();
+    outputPointers.clear();
+}
+
+void JackAudioDevice::start(juce::AudioIODeviceCallback *callback) {
+    if (client == nullptr || callback == nullptr || callback == currentCallback)
+        return;
+
+    stop();
+
+    callback->audioDeviceAboutToStart(this);
+    {
+        const juce::ScopedLock lock(callbackLock);
+        preparedBufferSize = bufferSize.load();
+        currentCallback = callback;
+    }
+}
+
+void JackAudioDevice::stop() {
+    juce::AudioIODeviceCallback *previousCallback = nullptr;
+    {
+        const juce::ScopedLock lock(callbackLock);
+        std::swap(previousCallback, currentCallback);
+    }
+
+    if (previousCallback != nullptr)
+        previousCallback->audioDeviceStopped();
+}
+
+juce::String JackAudioDevice::getClientName() const {
+    return client != nullptr ? juce::String(jack_get_client_name(client)) : juce::String();
+}
+
+//==============================================================================
+int JackAudioDevice::processCallback(jack_nframes_t numFrames, void *device) {
+    static_cast<JackAudioDevice *>(device)->process((int)numFrames);
+    return 0;
+}
+
+int JackAudioDevice::bufferSizeCallback(jack_nframes_t numFrames, void *device) {
+    static_cast<JackAudioDevice *>(device)->bufferSize = (int)numFrames;
+    return 0;
+}
+
+int JackAudioDevice::xrunCallback(void *device) {
+    ++static_cast<JackAudioDevice *>(device)->numXRuns;
+    return 0;
+}
+
+void JackAudioDevice::shutdownCallback(void *device) {
+    // The server is gone - the client stays open, silent, until close()
+    auto &self = *static_cast<JackAudioDevice *>(device);
+    const juce::ScopedLock lock(self.callbackLock);
+    if (self.currentCallback != nullptr)
+        self.currentCallback->audioDeviceError("The JACK server shut down");
+}
+
+void JackAudioDevice::process(int numFrames) {
+    for (size_t i = 0; i < inputPorts.size(); ++i)
+        inputPointers[i] = static_cast<const float *>(jack_port_get_buffer(inputPorts[i], (jack_nframes_t)numFrames));
+    for (size_t i = 0; i < outputPorts.size(); ++i)
+        outputPointers[i] = static_cast<float *>(jack_port_get_buffer(outputPorts[i], (jack_nframes_t)numFrames));
+
+    const juce::ScopedLock lock(callbackLock);
+
+    if (currentCallback == nullptr) {
+        for (auto *output : outputPointers)
+            juce::FloatVectorOperations::clear(output, numFrames);
+        return;
+    }
+
+    // A period longer than the callback was prepared for goes through in several blocks
+    auto blockSize = preparedBufferSize > 0 ? preparedBufferSize : numFrames;
+
+    for (int offset = 0; offset < numFrames; offset += blockSize) {
+        auto numSamples = juce::jmin(blockSize, numFrames - offset);
+
+        if (offset > 0) {
+            for (auto &input : inputPointers)
+                input += blockSize;
+            for (auto &output : outputPointers)
+                output += blockSize;
+        }
+
+        currentCallback->audioDeviceIOCallbackWithContext(inputPointers.data(), (int)inputPointers.size(),
+                                                          outputPointers.data(), (int)outputPointers.size(),
+                                                          numSamples, {});
+    }
+}
+
+bool JackAudioDevice::registerPorts(const juce::BigInteger &channels, bool isInput) {
+    auto &ports = isInput ? inputPorts : outputPorts;
+    auto flags = isInput ? JackPortIsInput : JackPortIsOutput;
+
+    for (int channel = channels.findNextSetBit(0); channel >= 0; channel = channels.findNextSetBit(channel + 1)) {
+        auto *port = jack_port_register(client, getPortName(isInput, channel).toRawUTF8(), JACK_DEFAULT_AUDIO_TYPE,
+                                        (unsigned long)flags, 0);
+        if (port == nullptr)
+            return false;
+
+        ports.push_back(port);
+    }
+
+    return true;
+}
+
+void JackAudioDevice::connectToPhysicalPorts() {
+    // Physical capture ports are outputs from the server's side, playback ports inputs
+    auto connect = [this](const std::vector<jack_port_t *> &ports, bool isInput) {
+        auto physicalFlags = JackPortIsPhysical | (isInput ? JackPortIsOutput : JackPortIsInput);
+        auto **physicalPorts =
+            jack_get_ports(client, nullptr, JACK_DEFAULT_AUDIO_TYPE, (unsigned long)physicalFlags);
+        if (physicalPorts == nullptr)
+            return;
+
+        for (size_t i = 0; i < ports.size() && physicalPorts[i] != nullptr; ++i) {
+            auto *portName = jack_port_name(ports[i]);
+            auto result = isInput ? jack_connect(client, physicalPorts[i], portName)
+                                  : jack_connect(client, portName, physicalPorts[i]);
+            if (result != 0 && result != EEXIST)
+                DBG("Could not connect " + juce::String(portName) + " to " + juce::String(physicalPorts[i]));
+        }
+
+        jack_free(physicalPorts);
+    };
+
+    connect(inputPorts, true);
+    connect(outputPorts, false);
+}
+
+int JackAudioDevice::getPortLatency(const std::vector<jack_port_t *> &ports, bool isCapture) const {
+    if (client == nullptr || ports.empty())
+        return 0;
+
+    // The latency between the port and the hardware, as the server and the clients in between report it
+    jack_latency_range_t range{0, 0};
+    jack_port_get_latency_range(ports.front(), isCapture ? JackCaptureLatency : JackPlaybackLatency, &range);
+    return (int)range.max;
+}
+
+//==============================================================================
+JackAudioDeviceType::JackAudioDeviceType() : juce::AudioIODeviceType(typeName) {
+    jack_set_error_function(logJackError);
+    jack_set_info_function(logJackError);
+}
+
+void JackAudioDeviceType::scanForDevices() {
+    isServerRunning = false;
+    numPhysicalInputs = numPhysicalOutputs = 0;
+
+    // A client that's never activated: just asks the server for its physical ports, without starting one
+    jack_status_t status;
+    auto *client = jack_client_open(clientName, JackNoStartServer, &status);
+    if (client == nullptr) {
+        DBG("No JACK server running");
+        return;
+    }
+
+    auto countPorts = [client](unsigned long flags) {
+        auto numPorts = 0;
+        if (auto **ports = jack_get_ports(client, nullptr, JACK_DEFAULT_AUDIO_TYPE, JackPortIsPhysical | flags)) {
+            while (ports[numPorts] != nullptr)
+                ++numPorts;
+            jack_free(ports);
+        }
+        return numPorts;
+    };
+
+    numPhysicalInputs = countPorts(JackPortIsOutput);
+    numPhysicalOutputs = countPorts(JackPortIsInput);
+    serverSampleRate = (double)jack_get_sample_rate(client);
+    serverBufferSize = (int)jack_get_buffer_size(client);
+    jack_client_close(client);
+
+    isServerRunning = true;
+}
+
+juce::StringArray JackAudioDeviceType::getDeviceNames(bool) const {
+    if (!isServerRunning)
+        return {};
+    return {deviceName};
+}
+
+int JackAudioDeviceType::getIndexOfDevice(juce::AudioIODevice *device, bool) const {
+    return dynamic_cast<JackAudioDevice *>(device) != nullptr ? 0 : -1;
+}
+
+juce::AudioIODevice *JackAudioDeviceType::createDevice(const juce::String &outputDeviceName,
+                                                       const juce::String &inputDeviceName) {
+    if (!isServerRunning || (outputDeviceName != deviceName && inputDeviceName != deviceName))
+        return nullptr;
+
+    // Servers without hardware, e.g. with the dummy driver's defaults, still get a stereo device
+    return new JackAudioDevice(deviceName, juce::jlimit(2, maxJackChannels, numPhysicalInputs),
+                               juce::jlimit(2, maxJackChannels, numPhysicalOutputs), serverSampleRate,
+                               serverBufferSize, autoConnect);
+}
+
+#endif
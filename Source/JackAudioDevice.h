@@ -0,0 +1,141 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_core/juce_core.h>
+
+#if AUDIOCHAIN_JACK
+
+#include <jack/jack.h>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/**
+    A client of a running JACK server - jackd, or PipeWire through its JACK
+    API. The chain runs directly in the server's process callback, on its
+    real-time thread, with no buffering in between.
+
+    The sample rate is the server's. The block size is the server's period,
+    which is shared by every client: open() asks the server for the one
+    requested (rounded up to a power of two) and takes what it gets. Should
+    another client grow the period later, the cycles are split into blocks
+    of the size the callback was prepared for.
+
+    Every active channel is a port, "in_1", "out_1" and so on, so the chain
+    can be routed with any JACK patchbay. With auto-connect on, the ports are
+    also connected to the physical capture and playback ports in order.
+*/
+class JackAudioDevice : public juce::AudioIODevice {
+  public:
+    //==============================================================================
+    // The server's rate and period as last scanned; open() reads them again
+    JackAudioDevice(const juce::String &deviceName, int numInputChannels, int numOutputChannels,
+                    double serverSampleRate, int serverBufferSize, bool autoConnect);
+    ~JackAudioDevice() override;
+
+    juce::StringArray getOutputChannelNames() override;
+    juce::StringArray getInputChannelNames() override;
+    juce::Array<double> getAvailableSampleRates() override;
+    juce::Array<int> getAvailableBufferSizes() override;
+    int getDefaultBufferSize() override;
+
+    juce::String open(const juce::BigInteger &inputChannels, const juce::BigInteger &outputChannels, double sampleRate,
+                      int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override { return client != nullptr; }
+    void start(juce::AudioIODeviceCallback *callback) override;
+    void stop() override;
+    bool isPlaying() override { return currentCallback != nullptr; }
+    juce::String getLastError() override { return lastError; }
+
+    int getCurrentBufferSizeSamples() override { return bufferSize.load(); }
+    double getCurrentSampleRate() override { return currentSampleRate; }
+    int getCurrentBitDepth() override { return 32; }
+    juce::BigInteger getActiveOutputChannels() const override { return activeOutputChannels; }
+    juce::BigInteger getActiveInputChannels() const override { return activeInputChannels; }
+    int getOutputLatencyInSamples() override { return getPortLatency(outputPorts, false); }
+    int getInputLatencyInSamples() override { return getPortLatency(inputPorts, true); }
+    int getXRunCount() const noexcept override { return numXRuns.load(); }
+
+    //==============================================================================
+    // The name the server gave the client - the requested one, unless another client had it already
+    juce::String getClientName() const;
+
+    static constexpr int minBufferSize = 16;
+    static constexpr int maxBufferSize = 4096;
+
+  private:
+    //==============================================================================
+    const int numDeviceInputs, numDeviceOutputs;
+    const bool autoConnect;
+
+    jack_client_t *client = nullptr;
+    juce::String lastError;
+    double currentSampleRate;
+    std::atomic<int> bufferSize;
+    int preparedBufferSize = 0; // The block size the callback was started with
+    juce::BigInteger activeInputChannels, activeOutputChannels;
+
+    // One port per active channel, and the process callback's channel pointers into their buffers
+    std::vector<jack_port_t *> inputPorts, outputPorts;
+    std::vector<const float *> inputPointers;
+    std::vector<float *> outputPointers;
+
+    juce::CriticalSection callbackLock;
+    juce::AudioIODeviceCallback *currentCallback = nullptr;
+
+    std::atomic<int> numXRuns{0};
+
+    // JACK's callbacks, on the server's threads
+    static int processCallback(jack_nframes_t numFrames, void *device);
+    static int bufferSizeCallback(jack_nframes_t numFrames, void *device);
+    static int xrunCallback(void *device);
+    static void shutdownCallback(void *device);
+
+    void process(int numFrames);
+    bool registerPorts(const juce::BigInteger &channels, bool isInput);
+    void connectToPhysicalPorts();
+    int getPortLatency(const std::vector<jack_port_t *> &ports, bool isCapture) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JackAudioDevice)
+};
+
+//==============================================================================
+/**
+    Device type with one device, "JACK Server", listed while a server is
+    running. Scanning never starts a server; the device's channels are as
+    many as the server has physical ports, and at least two.
+*/
+class JackAudioDeviceType : public juce::AudioIODeviceType {
+  public:
+    //==============================================================================
+    JackAudioDeviceType();
+
+    // Whether devices created from now on connect their ports to the physical ones. On by default.
+    void setAutoConnect(bool shouldConnect) { autoConnect = shouldConnect; }
+
+    void scanForDevices() override;
+    juce::StringArray getDeviceNames(bool wantInputNames) const override;
+    int getDefaultDeviceIndex(bool) const override { return 0; }
+    int getIndexOfDevice(juce::AudioIODevice *device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override { return false; }
+    juce::AudioIODevice *createDevice(const juce::String &outputDeviceName,
+                                      const juce::String &inputDeviceName) override;
+
+    static constexpr const char *typeName = "JACK";
+    static constexpr const char *deviceName = "JACK Server";
+    static constexpr const char *clientName = "AudioChain";
+
+  private:
+    //==============================================================================
+    bool isServerRunning = false;
+    int numPhysicalInputs = 0, numPhysicalOutputs = 0;
+    double serverSampleRate = 0.0;
+    int serverBufferSize = 0;
+    bool autoConnect = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JackAudioDeviceType)
+};
+
+#endif
@@ -0,0 +1,215 @@
+#include "LoudnessMeter.h"
+#include "SignalKernels.h"
+
+//==============================================================================
+LoudnessMeter::LoudnessMeter() : truePeakFilter(createTruePeakFilter()) {}
+
+void LoudnessMeter::prepare(double sampleRate, int channels) {
+    numChannels = channels;
+
+    // BS.1770 channel weights: surrounds count 1.41x, the LFE of a 5.1 layout not at all
+    channelWeights.assign((size_t)numChannels, 1.0f);
+    if (numChannels == 6) {
+        channelWeights[3] = 0.0f;
+        channelWeights[4] = channelWeights[5] = 1.41f;
+    }
+
+    kWeighting.resize((size_t)numChannels);
+    stepSums.assign((size_t)numChannels, 0.0);
+    stepPowers.assign((size_t)numShortTermSteps, 0.0);
+    truePeaks.assign((size_t)numChannels, 0.0f);
+
+    auto numHistogramBins = (int)((histogramMaximum - absoluteGate) / histogramResolution);
+    blockHistogram.assign((size_t)numHistogramBins, 0);
+    histogramPowers.assign((size_t)numHistogramBins, 0.0);
+
+    truePeakInput.setSize(numChannels, tapsPerPhase - 1 + maxTruePeakBlock);
+    oversampled.resize((size_t)maxTruePeakBlock);
+
+    // K-weighting filters for any sample rate, from the analogue prototypes of BS.1770
+    auto shelfK = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+    auto shelfQ = 0.7071752369554196;
+    auto shelfVh = std::pow(10.0, 3.999843853973347 / 20.0);
+    auto shelfVb = std::pow(shelfVh, 0.4996667741545416);
+    auto shelfA0 = 1.0 + shelfK / shelfQ + shelfK * shelfK;
+
+    Biquad shelf;
+    shelf.b0 = (float)((shelfVh + shelfVb * shelfK / shelfQ + shelfK * shelfK) / shelfA0);
+    shelf.b1 = (float)(2.0 * (shelfK * shelfK - shelfVh) / shelfA0);
+    shelf.b2 = (float)((shelfVh - shelfVb * shelfK / shelfQ + shelfK * shelfK) / shelfA0);
+    shelf.a1 = (float)(2.0 * (shelfK * shelfK - 1.0) / shelfA0);
+    shelf.a2 = (float)((1.0 - shelfK / shelfQ + shelfK * shelfK) / shelfA0);
+
+    auto highPassK = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+    auto highPassQ = 0.5003270373238773;
+    auto highPassA0 = 1.0 + highPassK / highPassQ + highPassK * highPassK;
+
+    Biquad highPass;
+    highPass.b0 = 1.0f;
+    highPass.b1 = -2.0f;
+    highPass.b2 = 1.0f;
+    highPass.a1 = (float)(2.0 * (highPassK * highPassK - 1.0) / highPassA0);
+    highPass.a2 = (float)((1.0 - highPassK / highPassQ + highPassK * highPassK) / highPassA0);
+
+    for (auto &filters : kWeighting)
+        filters = {shelf, highPass};
+
+    stepSize = juce::roundToInt(sampleRate * 0.1);
+    filtered.resize((size_t)stepSize);
+
+    reset();
+}
+
+void LoudnessMeter::reset() {
+    for (auto &filters : kWeighting)
+        for (auto &filter : filters)
+            filter.z1 = filter.z2 = 0.0f;
+
+    samplesInStep = 0;
+    std::fill(stepSums.begin(), stepSums.end(), 0.0);
+    std::fill(stepPowers.begin(), stepPowers.end(), 0.0);
+    stepPosition = 0;
+    numStepsFilled = 0;
+
+    std::fill(blockHistogram.begin(), blockHistogram.end(), 0u);
+    std::fill(histogramPowers.begin(), histogramPowers.end(), 0.0);
+    momentaryLoudness = shortTermLoudness = integratedLoudness = minimumLoudness;
+
+    truePeakInput.clear();
+    std::fill(truePeaks.begin(), truePeaks.end(), 0.0f);
+}
+
+//==============================================================================
+void LoudnessMeter::process(const float *const *channels, int numSamples) {
+    measureTruePeaks(channels, numSamples);
+
+    for (int offset = 0; offset < numSamples;) {
+        auto numToProcess = juce::jmin(numSamples - offset, stepSize - samplesInStep);
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto &filters = kWeighting[(size_t)channel];
+            auto *input = channels[channel] + offset;
+
+            for (int i = 0; i < numToProcess; ++i)
+                filtered[(size_t)i] = filters[1].processSample(filters[0].processSample(input[i]));
+
+            SignalKernels::Levels levels;
+            SignalKernels::measureLevels(filtered.data(), numToProcess, levels);
+            stepSums[(size_t)channel] += levels.sumOfSquares;
+        }
+
+        samplesInStep += numToProcess;
+        offset += numToProcess;
+
+        if (samplesInStep == stepSize)
+            finishStep();
+    }
+}
+
+void LoudnessMeter::measureTruePeaks(const float *const *channels, int numSamples) {
+    constexpr auto historySize = tapsPerPhase - 1;
+
+    for (int offset = 0; offset < numSamples; offset += maxTruePeakBlock) {
+        auto blockSize = juce::jmin(maxTruePeakBlock, numSamples - offset);
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto *input = truePeakInput.getWritePointer(channel);
+            juce::FloatVectorOperations::copy(input + historySize, channels[channel] + offset, blockSize);
+
+            // Each phase is a sum of shifted copies of the input, one vector multiply-add per tap
+            auto peak = truePeaks[(size_t)channel];
+            for (const auto &phase : truePeakFilter) {
+                juce::FloatVectorOperations::clear(oversampled.data(), blockSize);
+                for (int tap = 0; tap < tapsPerPhase; ++tap)
+                    juce::FloatVectorOperations::addWithMultiply(oversampled.data(), input + historySize - tap,
+                                                                 phase[(size_t)tap], blockSize);
+
+                auto range = juce::FloatVectorOperations::findMinAndMax(oversampled.data(), blockSize);
+                peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+            }
+            truePeaks[(size_t)channel] = peak;
+
+            // Keep the end of the block for the next one
+            std::memmove(input, input + blockSize, sizeof(float) * historySize);
+        }
+    }
+}
+
+void LoudnessMeter::finishStep() {
+    auto power = 0.0;
+    for (int channel = 0; channel < numChannels; ++channel) {
+        power += channelWeights[(size_t)channel] * stepSums[(size_t)channel] / stepSize;
+        stepSums[(size_t)channel] = 0.0;
+    }
+
+    samplesInStep = 0;
+    stepPowers[(size_t)stepPosition] = power;
+    stepPosition = (stepPosition + 1) % numShortTermSteps;
+    numStepsFilled = juce::jmin(numStepsFilled + 1, numShortTermSteps);
+
+    auto getMeanPower = [this](int numSteps) {
+        auto sum = 0.0;
+        for (int step = 1; step <= numSteps; ++step)
+            sum += stepPowers[(size_t)((stepPosition - step + numShortTermSteps) % numShortTermSteps)];
+        return sum / numSteps;
+    };
+
+    // Until there's a full window, measure what there is
+    auto momentaryPower = getMeanPower(juce::jmin(numStepsFilled, numMomentarySteps));
+    momentaryLoudness = powerToLoudness(momentaryPower);
+    shortTermLoudness = powerToLoudness(getMeanPower(numStepsFilled));
+
+    // Gating blocks are 400 ms with 75% overlap - a momentary measurement every step
+    if (numStepsFilled >= numMomentarySteps && momentaryLoudness >= absoluteGate) {
+        auto bin = juce::jlimit(0, (int)blockHistogram.size() - 1,
+                                (int)((momentaryLoudness - absoluteGate) / histogramResolution));
+        ++blockHistogram[(size_t)bin];
+        histogramPowers[(size_t)bin] += momentaryPower;
+        updateIntegratedLoudness();
+    }
+}
+
+void LoudnessMeter::updateIntegratedLoudness() {
+    auto getGatedPower = [this](size_t firstBin) {
+        auto sum = 0.0;
+        juce::uint64 numBlocks = 0;
+        for (auto bin = firstBin; bin < blockHistogram.size(); ++bin) {
+            sum += histogramPowers[bin];
+            numBlocks += blockHistogram[bin];
+        }
+        return numBlocks > 0 ? sum / (double)numBlocks : 0.0;
+    };
+
+    // Relative gate: 10 LU below the loudness of the blocks above the absolute gate
+    auto threshold = powerToLoudness(getGatedPower(0)) + relativeGate;
+    auto firstBin = (size_t)juce::jmax(0, (int)std::ceil((threshold - absoluteGate) / histogramResolution - 0.5f));
+
+    auto gatedPower = getGatedPower(firstBin);
+    integratedLoudness = gatedPower > 0.0 ? powerToLoudness(gatedPower) : minimumLoudness;
+}
+
+//==============================================================================
+LoudnessMeter::PolyphaseFilter LoudnessMeter::createTruePeakFilter() {
+    // Windowed sinc interpolator with the 48 tap, 4 phase structure of BS.1770 annex 2
+    constexpr auto numTaps = tapsPerPhase * oversampling;
+    constexpr auto centre = (numTaps - 1) * 0.5;
+
+    PolyphaseFilter filter;
+    for (int tap = 0; tap < numTaps; ++tap) {
+        auto x = (tap - centre) / oversampling;
+        auto sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) /
+                                                     (juce::MathConstants<double>::pi * x);
+
+        // Blackman window
+        auto phase = juce::MathConstants<double>::twoPi * (tap + 0.5) / numTaps;
+        auto window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+
+        filter[(size_t)(tap % oversampling)][(size_t)(tap / oversampling)] = (float)(sinc * window);
+    }
+
+    return filter;
+}
+
+float LoudnessMeter::powerToLoudness(double power) {
+    return power > 0.0 ? juce::jmax(minimumLoudness, (float)(-0.691 + 10.0 * std::log10(power))) : minimumLoudness;
+}
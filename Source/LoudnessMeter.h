@@ -0,0 +1,111 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+/**
+    EBU R128 / ITU-R BS.1770 loudness and true-peak meter.
+
+    - Momentary (400 ms), short-term (3 s) and integrated loudness in LUFS.
+      Integrated loudness uses the absolute (-70 LUFS) and relative (-10 LU)
+      gates, from a histogram of 0.1 LU bins (the gates are applied per bin, the
+      power is summed exactly), so it can run for hours without storing blocks
+      or allocating.
+    - True peak per channel: 4x oversampled with a 48 tap polyphase FIR, held
+      at the maximum since the last reset.
+
+    The K-weighting filters run sample by sample per channel (they're
+    recursive); the mean squares (SignalKernels::measureLevels) and the
+    oversampling filter are computed as vector operations over whole blocks.
+
+    Everything is sized for the channel count in prepare(), so processing never
+    allocates. Not thread safe - the AudioAnalyser runs it on its analysis thread.
+*/
+class LoudnessMeter {
+  public:
+    //==============================================================================
+    LoudnessMeter();
+
+    // Not real-time safe
+    void prepare(double sampleRate, int numChannels);
+
+    // Clears the integrated loudness and the held true peaks
+    void reset();
+
+    void process(const float *const *channels, int numSamples);
+
+    float getMomentaryLoudness() const { return momentaryLoudness; }
+    float getShortTermLoudness() const { return shortTermLoudness; }
+    float getIntegratedLoudness() const { return integratedLoudness; }
+    float getTruePeak(int channel) const { return truePeaks[(size_t)channel]; } // Gain
+
+    // Reported while nothing above the absolute gate has been measured
+    static constexpr float minimumLoudness = -100.0f;
+
+  private:
+    //==============================================================================
+    struct Biquad {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float z1 = 0.0f, z2 = 0.0f;
+
+        float processSample(float input) {
+            auto output = b0 * input + z1;
+            z1 = b1 * input - a1 * output + z2;
+            z2 = b2 * input - a2 * output;
+            return output;
+        }
+    };
+
+    int numChannels = 0;
+    std::vector<float> channelWeights;
+
+    // K-weighting: high shelf, then high pass, per channel
+    std::vector<std::array<Biquad, 2>> kWeighting;
+    std::vector<float> filtered;
+
+    // Mean squares per 100 ms step, for the last 3 s
+    int stepSize = 4800;
+    int samplesInStep = 0;
+    std::vector<double> stepSums;
+    std::vector<double> stepPowers; // Weighted channel sum per step, circular
+    int stepPosition = 0;
+    int numStepsFilled = 0;
+
+    // Gating blocks of the integrated loudness, by loudness: count and summed power per bin
+    std::vector<juce::uint32> blockHistogram;
+    std::vector<double> histogramPowers;
+
+    float momentaryLoudness = minimumLoudness;
+    float shortTermLoudness = minimumLoudness;
+    float integratedLoudness = minimumLoudness;
+
+    // True peak: previous input samples followed by the current block, per channel
+    juce::AudioBuffer<float> truePeakInput;
+    std::vector<float> oversampled;
+    std::vector<float> truePeaks;
+
+    static constexpr int numMomentarySteps = 4;
+    static constexpr int numShortTermSteps = 30;
+    static constexpr float absoluteGate = -70.0f;
+    static constexpr float relativeGate = -10.0f;
+    static constexpr float histogramMaximum = 5.0f;
+    static constexpr float histogramResolution = 0.1f;
+
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int maxTruePeakBlock = 1024;
+    using PolyphaseFilter = std::array<std::array<float, tapsPerPhase>, oversampling>;
+    const PolyphaseFilter truePeakFilter;
+    static PolyphaseFilter createTruePeakFilter();
+
+    void measureTruePeaks(const float *const *channels, int numSamples);
+    void finishStep();
+    void updateIntegratedLoudness();
+
+    static float powerToLoudness(double power);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
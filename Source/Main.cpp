@@ -1,4 +1,6 @@
+#include "CommandLineTools.h"
 #include "MainComponent.h"
+#include "StartupProfiler.h"
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
 #include <juce_graphics/juce_graphics.h>
@@ -17,7 +19,21 @@ class AudioChainApplication : public juce::JUCEApplication {
     //==============================================================================
     void initialise(const juce::String &commandLine) override {
         // This method is where you should put your application's initialisation code..
-        mainWindow.reset(new MainWindow(getApplicationName()));
+        if (CommandLineTools::handlesCommandLine(commandLine)) {
+            // Headless mode - no window, quit as soon as it's done
+            setApplicationReturnValue(CommandLineTools::run(commandLine));
+            quit();
+            return;
+        }
+
+        StartupProfiler::getInstance().addMilestone("Application initialise");
+
+        {
+            StartupProfiler::ScopedPhase phase("Create main window");
+            mainWindow.reset(new MainWindow(getApplicationName()));
+        }
+
+        StartupProfiler::getInstance().addMilestone("Main window visible");
     }
 
     void shutdown() override {
@@ -52,7 +68,10 @@ class AudioChainApplication : public juce::JUCEApplication {
                              DocumentWindow::minimiseButton | DocumentWindow::maximiseButton) {
             setUsingNativeTitleBar(false);
             setTitleBarHeight(0); // Hide the title bar completely
-            setContentOwned(new MainComponent(), true);
+            {
+                StartupProfiler::ScopedPhase phase("Create MainComponent");
+                setContentOwned(new MainComponent(), true);
+            }
 
 #if JUCE_IOS || JUCE_ANDROID
             setFullScreen(true);
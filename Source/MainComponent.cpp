@@ -8,27 +8,46 @@ MainComponent::MainComponent() {
     setLookAndFeel(&darkLookAndFeel);
 
     // Initialize core components first - test each one individually
-    DBG("Creating AudioInputManager...");
-    audioInputManager = std::make_unique<AudioInputManager>();
-    DBG("AudioInputManager created successfully");
+    {
+        StartupProfiler::ScopedPhase phase("Create AudioInputManager");
+        DBG("Creating AudioInputManager...");
+        audioInputManager = std::make_unique<AudioInputManager>();
+        DBG("AudioInputManager created successfully");
+    }
 
-    DBG("Creating AudioProcessor...");
-    audioProcessor = std::make_unique<AudioProcessor>();
-    DBG("AudioProcessor created successfully");
+    {
+        StartupProfiler::ScopedPhase phase("Create AudioProcessor");
+        DBG("Creating AudioProcessor...");
+        audioProcessor = std::make_unique<AudioProcessor>();
+        DBG("AudioProcessor created successfully");
+    }
 
-    DBG("Creating UserConfig...");
-    userConfig = std::make_unique<UserConfig>();
-    DBG("UserConfig created successfully");
+    {
+        StartupProfiler::ScopedPhase phase("Create PluginHost");
+        DBG("Creating PluginHost...");
+        pluginHost = std::make_unique<PluginHost>();
+        DBG("PluginHost created successfully");
+    }
 
-    DBG("Creating PluginHost...");
-    pluginHost = std::make_unique<PluginHost>();
-    pluginHost->setUserConfig(userConfig.get());
-    DBG("PluginHost created successfully");
+    {
+        StartupProfiler::ScopedPhase phase("Create PluginChainComponent");
+        DBG("Creating PluginChainComponent...");
+        pluginChainComponent = std::make_unique<PluginChainComponent>(*pluginHost);
+        DBG("PluginChainComponent created successfully");
+    }
 
-    DBG("Creating PluginChainComponent...");
-    pluginChainComponent = std::make_unique<PluginChainComponent>(*pluginHost);
-    pluginChainComponent->getPluginBrowser()->setUserConfig(userConfig.get());
-    DBG("PluginChainComponent created successfully");
+    // The device callback, registered while processing is on
+    audioPipeline = std::make_unique<AudioPipeline>(*pluginHost, *audioProcessor,
+                                                    audioInputManager->getInputTelemetry(),
+                                                    audioInputManager->getOutputTelemetry());
+    audioPipeline->setBridgedInputs(&audioInputManager->getBridgedInputs());
+    audioPipeline->onDeviceStarted = [this](double sampleRate, int bufferSize) {
+        audioInputManager->setSampleRate(sampleRate);
+        audioInputManager->setBufferSize(bufferSize);
+    };
+
+    stereoFieldComponent = std::make_unique<StereoFieldComponent>(*audioProcessor);
+    spectrogramComponent = std::make_unique<SpectrogramComponent>(audioProcessor->getSpectrogram());
 
     // Initialize UI components - this is required for setupLayout to work
     DBG("Adding UI components to view...");
@@ -43,6 +62,8 @@ MainComponent::MainComponent() {
     addAndMakeVisible(leftLevelLabel);
     addAndMakeVisible(rightLevelLabel);
     addAndMakeVisible(*pluginChainComponent);
+    addAndMakeVisible(*stereoFieldComponent);
+    addAndMakeVisible(*spectrogramComponent);
     DBG("UI components added successfully");
 
     // Set basic text for components with modern styling
@@ -145,11 +166,9 @@ MainComponent::MainComponent() {
     // Start timer for status updates
     startTimer(100);
 
-    // Populate device list after a short delay to ensure everything is initialized
-    juce::Timer::callAfterDelay(500, [this]() {
-        DBG("Populating device list...");
-        updateInputDeviceList();
-    });
+    // Config and plugin cache loading run in the background while the message thread opens the
+    // devices - each one signals when it's ready instead of waiting for a fixed delay
+    startBootstrap();
 
     DBG("MainComponent constructor finished");
 
@@ -171,154 +190,36 @@ MainComponent::MainComponent() {
 MainComponent::~MainComponent() {
     stopTimer();
 
-    // Remove ourselves as audio callback and stop processing
-    if (audioInputManager && isProcessingActive) {
-        audioInputManager->getAudioDeviceManager().removeAudioCallback(this);
-        audioInputManager->stop();
-
-        if (audioProcessor)
-            audioProcessor->stop();
-    }
-
-    // Clean up custom LookAndFeel
-    setLookAndFeel(nullptr);
-}
-
-//==============================================================================
-// AudioIODeviceCallback implementation
-void MainComponent::audioDeviceIOCallbackWithContext(const float *const *inputChannelData, int numInputChannels,
-                                                     float *const *outputChannelData, int numOutputChannels,
-                                                     int numSamples,
-                                                     const juce::AudioIODeviceCallbackContext &context) {
-    static int callbackCount = 0;
-    if (++callbackCount % 1000 == 0) // Log every 1000 callbacks to avoid spam
-    {
-        DBG("Audio callback #" + juce::String(callbackCount) + " - Input channels: " + juce::String(numInputChannels) +
-            ", Output channels: " + juce::String(numOutputChannels) + ", Samples: " + juce::String(numSamples) +
-            ", inputChannelData: " + juce::String(inputChannelData ? "valid" : "null") +
-            ", isProcessingActive: " + juce::String(isProcessingActive ? "true" : "false"));
-    }
-
-    // Clear output buffers first
-    for (int channel = 0; channel < numOutputChannels; ++channel) {
-        if (outputChannelData[channel])
-            juce::FloatVectorOperations::clear(outputChannelData[channel], numSamples);
-    }
-
-    // Update input levels for metering
-    if (audioInputManager && isProcessingActive && inputChannelData) {
-        audioInputManager->updateInputLevels(inputChannelData, numInputChannels, numSamples);
-
-        // Debug: Check if we actually have audio signal every 2000 callbacks
-        if (callbackCount % 2000 == 0) {
-            float maxSample = 0.0f;
-            float sumSamples = 0.0f;
-            int nonZeroSamples = 0;
-
-            for (int channel = 0; channel < numInputChannels; ++channel) {
-                if (inputChannelData[channel]) {
-                    for (int sample = 0; sample < numSamples; ++sample) {
-                        float sampleValue = inputChannelData[channel][sample];
-                        float absSample = std::abs(sampleValue);
-                        maxSample = juce::jmax(maxSample, absSample);
-                        sumSamples += absSample;
-                        if (absSample > 0.000001f)
-                            nonZeroSamples++;
-
-                        // Log first few samples for debugging
-                        if (sample < 5 && channel == 0) {
-                            DBG("Sample[" + juce::String(sample) + "] = " + juce::String(sampleValue, 8));
-                        }
-                    }
-                } else {
-                    DBG("Channel " + juce::String(channel) + " inputChannelData is NULL!");
-                }
-            }
-
-            float averageLevel =
-                (numInputChannels * numSamples > 0) ? sumSamples / (numInputChannels * numSamples) : 0.0f;
+    // Bootstrap jobs use our members, so they must be finished before anything is destroyed. Each
+    // one ends by itself, so there's no timeout - giving up would leave them running into freed memory.
+    bootstrapPool.removeAllJobs(false, -1);
 
-            DBG("Audio analysis - Max: " + juce::String(maxSample, 6) + " (" +
-                juce::String(juce::Decibels::gainToDecibels(maxSample, -60.0f), 1) + "dB)" +
-                ", Avg: " + juce::String(averageLevel, 6) + ", Non-zero samples: " + juce::String(nonZeroSamples) +
-                "/" + juce::String(numInputChannels * numSamples));
-        }
-    }
+    // Include anything that happened after the bootstrap (first audio callback) in the trace
+    StartupProfiler::getInstance().writeTrace();
 
-    // Process audio if we're active (removed numOutputChannels > 0 requirement since we have 0 output channels)
-    if (isProcessingActive && inputChannelData && numInputChannels > 0) {
-        // Create a temporary buffer for processing - ensure we have at least 2 channels for stereo processing
-        int processingChannels = juce::jmax(juce::jmax(numInputChannels, numOutputChannels), 2);
-        juce::AudioBuffer<float> processingBuffer(processingChannels, numSamples);
+    // Finish any autosave in flight before the final save writes the same file
+    sessionAutosaver.reset();
 
-        // Copy input to processing buffer
-        for (int channel = 0; channel < numInputChannels && channel < processingBuffer.getNumChannels(); ++channel) {
-            if (inputChannelData[channel]) {
-                processingBuffer.copyFrom(channel, 0, inputChannelData[channel], numSamples);
-            }
-        }
-
-        // Handle mono-to-stereo conversion: if we only have 1 input channel, duplicate it to channel 1
-        if (numInputChannels == 1 && processingBuffer.getNumChannels() >= 2) {
-            if (inputChannelData[0]) {
-                processingBuffer.copyFrom(1, 0, inputChannelData[0], numSamples);
-                DBG("Duplicating mono input to stereo for processing");
-            }
-        }
-
-        // Process through VST plugins
-        if (pluginHost) {
-            pluginHost->processAudio(processingBuffer);
-        }
-
-        // Process through our audio processor
-        if (audioProcessor) {
-            audioProcessor->processAudio(processingBuffer);
-        }
-
-        // Copy processed audio to output
-        for (int channel = 0; channel < numOutputChannels && channel < processingBuffer.getNumChannels(); ++channel) {
-            if (outputChannelData[channel]) {
-                juce::FloatVectorOperations::copy(outputChannelData[channel], processingBuffer.getReadPointer(channel),
-                                                  numSamples);
-            }
-        }
+    // Remember the plugin chain for the next launch (unless the last one never got restored)
+    if (pluginHost && userConfig && !pluginHost->isSessionRestorePending()) {
+        userConfig->saveSession(pluginHost->getState());
     }
-}
 
-void MainComponent::audioDeviceAboutToStart(juce::AudioIODevice *device) {
-    DBG("Audio device about to start: " + device->getName());
-
-    double sampleRate = device->getCurrentSampleRate();
-    int bufferSize = device->getCurrentBufferSizeSamples();
-
-    // Prepare audio processor
-    if (audioProcessor) {
-        audioProcessor->prepareToPlay(bufferSize, sampleRate);
-    }
+    // With the session written, states that neither it nor any preset uses can go
+    if (userConfig)
+        userConfig->removeUnusedPluginStates();
 
-    // Prepare plugin host
-    if (pluginHost) {
-        pluginHost->prepareToPlay(bufferSize, sampleRate);
-    }
+    // Remove the pipeline as audio callback and stop processing
+    if (audioInputManager && isProcessingActive) {
+        audioInputManager->getAudioDeviceManager().removeAudioCallback(audioPipeline.get());
+        audioInputManager->stop();
 
-    // Configure audio input manager
-    if (audioInputManager) {
-        audioInputManager->setSampleRate(sampleRate);
-        audioInputManager->setBufferSize(bufferSize);
+        if (audioProcessor)
+            audioProcessor->stop();
     }
 
-    DBG("Audio prepared - Sample rate: " + juce::String(sampleRate) + ", Buffer size: " + juce::String(bufferSize));
-}
-
-void MainComponent::audioDeviceStopped() {
-    DBG("Audio device stopped");
-
-    if (audioProcessor)
-        audioProcessor->releaseResources();
-
-    if (pluginHost)
-        pluginHost->releaseResources();
+    // Clean up custom LookAndFeel
+    setLookAndFeel(nullptr);
 }
 
 //==============================================================================
@@ -402,8 +303,13 @@ void MainComponent::paint(juce::Graphics &g) {
     }
 
     // Enhanced level meters with modern styling
-    drawEnhancedLevelMeter(g, leftMeterBounds, audioInputManager ? audioInputManager->getInputLevel(0) : 0.0f);
-    drawEnhancedLevelMeter(g, rightMeterBounds, audioInputManager ? audioInputManager->getInputLevel(1) : 0.0f);
+    // A mono input shows on both meters
+    auto getInputPeak = [this](int channel) {
+        channel = juce::jmin(channel, inputTelemetry.numChannels - 1);
+        return channel >= 0 ? inputTelemetry.channels[(size_t)channel].peak : 0.0f;
+    };
+    drawEnhancedLevelMeter(g, leftMeterBounds, getInputPeak(0));
+    drawEnhancedLevelMeter(g, rightMeterBounds, getInputPeak(1));
 }
 
 void MainComponent::drawEnhancedLevelMeter(juce::Graphics &g, const juce::Rectangle<int> &bounds, float level) {
@@ -679,9 +585,17 @@ void MainComponent::setupLayout() {
 
     auto levelMeterArea = contentArea.removeFromRight(80); // Reserve space for level meters
 
+    // Spectrogram history along the bottom
+    spectrogramComponent->setBounds(contentArea.removeFromBottom(100));
+    contentArea.removeFromBottom(5);
+
     // Plugin chain area (remaining space)
     pluginChainComponent->setBounds(contentArea);
 
+    // Goniometer and correlation meter below the level meters
+    stereoFieldComponent->setBounds(levelMeterArea.removeFromBottom(levelMeterArea.getWidth() + 20));
+    levelMeterArea.removeFromBottom(10);
+
     // Center the level meters in the available space
     auto meterWidth = 25;                                                  // Width of each meter
     auto meterSpacing = 10;                                                // Space between meters
@@ -749,20 +663,56 @@ void MainComponent::timerCallback() {
     leftLevelLabel.setText("L", juce::dontSendNotification);
     rightLevelLabel.setText("R", juce::dontSendNotification);
 
+    if (audioInputManager) {
+        audioInputManager->getInputTelemetry().getSnapshot(inputTelemetry);
+        audioInputManager->getOutputTelemetry().getSnapshot(outputTelemetry);
+        reportNonFiniteSamples();
+        updateBridgeStatus();
+    }
+
     // Repaint to update level meters and status indicator
     repaint();
 }
 
+void MainComponent::reportNonFiniteSamples() {
+    auto numInput = inputTelemetry.getNumNonFinite();
+    auto numOutput = outputTelemetry.getNumNonFinite();
+
+    if (numInput != reportedNonFiniteInput || numOutput != reportedNonFiniteOutput) {
+        DBG("Non-finite samples - input: " + juce::String(numInput) + ", output: " + juce::String(numOutput));
+        reportedNonFiniteInput = numInput;
+        reportedNonFiniteOutput = numOutput;
+    }
+}
+
+// Drift and latency of inputs bridged from other clocks, next to the input label
+void MainComponent::updateBridgeStatus() {
+    juce::StringArray bridges;
+    for (const auto &status : audioInputManager->getBridgedInputs().getStatus()) {
+        bridges.add(juce::String(status.bridge.driftPpm, 1) + " ppm, " + juce::String(status.bridge.latencyMs, 1) +
+                    " ms" + (status.bridge.isLocked ? "" : " (locking)"));
+    }
+
+    auto text = bridges.isEmpty() ? juce::String("Input Device:")
+                                  : "Input Device: bridged " + bridges.joinIntoString(" | ");
+    inputDeviceLabel.setText(text, juce::dontSendNotification);
+}
+
 // Status is now shown via visual indicator circle
 
 void MainComponent::updateInputDeviceList() {
+    if (audioInputManager) {
+        updateInputDeviceList(audioInputManager->getAvailableInputDevices(),
+                              audioInputManager->getAvailableOutputDevices());
+    }
+}
+
+void MainComponent::updateInputDeviceList(const juce::StringArray &inputDevices, const juce::StringArray &outputDevices) {
     inputDeviceComboBox.clear();
     outputDeviceComboBox.clear();
 
     if (audioInputManager) {
         // Populate input devices
-        auto inputDevices = audioInputManager->getAvailableInputDevices();
-
         for (int i = 0; i < inputDevices.size(); ++i) {
             inputDeviceComboBox.addItem(inputDevices[i], i + 1);
         }
@@ -787,8 +737,6 @@ void MainComponent::updateInputDeviceList() {
         }
 
         // Populate output devices
-        auto outputDevices = audioInputManager->getAvailableOutputDevices();
-
         for (int i = 0; i < outputDevices.size(); ++i) {
             outputDeviceComboBox.addItem(outputDevices[i], i + 1);
         }
@@ -800,13 +748,108 @@ void MainComponent::updateInputDeviceList() {
     }
 }
 
+//==============================================================================
+// Startup
+void MainComponent::startBootstrap() {
+    juce::Component::SafePointer<MainComponent> safeThis(this);
+    pendingBootstrapJobs = 3;
+
+    // Config and last session, loaded into locals and handed over on the message thread. The holder
+    // deletes the config if the component is gone by then.
+    bootstrapPool.addJob([safeThis] {
+        auto config = std::make_shared<std::unique_ptr<UserConfig>>();
+        juce::ValueTree session;
+        {
+            StartupProfiler::ScopedPhase phase("Load config and session");
+            *config = std::make_unique<UserConfig>();
+            session = (*config)->loadSession();
+        }
+
+        juce::MessageManager::callAsync([safeThis, config, session] {
+            if (auto *component = safeThis.getComponent()) {
+                component->userConfig = std::move(*config);
+                component->sessionToRestore = session;
+                component->pluginHost->setUserConfig(component->userConfig.get());
+                component->pluginChainComponent->setUserConfig(component->userConfig.get());
+                component->bootstrapJobFinished();
+            }
+        });
+    });
+
+    // Plugin shell cache, so the session restore scan can skip unchanged plugins
+    bootstrapPool.addJob([this, safeThis] {
+        {
+            StartupProfiler::ScopedPhase phase("Load plugin cache");
+            pluginHost->loadScanCache();
+        }
+
+        juce::MessageManager::callAsync([safeThis] {
+            if (auto *component = safeThis.getComponent())
+                component->bootstrapJobFinished();
+        });
+    });
+
+    // Device types are created, scanned and opened on the message thread - the device manager
+    // scans every type again when it opens one, and some types need the thread that created them
+    // for hot-plug notifications. This runs while the jobs above load the config and plugin cache.
+    juce::MessageManager::callAsync([safeThis] {
+        if (auto *component = safeThis.getComponent()) {
+            juce::StringArray inputDevices, outputDevices;
+            {
+                StartupProfiler::ScopedPhase phase("Enumerate and open audio devices");
+                if (component->audioInputManager->initialiseDevices()) {
+                    inputDevices = component->audioInputManager->getAvailableInputDevices();
+                    outputDevices = component->audioInputManager->getAvailableOutputDevices();
+                }
+
+                DBG("Populating device list...");
+                component->updateInputDeviceList(inputDevices, outputDevices);
+            }
+
+            // Time to audio ends here, with the device open - processing waits for the user to start it
+            if (component->audioInputManager->getAudioDeviceManager().getCurrentAudioDevice() != nullptr)
+                StartupProfiler::getInstance().addAudioReadyMilestone();
+            else
+                StartupProfiler::getInstance().addMilestone("No audio device opened");
+
+            component->bootstrapJobFinished();
+        }
+    });
+}
+
+void MainComponent::bootstrapJobFinished() {
+    if (--pendingBootstrapJobs > 0)
+        return;
+
+    StartupProfiler::getInstance().addMilestone("Bootstrap complete");
+
+    // A complete, up to date cache (e.g. from a headless --scan-plugins run) replaces the scan entirely
+    {
+        StartupProfiler::ScopedPhase phase("Load plugin catalog from cache");
+        pluginHost->loadCatalogFromCache();
+    }
+
+    // Restore the last session - its plugins are scanned first, so the chain comes back early
+    pluginHost->onSessionRestored = [] {
+        StartupProfiler::getInstance().addMilestone("Session restored");
+        StartupProfiler::getInstance().writeTrace();
+    };
+    pluginHost->restoreState(sessionToRestore);
+    sessionToRestore = {};
+
+    // Autosave skips its checks until the restore above has completed
+    sessionAutosaver = std::make_unique<SessionAutosaver>(*pluginHost, userConfig->getSessionFile());
+
+    StartupProfiler::getInstance().writeTrace();
+}
+
 //==============================================================================
 void MainComponent::toggleProcessing() {
     if (isProcessingActive) {
         // Stop processing
-        // Remove ourselves as the audio callback
+        // Remove the pipeline as the audio callback
         if (audioInputManager) {
-            audioInputManager->getAudioDeviceManager().removeAudioCallback(this);
+            audioInputManager->getAudioDeviceManager().removeAudioCallback(audioPipeline.get());
             audioInputManager->stop();
         }
 
@@ -827,8 +870,8 @@ void MainComponent::toggleProcessing() {
         }
 
         if (audioInputManager->start()) {
-            // Add ourselves as the audio callback
-            audioInputManager->getAudioDeviceManager().addAudioCallback(this);
+            // Add the pipeline as the audio callback
+            audioInputManager->getAudioDeviceManager().addAudioCallback(audioPipeline.get());
 
             isProcessingActive = true;
             processingToggleButton.setToggleState(true, juce::dontSendNotification);
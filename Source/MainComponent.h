@@ -1,10 +1,15 @@
 #pragma once
 
 #include "AudioInputManager.h"
+#include "AudioPipeline.h"
 #include "AudioProcessor.h"
 #include "PluginChainComponent.h"
 #include "UserConfig.h"
 #include "PluginHost.h"
+#include "SessionAutosaver.h"
+#include "StartupProfiler.h"
+#include "SpectrogramComponent.h"
+#include "StereoFieldComponent.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_audio_utils/juce_audio_utils.h>
@@ -199,21 +204,12 @@ class DarkLookAndFeel : public juce::LookAndFeel_V4 {
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent : public juce::Component, public juce::Timer, public juce::AudioIODeviceCallback {
+class MainComponent : public juce::Component, public juce::Timer {
   public:
     //==============================================================================
     MainComponent();
     ~MainComponent() override;
 
-    //==============================================================================
-    // AudioIODeviceCallback implementation
-    void audioDeviceIOCallbackWithContext(const float *const *inputChannelData, int numInputChannels,
-                                          float *const *outputChannelData, int numOutputChannels, int numSamples,
-                                          const juce::AudioIODeviceCallbackContext &context) override;
-
-    void audioDeviceAboutToStart(juce::AudioIODevice *device) override;
-    void audioDeviceStopped() override;
-
     //==============================================================================
     void paint(juce::Graphics &g) override;
     void resized() override;
@@ -240,11 +236,16 @@ class MainComponent : public juce::Component, public juce::Timer, public juce::A
     // VST3 Plugin Host
     std::unique_ptr<PluginHost> pluginHost;
 
+    // Device callback: input -> plugins -> audio processor -> output
+    std::unique_ptr<AudioPipeline> audioPipeline;
+
     // User Configuration
     std::unique_ptr<UserConfig> userConfig;
 
     // UI Components
     std::unique_ptr<PluginChainComponent> pluginChainComponent;
+    std::unique_ptr<StereoFieldComponent> stereoFieldComponent;
+    std::unique_ptr<SpectrogramComponent> spectrogramComponent;
 
     // Controls
     juce::ComboBox inputDeviceComboBox;
@@ -260,6 +261,10 @@ class MainComponent : public juce::Component, public juce::Timer, public juce::A
     juce::Label leftLevelLabel;
     juce::Label rightLevelLabel;
 
+    // Device boundary telemetry, copied by the timer; non-finite sample totals already logged
+    TelemetrySnapshot inputTelemetry, outputTelemetry;
+    juce::int64 reportedNonFiniteInput = 0, reportedNonFiniteOutput = 0;
+
     // Status
     bool isProcessingActive = false;
 
@@ -276,9 +281,24 @@ class MainComponent : public juce::Component, public juce::Timer, public juce::A
     juce::Rectangle<int> titleBounds; // For engraved title effect
     juce::ComponentDragger windowDragger;
 
+    // Startup - config and plugin cache load on the bootstrap pool while the message thread opens the devices
+    juce::ThreadPool bootstrapPool{2};
+    int pendingBootstrapJobs = 0;
+    juce::ValueTree sessionToRestore;
+
+    // Saves the chain in the background as it changes, started once the last session is restored
+    std::unique_ptr<SessionAutosaver> sessionAutosaver;
+
+    void startBootstrap();
+    void bootstrapJobFinished();
+
     // Layout
     void setupLayout();
     void updateInputDeviceList();
+    void updateInputDeviceList(const juce::StringArray &inputDevices, const juce::StringArray &outputDevices);
+
+    void reportNonFiniteSamples();
+    void updateBridgeStatus();
 
     // Enhanced visual methods
     void drawEnhancedLevelMeter(juce::Graphics &g, const juce::Rectangle<int> &bounds, float level);
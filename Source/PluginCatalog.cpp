@@ -0,0 +1,146 @@
+#include "PluginCatalog.h"
+
+//==============================================================================
+// View Implementation
+//==============================================================================
+PluginCatalog::View::View(std::shared_ptr<const Generation> generationToView)
+    : generation(std::move(generationToView)) {
+    if (generation != nullptr) {
+        // Records below these counts are fully published and never change
+        numRecords = generation->records.size();
+        numShells = generation->shells.size();
+    }
+}
+
+const PluginCatalog::Record &PluginCatalog::View::operator[](int index) const noexcept {
+    jassert(juce::isPositiveAndBelow(index, numRecords));
+    return generation->records[index];
+}
+
+int PluginCatalog::View::indexOfIdentifier(const juce::String &identifier) const {
+    if (generation == nullptr)
+        return -1;
+
+    const juce::ScopedReadLock lock(generation->indexLock);
+
+    auto it = generation->identifierIndex.find(identifier);
+    if (it != generation->identifierIndex.end() && it->second < numRecords)
+        return it->second;
+
+    return -1;
+}
+
+const PluginCatalog::Record *PluginCatalog::View::findByIdentifier(const juce::String &identifier) const {
+    auto index = indexOfIdentifier(identifier);
+    return index >= 0 ? &generation->records[index] : nullptr;
+}
+
+const PluginCatalog::Record *PluginCatalog::View::findByPath(const juce::String &fileOrIdentifier) const {
+    if (generation == nullptr)
+        return nullptr;
+
+    const juce::ScopedReadLock lock(generation->indexLock);
+
+    auto it = generation->pathIndex.find(fileOrIdentifier);
+    if (it != generation->pathIndex.end() && it->second < numRecords)
+        return &generation->records[it->second];
+
+    return nullptr;
+}
+
+juce::Array<int> PluginCatalog::View::findByUniqueId(int uniqueId) const {
+    juce::Array<int> indices;
+
+    if (generation == nullptr)
+        return indices;
+
+    const juce::ScopedReadLock lock(generation->indexLock);
+
+    auto range = generation->uniqueIdIndex.equal_range(uniqueId);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second < numRecords)
+            indices.add(it->second);
+    }
+
+    return indices;
+}
+
+std::shared_ptr<const PluginCatalog::ShellRecord> PluginCatalog::View::getShell(int shellIndex) const {
+    if (generation == nullptr || !juce::isPositiveAndBelow(shellIndex, numShells))
+        return nullptr;
+
+    return generation->shells[shellIndex];
+}
+
+//==============================================================================
+// PluginCatalog Implementation
+//==============================================================================
+PluginCatalog::PluginCatalog() { clear(); }
+
+PluginCatalog::~PluginCatalog() = default;
+
+PluginCatalog::View PluginCatalog::getView() const { return View(getCurrentGeneration()); }
+
+std::shared_ptr<PluginCatalog::Generation> PluginCatalog::getCurrentGeneration() const {
+    return std::atomic_load(&currentGeneration);
+}
+
+//==============================================================================
+void PluginCatalog::clear() {
+    const juce::ScopedLock lock(writeLock);
+
+    auto generation = std::make_shared<Generation>();
+    generation->number = nextGenerationNumber++;
+
+    // Views of the previous generation keep it (and its strings) alive until released
+    std::atomic_store(&currentGeneration, generation);
+    stringPool.garbageCollect();
+
+    ++changeCount;
+}
+
+int PluginCatalog::addShell(ShellRecord shell) {
+    const juce::ScopedLock lock(writeLock);
+
+    shell.file = intern(shell.file);
+    shell.formatName = intern(shell.formatName);
+    shell.architectureString = intern(shell.architectureString);
+
+    auto index = currentGeneration->shells.add(std::make_shared<const ShellRecord>(std::move(shell)));
+    ++changeCount;
+    return index;
+}
+
+int PluginCatalog::addRecord(Record record) {
+    const juce::ScopedLock lock(writeLock);
+
+    record.name = intern(record.name);
+    record.manufacturer = intern(record.manufacturer);
+    record.version = intern(record.version);
+    record.formatName = intern(record.formatName);
+    record.fileOrIdentifier = intern(record.fileOrIdentifier);
+    record.identifier = intern(record.identifier);
+    record.architectureString = intern(record.architectureString);
+
+    auto &generation = *currentGeneration;
+
+    // Index before publishing: lookups ignore indices beyond a view's record count
+    auto index = generation.records.size();
+    {
+        const juce::ScopedWriteLock indexLock(generation.indexLock);
+        generation.identifierIndex.emplace(record.identifier, index);
+        generation.pathIndex.emplace(record.fileOrIdentifier, index); // First plugin of a shell wins
+        if (record.uniqueId != 0)
+            generation.uniqueIdIndex.emplace(record.uniqueId, index);
+    }
+
+    auto addedIndex = generation.records.add(std::move(record));
+    jassert(addedIndex == index || addedIndex < 0);
+
+    ++changeCount;
+    return addedIndex;
+}
+
+juce::String PluginCatalog::intern(const juce::String &text) {
+    return text.isEmpty() ? juce::String() : stringPool.getPooledString(text);
+}
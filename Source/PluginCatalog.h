@@ -0,0 +1,190 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+//==============================================================================
+/**
+    Catalog of scanned plugins, shared between the scanner, the plugin browser
+    and the plugin loader.
+
+    - Strings are interned in a string pool, so records only hold pointers and
+      repeated manufacturers/formats/versions are stored once
+    - Records are compact and immutable once published; the full
+      juce::PluginDescription is kept as shared cold data
+    - Hash indexes by identifier, path and unique ID
+    - Readers take a View, which is copy-free and stays valid while a scan keeps
+      appending records or starts a new generation
+
+    The catalog has its own locks and never touches the audio processing lock.
+    There is a single writer at a time (the scanner); any number of readers.
+*/
+class PluginCatalog {
+  public:
+    //==============================================================================
+    // Parent record shared by every plugin exposed by the same file or bundle
+    struct ShellRecord {
+        juce::String file;
+        juce::String formatName;
+        juce::String architectureString;
+        int numPlugins = 0;
+    };
+
+    //==============================================================================
+    struct Record {
+        enum Flags : juce::uint8 {
+            instrumentFlag = 1 << 0,
+            editorFlag = 1 << 1,
+            is64BitFlag = 1 << 2,
+            compatibleFlag = 1 << 3
+        };
+
+        // Interned strings - each is a single pointer into the catalog string pool
+        juce::String name;
+        juce::String manufacturer;
+        juce::String version;
+        juce::String formatName;
+        juce::String fileOrIdentifier;
+        juce::String identifier;
+        juce::String architectureString;
+
+        // Full description for loading (cold data, shared with loaded instances)
+        std::shared_ptr<const juce::PluginDescription> description;
+
+        int uniqueId = 0;
+        int shell = -1; // Index of the parent ShellRecord
+        juce::uint16 shellIndex = 0;
+        juce::uint16 numInputChannels = 0;
+        juce::uint16 numOutputChannels = 0;
+        juce::uint8 flags = 0;
+
+        bool isInstrument() const noexcept { return (flags & instrumentFlag) != 0; }
+        bool hasEditor() const noexcept { return (flags & editorFlag) != 0; }
+        bool is64Bit() const noexcept { return (flags & is64BitFlag) != 0; }
+        bool isCompatible() const noexcept { return (flags & compatibleFlag) != 0; }
+    };
+
+  private:
+    //==============================================================================
+    // Append-only storage with stable element addresses. A single writer appends,
+    // readers may access any index below size() without locking.
+    template <typename ElementType> class AppendOnlyArray {
+      public:
+        AppendOnlyArray() = default;
+        ~AppendOnlyArray() {
+            for (auto &chunk : chunks)
+                delete[] chunk.load(std::memory_order_relaxed);
+        }
+
+        int size() const noexcept { return numElements.load(std::memory_order_acquire); }
+
+        const ElementType &operator[](int index) const noexcept {
+            auto *chunk = chunks[(size_t)(index / chunkSize)].load(std::memory_order_acquire);
+            return chunk[index % chunkSize];
+        }
+
+        int add(ElementType element) {
+            auto index = numElements.load(std::memory_order_relaxed);
+            auto chunkIndex = (size_t)(index / chunkSize);
+
+            if (chunkIndex >= maxChunks) {
+                jassertfalse; // Catalog is full
+                return -1;
+            }
+
+            auto *chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+            if (chunk == nullptr) {
+                chunk = new ElementType[chunkSize];
+                chunks[chunkIndex].store(chunk, std::memory_order_release);
+            }
+
+            chunk[index % chunkSize] = std::move(element);
+            numElements.store(index + 1, std::memory_order_release);
+            return index;
+        }
+
+      private:
+        static constexpr int chunkSize = 256;
+        static constexpr size_t maxChunks = 1024;
+
+        std::array<std::atomic<ElementType *>, maxChunks> chunks{};
+        std::atomic<int> numElements{0};
+
+        JUCE_DECLARE_NON_COPYABLE(AppendOnlyArray)
+    };
+
+    //==============================================================================
+    // One scan's worth of records. Replaced as a whole when a rescan starts, so
+    // existing views keep reading the generation they were created from.
+    struct Generation {
+        juce::uint32 number = 0;
+        AppendOnlyArray<Record> records;
+        AppendOnlyArray<std::shared_ptr<const ShellRecord>> shells;
+
+        mutable juce::ReadWriteLock indexLock;
+        std::unordered_map<juce::String, int> identifierIndex;
+        std::unordered_map<juce::String, int> pathIndex;
+        std::unordered_multimap<int, int> uniqueIdIndex;
+    };
+
+  public:
+    //==============================================================================
+    // Copy-free, consistent read view of the catalog
+    class View {
+      public:
+        View() = default;
+
+        int size() const noexcept { return numRecords; }
+        bool isEmpty() const noexcept { return numRecords == 0; }
+        const Record &operator[](int index) const noexcept;
+
+        int indexOfIdentifier(const juce::String &identifier) const;
+        const Record *findByIdentifier(const juce::String &identifier) const;
+        const Record *findByPath(const juce::String &fileOrIdentifier) const;
+        juce::Array<int> findByUniqueId(int uniqueId) const;
+
+        std::shared_ptr<const ShellRecord> getShell(int shellIndex) const;
+
+        // Identifies the scan generation this view was taken from
+        juce::uint32 getGeneration() const noexcept { return generation != nullptr ? generation->number : 0; }
+
+      private:
+        friend class PluginCatalog;
+        View(std::shared_ptr<const Generation> generationToView);
+
+        std::shared_ptr<const Generation> generation;
+        int numRecords = 0;
+        int numShells = 0;
+    };
+
+    //==============================================================================
+    PluginCatalog();
+    ~PluginCatalog();
+
+    View getView() const;
+
+    // Writer interface
+    void clear(); // Starts a new, empty generation
+    int addShell(ShellRecord shell);
+    int addRecord(Record record);
+
+    // Bumped on every change, so readers can cheaply poll for updates
+    juce::uint32 getChangeCount() const noexcept { return changeCount.load(); }
+
+  private:
+    //==============================================================================
+    std::shared_ptr<Generation> currentGeneration;
+    juce::StringPool stringPool;
+    juce::CriticalSection writeLock;
+    std::atomic<juce::uint32> changeCount{0};
+    juce::uint32 nextGenerationNumber = 1;
+
+    std::shared_ptr<Generation> getCurrentGeneration() const;
+    juce::String intern(const juce::String &text);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginCatalog)
+};
@@ -1,4 +1,6 @@
 #include "PluginChainComponent.h"
+#include "PluginStateStore.h"
+#include "SessionFile.h"
 
 //==============================================================================
 PluginChainComponent::PluginChainComponent(PluginHost &pluginHost_) : pluginHost(pluginHost_) {
@@ -41,9 +43,71 @@ PluginChainComponent::PluginChainComponent(PluginHost &pluginHost_) : pluginHost
     // Apply dark theme to label
     chainLabel.setColour(juce::Label::textColourId, juce::Colours::white);
 
+    // Snapshot controls
+    addAndMakeVisible(snapshotSelector);
+    addAndMakeVisible(storeSnapshotButton);
+    addAndMakeVisible(loadSnapshotButton);
+    addAndMakeVisible(removeSnapshotButton);
+
+    storeSnapshotButton.setButtonText("Store");
+    storeSnapshotButton.setTooltip("Store the chain as a snapshot");
+    loadSnapshotButton.setButtonText("Load");
+    loadSnapshotButton.setTooltip("Load a saved session as a snapshot, ready to switch to");
+    removeSnapshotButton.setButtonText("Delete");
+    removeSnapshotButton.setTooltip("Delete the selected snapshot - an active one's plugins stay in the chain");
+
+    for (auto *button : {&storeSnapshotButton, &loadSnapshotButton, &removeSnapshotButton}) {
+        button->setColour(juce::TextButton::buttonColourId, juce::Colour(0xff2d2d2d));
+        button->setColour(juce::TextButton::buttonOnColourId, juce::Colour(0xff404040));
+        button->setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+        button->setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+    }
+
+    // Presets
+    addAndMakeVisible(presetsButton);
+    presetsButton.setButtonText("Presets");
+    presetsButton.setTooltip("Save the chain as a preset, or load one");
+    presetsButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff2d2d2d));
+    presetsButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(0xff404040));
+    presetsButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    presetsButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+
+    // Slot meters
+    addAndMakeVisible(slotMetersButton);
+    slotMetersButton.setButtonText("Meters");
+    slotMetersButton.setTooltip("Show levels going into and coming out of each plugin");
+    slotMetersButton.setClickingTogglesState(true);
+    slotMetersButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff2d2d2d));
+    slotMetersButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(0xff00a86b));
+    slotMetersButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    slotMetersButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+
+    // Slot guards
+    addAndMakeVisible(slotGuardsButton);
+    slotGuardsButton.setButtonText("Guard");
+    slotGuardsButton.setTooltip("Replace NaN, infinite and denormal samples each plugin outputs with silence");
+    slotGuardsButton.setClickingTogglesState(true);
+    slotGuardsButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff2d2d2d));
+    slotGuardsButton.setColour(juce::TextButton::buttonOnColourId, juce::Colour(0xff00a86b));
+    slotGuardsButton.setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    slotGuardsButton.setColour(juce::TextButton::textColourOnId, juce::Colours::white);
+
+    snapshotSelector.setTextWhenNothingSelected("No snapshot");
+    snapshotSelector.setTextWhenNoChoicesAvailable("No snapshots stored");
+    snapshotSelector.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff2d2d2d));
+    snapshotSelector.setColour(juce::ComboBox::textColourId, juce::Colours::white);
+    snapshotSelector.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff404040));
+
     // Button callbacks
     addPluginButton.onClick = [this] { showPluginBrowser(); };
     clearAllButton.onClick = [this] { pluginHost.clearAllPlugins(); };
+    storeSnapshotButton.onClick = [this] { storeSnapshot(); };
+    loadSnapshotButton.onClick = [this] { loadSnapshot(); };
+    removeSnapshotButton.onClick = [this] { removeSelectedSnapshot(); };
+    presetsButton.onClick = [this] { showPresetMenu(); };
+    snapshotSelector.onChange = [this] { switchToSelectedSnapshot(); };
+    slotMetersButton.onClick = [this] { updateSlotMetering(); };
+    slotGuardsButton.onClick = [this] { updateSlotGuards(); };
 
     // Setup plugin browser (initially hidden)
     pluginBrowser = std::make_unique<PluginBrowser>(pluginHost);
@@ -84,6 +148,13 @@ void PluginChainComponent::resized() {
     chainLabel.setBounds(controlArea.removeFromLeft(120));
     addPluginButton.setBounds(controlArea.removeFromLeft(100).reduced(2));
     clearAllButton.setBounds(controlArea.removeFromLeft(80).reduced(2));
+    slotMetersButton.setBounds(controlArea.removeFromLeft(70).reduced(2));
+    slotGuardsButton.setBounds(controlArea.removeFromLeft(70).reduced(2));
+    presetsButton.setBounds(controlArea.removeFromLeft(70).reduced(2));
+    removeSnapshotButton.setBounds(controlArea.removeFromRight(60).reduced(2));
+    loadSnapshotButton.setBounds(controlArea.removeFromRight(60).reduced(2));
+    storeSnapshotButton.setBounds(controlArea.removeFromRight(60).reduced(2));
+    snapshotSelector.setBounds(controlArea.removeFromRight(220).reduced(2));
 
     // Chain area (remaining space) - now uses viewport
     chainArea = area.reduced(10);
@@ -109,6 +180,12 @@ void PluginChainComponent::timerCallback() {
     //     float level = 0.0f; // Replace with actual level data
     //     levelMeters[i]->setLevel(level);
     // }
+
+    if (slotMetersButton.getToggleState()) {
+        for (auto *slot : pluginSlots)
+            if (slot->hasPlugin())
+                slot->updateLevels();
+    }
 }
 
 //==============================================================================
@@ -139,6 +216,10 @@ void PluginChainComponent::refreshPluginChain() {
         }
     }
 
+    // New plugins get metered and guarded too
+    updateSlotMetering();
+    updateSlotGuards();
+
     // Update container layout
     if (chainContainer) {
         chainContainer->updateSlots();
@@ -201,7 +282,145 @@ void PluginChainComponent::onEditorWindowClosed(int slotIndex) {
     juce::MessageManager::callAsync([this, slotIndex]() { closePluginEditor(slotIndex); });
 }
 
-void PluginChainComponent::onPluginChainChanged() { refreshPluginChain(); }
+void PluginChainComponent::onPluginChainChanged() {
+    refreshPluginChain();
+    refreshSnapshotList();
+}
+
+//==============================================================================
+void PluginChainComponent::storeSnapshot() {
+    pluginHost.storeSnapshot("Snapshot " + juce::String(pluginHost.getNumSnapshots() + 1));
+    refreshSnapshotList();
+}
+
+void PluginChainComponent::loadSnapshot() {
+    snapshotChooser = std::make_unique<juce::FileChooser>(
+        "Load Session as Snapshot", juce::File::getSpecialLocation(juce::File::userDocumentsDirectory), "*.acsn;*.xml");
+
+    snapshotChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                 [this](const juce::FileChooser &fc) {
+                                     auto file = fc.getResult();
+                                     if (file.existsAsFile()) {
+                                         auto state = SessionFile::read(file, &PluginStateStore::getInstance());
+                                         if (state.hasType("PluginChain")) {
+                                             pluginHost.addSnapshot(file.getFileNameWithoutExtension(), state);
+                                             refreshSnapshotList();
+                                         } else {
+                                             DBG("Not a session file: " + file.getFullPathName());
+                                         }
+                                     }
+                                     snapshotChooser.reset();
+                                 });
+}
+
+void PluginChainComponent::setUserConfig(UserConfig *config) {
+    userConfig = config;
+    pluginBrowser->setUserConfig(config);
+}
+
+void PluginChainComponent::showPresetMenu() {
+    if (userConfig == nullptr)
+        return;
+
+    auto presetNames = userConfig->getPresetNames();
+
+    juce::PopupMenu loadMenu, snapshotMenu, deleteMenu;
+    for (const auto &name : presetNames) {
+        loadMenu.addItem(name, [this, name] {
+            auto chain = userConfig->loadPreset(name);
+            if (chain.isValid())
+                pluginHost.setState(chain);
+        });
+        snapshotMenu.addItem(name, [this, name] {
+            auto chain = userConfig->loadPreset(name);
+            if (chain.isValid()) {
+                pluginHost.addSnapshot(name, chain);
+                refreshSnapshotList();
+            }
+        });
+        deleteMenu.addItem(name, [this, name] { userConfig->deletePreset(name); });
+    }
+
+    juce::PopupMenu menu;
+    menu.addItem("Save Chain as Preset...", pluginHost.getNumPlugins() > 0, false, [this] { saveChainAsPreset(); });
+    menu.addSeparator();
+    menu.addSubMenu("Load", loadMenu, !presetNames.isEmpty());
+    menu.addSubMenu("Load as Snapshot", snapshotMenu, !presetNames.isEmpty());
+    menu.addSubMenu("Delete", deleteMenu, !presetNames.isEmpty());
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&presetsButton));
+}
+
+void PluginChainComponent::saveChainAsPreset() {
+    auto *window = new juce::AlertWindow("Save Preset", "Name of the preset:", juce::AlertWindow::NoIcon);
+    window->addTextEditor("name", "Preset " + juce::String(userConfig->getPresetNames().size() + 1));
+    window->addButton("Save", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    window->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+    window->enterModalState(true, juce::ModalCallbackFunction::create([this, window](int result) {
+                                if (result == 1 && userConfig != nullptr) {
+                                    auto name = window->getTextEditorContents("name");
+                                    if (!userConfig->savePreset(name, pluginHost.getState()))
+                                        DBG("Failed to save preset '" + name + "'");
+                                }
+                            }),
+                            true);
+}
+
+void PluginChainComponent::removeSelectedSnapshot() {
+    auto index = snapshotSelector.getSelectedId() - 1;
+    if (index < 0)
+        return;
+
+    pluginHost.removeSnapshot(index);
+    refreshSnapshotList();
+}
+
+void PluginChainComponent::updateSlotMetering() {
+    auto showLevels = slotMetersButton.getToggleState();
+
+    for (int i = 0; i < pluginSlots.size(); ++i) {
+        auto *slot = pluginSlots[i];
+        slot->setLevelsVisible(showLevels && slot->hasPlugin());
+
+        if (slot->hasPlugin())
+            pluginHost.setSlotMeteringEnabled(i, showLevels);
+    }
+}
+
+void PluginChainComponent::updateSlotGuards() {
+    auto shouldGuard = slotGuardsButton.getToggleState();
+
+    for (int i = 0; i < pluginSlots.size(); ++i)
+        if (pluginSlots[i]->hasPlugin())
+            pluginHost.setSlotGuardEnabled(i, shouldGuard);
+}
+
+void PluginChainComponent::switchToSelectedSnapshot() {
+    auto index = snapshotSelector.getSelectedId() - 1;
+    if (index < 0 || index == pluginHost.getActiveSnapshot())
+        return;
+
+    // Editor windows belong to the plugins being switched out
+    for (int i = pluginSlots.size() - 1; i >= 0; --i) {
+        closePluginEditor(i);
+    }
+
+    pluginHost.switchToSnapshot(index, snapshotCrossfadeMs);
+}
+
+void PluginChainComponent::refreshSnapshotList() {
+    snapshotSelector.clear(juce::dontSendNotification);
+
+    for (int i = 0; i < pluginHost.getNumSnapshots(); ++i) {
+        auto info = pluginHost.getSnapshotInfo(i);
+        snapshotSelector.addItem(info.name + " (" + juce::String(info.numPlugins) + " plugins, " +
+                                     juce::File::descriptionOfSizeInBytes((juce::int64)info.memoryBytes) + ")",
+                                 i + 1);
+    }
+
+    snapshotSelector.setSelectedId(pluginHost.getActiveSnapshot() + 1, juce::dontSendNotification);
+}
 
 void PluginChainComponent::onPluginError(int pluginIndex, const juce::String &error) {
     juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Plugin Error",
@@ -310,6 +529,9 @@ void PluginChainComponent::PluginSlot::paint(juce::Graphics &g) {
         // Draw status indicator on the left
         drawStatusIndicator(g, bounds);
 
+        if (levelsVisible)
+            drawLevels(g);
+
         // Add subtle shadow effect when not bypassed - use original bounds
         if (!isBypassed) {
             g.setColour(juce::Colours::black.withAlpha(0.3f));
@@ -380,6 +602,9 @@ void PluginChainComponent::PluginSlot::resized() {
         buttonArea.removeFromLeft(buttonSpacing);
         removeButton.setBounds(buttonArea.reduced(2));
 
+        // Slot meters along the bottom of the middle space
+        levelsBounds = levelsVisible ? bounds.removeFromBottom(14).reduced(8, 1) : juce::Rectangle<int>();
+
         // Text area gets the remaining middle space
         auto textArea = bounds.reduced(8, 4); // Some padding
 
@@ -390,6 +615,7 @@ void PluginChainComponent::PluginSlot::resized() {
     } else {
         // Empty slot - just center everything
         statusIndicatorBounds = juce::Rectangle<int>();
+        levelsBounds = juce::Rectangle<int>();
         nameLabel.setBounds(bounds);
         manufacturerLabel.setBounds(juce::Rectangle<int>());
         editButton.setBounds(juce::Rectangle<int>());
@@ -560,6 +786,8 @@ void PluginChainComponent::PluginSlot::itemDropped(const SourceDetails &dragSour
 
 void PluginChainComponent::PluginSlot::setPluginInfo(const PluginHost::PluginInfo &info) {
     pluginInfo = info;
+    levels = {};
+    levelsVersion = 0;
 
     // Set text with uppercase plugin name for impact
     nameLabel.setText(info.name.toUpperCase(), juce::dontSendNotification);
@@ -603,6 +831,70 @@ void PluginChainComponent::PluginSlot::updateBypassState() {
     }
 }
 
+void PluginChainComponent::PluginSlot::setLevelsVisible(bool shouldShow) {
+    if (levelsVisible == shouldShow)
+        return;
+
+    levelsVisible = shouldShow;
+    levels = {};
+    levelsVersion = 0;
+    manufacturerLabel.setText(pluginInfo.manufacturer, juce::dontSendNotification);
+
+    resized();
+    repaint();
+}
+
+void PluginChainComponent::PluginSlot::updateLevels() {
+    if (!levelsVisible)
+        return;
+
+    if (pluginHost.getSlotLevels(slotIndex, levels, levelsVersion))
+        repaint(levelsBounds);
+
+    // CPU share under the name, with the guard's own share and its repairs while it's on
+    auto cost = pluginHost.getSlotCost(slotIndex);
+    auto text = pluginInfo.manufacturer + "  CPU " + juce::String(cost.processLoad * 100.0f, 1) + "%";
+    if (pluginHost.isSlotGuardEnabled(slotIndex)) {
+        text << ", guard " << juce::String(cost.guardLoad * 100.0f, 2) << "%";
+        if (cost.numNonFinite + cost.numDenormals > 0)
+            text << ", " << juce::String(cost.numNonFinite + cost.numDenormals) << " fixed";
+    }
+
+    manufacturerLabel.setText(text, juce::dontSendNotification);
+}
+
+void PluginChainComponent::PluginSlot::drawLevels(juce::Graphics &g) {
+    if (levelsBounds.isEmpty())
+        return;
+
+    // Two thin bars: input on top, output below. RMS filled, peak as a line, red end once clipped.
+    auto drawBar = [&g](juce::Rectangle<float> bar, float rms, float peak, juce::uint32 clips) {
+        auto toProportion = [](float gain) {
+            return juce::jlimit(0.0f, 1.0f, (juce::Decibels::gainToDecibels(gain, -60.0f) + 60.0f) / 60.0f);
+        };
+
+        g.setColour(juce::Colour(0xff1a1a1a));
+        g.fillRect(bar);
+
+        auto clipArea = bar.removeFromRight(4.0f);
+        g.setColour(clips > 0 ? juce::Colour(0xffff3b3b) : juce::Colour(0xff333333));
+        g.fillRect(clipArea.reduced(0.5f, 0.0f));
+
+        g.setColour(juce::Colour(0xff00ff88).withAlpha(0.7f));
+        g.fillRect(bar.withWidth(bar.getWidth() * toProportion(rms)));
+
+        g.setColour(juce::Colours::white.withAlpha(0.8f));
+        auto peakX = bar.getX() + bar.getWidth() * toProportion(peak);
+        g.drawVerticalLine((int)peakX, bar.getY(), bar.getBottom());
+    };
+
+    auto area = levelsBounds.toFloat();
+    auto barHeight = (area.getHeight() - 2.0f) / 2.0f;
+    drawBar(area.removeFromTop(barHeight), levels.inputRMS, levels.inputPeak, levels.inputClips);
+    area.removeFromTop(2.0f);
+    drawBar(area.removeFromTop(barHeight), levels.outputRMS, levels.outputPeak, levels.outputClips);
+}
+
 void PluginChainComponent::PluginSlot::generatePluginTheme() {
     if (!hasPlugin())
         return;
@@ -847,9 +1139,25 @@ PluginChainComponent::PluginBrowser::PluginBrowser(PluginHost &host)
     tabs.setColour(juce::TabbedButtonBar::frontTextColourId, juce::Colours::white);
 
     // Plugin List Tab - remove redundant header
+    pluginListTab.addAndMakeVisible(searchBox);
     pluginListTab.addAndMakeVisible(pluginList);
     pluginListTab.addAndMakeVisible(refreshButton);
 
+    // Search box filters the list as you type, Enter loads the best match
+    searchBox.setTextToShowWhenEmpty("SEARCH PLUGINS", juce::Colour(0xff666666));
+    searchBox.setFont(juce::Font("Arial", 14.0f, juce::Font::plain));
+    searchBox.setColour(juce::TextEditor::backgroundColourId, juce::Colour(0xff0f0f0f));
+    searchBox.setColour(juce::TextEditor::textColourId, juce::Colours::white);
+    searchBox.setColour(juce::TextEditor::outlineColourId, juce::Colour(0xff333333));
+    searchBox.setColour(juce::TextEditor::focusedOutlineColourId, juce::Colour(0xff00d4ff));
+    searchBox.setColour(juce::CaretComponent::caretColourId, juce::Colour(0xff00d4ff));
+    searchBox.onTextChange = [this] { updateSearchResults(false); };
+    searchBox.onReturnKey = [this] { loadPluginAtRow(0); };
+    searchBox.onEscapeKey = [this] {
+        searchBox.clear();
+        updateSearchResults(false);
+    };
+
     // Modern button styling with gradient-like effect
     refreshButton.setButtonText("REFRESH PLUGINS");
     refreshButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff2a2a2a));
@@ -921,6 +1229,7 @@ PluginChainComponent::PluginBrowser::PluginBrowser(PluginHost &host)
 }
 
 PluginChainComponent::PluginBrowser::~PluginBrowser() {
+    stopTimer();
     refreshButton.removeListener(this);
     closeButton.removeListener(this);
     addPathButton.removeListener(this);
@@ -963,6 +1272,9 @@ void PluginChainComponent::PluginBrowser::resized() {
     // Layout for Plugin List Tab - list takes full space, button bar at bottom
     auto pluginListBounds = pluginListTab.getLocalBounds();
 
+    // Search box above the list
+    searchBox.setBounds(pluginListBounds.removeFromTop(40).reduced(6));
+
     // Create bottom button bar
     auto pluginButtonBar = pluginListBounds.removeFromBottom(50);
     refreshButton.setBounds(pluginButtonBar.removeFromLeft(140).reduced(8));
@@ -984,11 +1296,11 @@ void PluginChainComponent::PluginBrowser::resized() {
 }
 
 int PluginChainComponent::PluginBrowser::getNumRows() {
-    // Show only 1 row when loading to display the loading message (clears old plugin rows)
-    if (isLoadingPlugins) {
+    // Show only 1 row when loading until the first results arrive, to display the loading message
+    if (isLoadingPlugins && filteredRows.empty()) {
         return 1;
     }
-    return pluginHost.getAvailablePlugins().size();
+    return (int)filteredRows.size();
 }
 
 void PluginChainComponent::PluginBrowser::paintListBoxItem(int rowNumber, juce::Graphics &g, int width, int height,
@@ -1019,14 +1331,15 @@ void PluginChainComponent::PluginBrowser::paintListBoxItem(int rowNumber, juce::
         g.drawRect(bounds, 1.0f);
     }
 
-    if (isLoadingPlugins) {
+    if (isLoadingPlugins && filteredRows.empty()) {
         // Show loading indicator with animated style (we only have 1 row when loading)
         g.setColour(juce::Colour(0xffffaa00)); // Orange for loading
         g.setFont(juce::Font("Arial", 14.0f, juce::Font::bold));
         juce::String loadingText = "SCANNING FOR PLUGINS...";
         g.drawText(loadingText, 24, 0, width - 48, height, juce::Justification::centredLeft);
-    } else if (rowNumber < pluginHost.getAvailablePlugins().size()) {
-        auto &plugin = pluginHost.getAvailablePlugins().getReference(rowNumber);
+    } else if (juce::isPositiveAndBelow(rowNumber, (int)filteredRows.size())) {
+        auto catalogIndex = filteredRows[(size_t)rowNumber];
+        auto &plugin = availablePlugins[catalogIndex];
 
         auto textBounds = bounds.reduced(24, 8);
         
@@ -1041,7 +1354,7 @@ void PluginChainComponent::PluginBrowser::paintListBoxItem(int rowNumber, juce::
         // Plugin name in bold, larger font (left column)
         g.setColour(rowIsSelected ? juce::Colours::white : juce::Colour(0xfff0f0f0));
         g.setFont(juce::Font("Arial Black", 14.0f, juce::Font::bold));
-        g.drawText(plugin.name.toUpperCase(), nameArea.toNearestInt(), juce::Justification::centredLeft);
+        g.drawText(searchIndex.getDisplayName(catalogIndex), nameArea.toNearestInt(), juce::Justification::centredLeft);
 
         // Manufacturer in smaller font (middle column)
         g.setColour(rowIsSelected ? juce::Colour(0xffcccccc) : juce::Colour(0xffaaaaaa));
@@ -1049,22 +1362,22 @@ void PluginChainComponent::PluginBrowser::paintListBoxItem(int rowNumber, juce::
         g.drawText(plugin.manufacturer, manufacturerArea.toNearestInt(), juce::Justification::centred);
         
         // Format in smaller font with color coding (right column)
-        auto formatColor = getFormatColor(plugin.pluginFormatName, rowIsSelected);
+        auto formatColor = getFormatColor(plugin.formatName, rowIsSelected);
         g.setColour(formatColor);
         g.setFont(juce::Font("Arial", 10.0f, juce::Font::bold));
-        g.drawText(plugin.pluginFormatName.toUpperCase(), formatArea.toNearestInt(), juce::Justification::centred);
+        g.drawText(searchIndex.getDisplayFormat(catalogIndex), formatArea.toNearestInt(), juce::Justification::centred);
     }
 }
 
 void PluginChainComponent::PluginBrowser::listBoxItemDoubleClicked(int row, const juce::MouseEvent &) {
-    // Don't do anything if we're loading (only shows loading message)
-    if (isLoadingPlugins) {
-        return;
-    }
+    loadPluginAtRow(row);
+}
 
-    if (row >= 0 && row < pluginHost.getAvailablePlugins().size()) {
-        auto &plugin = pluginHost.getAvailablePlugins().getReference(row);
-        pluginHost.loadPlugin(plugin);
+void PluginChainComponent::PluginBrowser::loadPluginAtRow(int row) {
+    // Nothing to load while only the loading message is shown
+    if (juce::isPositiveAndBelow(row, (int)filteredRows.size())) {
+        auto &plugin = availablePlugins[filteredRows[(size_t)row]];
+        pluginHost.loadPlugin(pluginHost.createPluginInfo(availablePlugins, plugin));
         setVisible(false);
     }
 }
@@ -1094,8 +1407,8 @@ void PluginChainComponent::PluginBrowser::refreshPluginList() {
     if (pluginHost.isPluginCacheValid()) {
         // Cache is valid, use it immediately
         DBG("Plugin cache is valid, using cached results");
-        pluginList.updateContent();
         isLoadingPlugins = false;
+        updateSearchResults(true);
     } else {
         // Cache is invalid, start async scan
         DBG("Plugin cache is invalid, starting async scan");
@@ -1108,18 +1421,49 @@ void PluginChainComponent::PluginBrowser::refreshPluginList() {
 void PluginChainComponent::PluginBrowser::setVisible(bool shouldBeVisible) {
     Component::setVisible(shouldBeVisible);
     if (shouldBeVisible) {
+        if (userConfig != nullptr) {
+            searchIndex.setRecentUsage(userConfig->getPluginUsage());
+        }
         refreshPluginList();
         refreshSearchPathsList();
+        updateSearchResults(false); // Re-rank with the latest usage
+        searchBox.grabKeyboardFocus();
+        startTimer(100);
+    } else {
+        stopTimer();
     }
 }
 
 void PluginChainComponent::PluginBrowser::onScanComplete() {
     DBG("PluginBrowser received scan complete notification");
     isLoadingPlugins = false;
-    pluginList.updateContent();
+    updateSearchResults(true);
     repaint(); // Refresh the UI
 }
 
+void PluginChainComponent::PluginBrowser::timerCallback() {
+    // Index new scan results incrementally instead of waiting for the scan to finish
+    if (pluginHost.getPluginCatalog().getChangeCount() != lastCatalogChangeCount) {
+        updateSearchResults(true);
+    }
+}
+
+void PluginChainComponent::PluginBrowser::updateSearchResults(bool catalogChanged) {
+    if (catalogChanged) {
+        lastCatalogChangeCount = pluginHost.getPluginCatalog().getChangeCount();
+        availablePlugins = pluginHost.getAvailablePlugins();
+
+        // Nothing new was indexed, keep the current results
+        if (!searchIndex.update(availablePlugins)) {
+            return;
+        }
+    }
+
+    filteredRows = searchIndex.search(searchBox.getText());
+    pluginList.updateContent();
+    pluginList.repaint();
+}
+
 void PluginChainComponent::PluginBrowser::showAddPathDialog() {
     fileChooser = std::make_unique<juce::FileChooser>("Select Plugin Directory",
                                                       juce::File::getSpecialLocation(juce::File::userHomeDirectory));
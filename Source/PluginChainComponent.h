@@ -2,6 +2,7 @@
 
 #include "UserConfig.h"
 #include "PluginHost.h"
+#include "PluginSearchIndex.h"
 #include <juce_core/juce_core.h>
 #include <juce_graphics/juce_graphics.h>
 #include <juce_gui_basics/juce_gui_basics.h>
@@ -16,6 +17,8 @@
     - Drag and drop plugin ordering
     - Plugin controls (bypass, remove, edit)
     - Plugin browser and loading
+    - Chain presets and snapshots (store, load, switch and remove whole chains)
+    - Optional per-slot input/output meters
     - Real-time level meters
     - Spectrum analyzer
 */
@@ -58,6 +61,10 @@ class PluginChainComponent : public juce::Component, public juce::DragAndDropCon
         void clearPlugin();
         void updateBypassState();
 
+        // Input/output meters and the plugin's CPU share, shown while slot metering is on
+        void setLevelsVisible(bool shouldShow);
+        void updateLevels();
+
         int getIndex() const { return slotIndex; }
         bool hasPlugin() const { return !pluginInfo.name.isEmpty(); }
 
@@ -86,6 +93,12 @@ class PluginChainComponent : public juce::Component, public juce::DragAndDropCon
         juce::Colour accentColour;
         juce::Rectangle<int> statusIndicatorBounds; // For the status circle
 
+        // Slot meters
+        bool levelsVisible = false;
+        PluginHost::SlotLevels levels;
+        juce::uint64 levelsVersion = 0;
+        juce::Rectangle<int> levelsBounds;
+
         // Visual enhancement methods
         void generatePluginTheme();
         void drawPluginBackground(juce::Graphics &g, const juce::Rectangle<int> &bounds);
@@ -93,6 +106,7 @@ class PluginChainComponent : public juce::Component, public juce::DragAndDropCon
         void drawPluginIcon(juce::Graphics &g, const juce::Rectangle<int> &iconArea);
         void drawStatusIndicator(juce::Graphics &g, const juce::Rectangle<int> &bounds);
         void drawChromaticAberrationText(juce::Graphics &g, const juce::Rectangle<int> &bounds);
+        void drawLevels(juce::Graphics &g);
         juce::Colour getHashBasedColour(const juce::String &text, float saturation = 0.7f, float brightness = 0.8f);
         juce::Colour getPluginTypeColour(bool isInstrument);
 
@@ -100,7 +114,10 @@ class PluginChainComponent : public juce::Component, public juce::DragAndDropCon
     };
 
     //==============================================================================
-    class PluginBrowser : public juce::Component, public juce::ListBoxModel, public juce::Button::Listener {
+    class PluginBrowser : public juce::Component,
+                          public juce::ListBoxModel,
+                          public juce::Button::Listener,
+                          private juce::Timer {
       public:
         explicit PluginBrowser(PluginHost &host);
         ~PluginBrowser() override;
@@ -121,12 +138,24 @@ class PluginChainComponent : public juce::Component, public juce::DragAndDropCon
         void setUserConfig(UserConfig *config) { userConfig = config; }
         void onScanComplete();
 
+        // Timer override - picks up scan results as they arrive
+        void timerCallback() override;
+
       private:
         PluginHost &pluginHost;
         UserConfig *userConfig = nullptr;
         bool isLoadingPlugins = false;
 
+        // Snapshot of the catalog shown in the list, refreshed as scan results arrive
+        PluginCatalog::View availablePlugins;
+        juce::uint32 lastCatalogChangeCount = 0;
+
+        // Search - rows are catalog indices of the current search results
+        PluginSearchIndex searchIndex;
+        std::vector<int> filteredRows;
+
         // Main UI components
+        juce::TextEditor searchBox;
         juce::ListBox pluginList;
         juce::TextButton refreshButton;
         juce::TextButton closeButton;
@@ -167,6 +196,8 @@ class PluginChainComponent : public juce::Component, public juce::DragAndDropCon
         void removeSelectedPath();
         void resetPathsToDefaults();
         void refreshSearchPathsList();
+        void updateSearchResults(bool catalogChanged);
+        void loadPluginAtRow(int row);
         juce::Colour getFormatColor(const juce::String& formatName, bool isSelected);
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginBrowser)
@@ -177,6 +208,9 @@ class PluginChainComponent : public juce::Component, public juce::DragAndDropCon
     // Access to plugin browser for configuration
     PluginBrowser *getPluginBrowser();
 
+    // Presets are saved to the config's presets folder; the plugin browser gets the config too
+    void setUserConfig(UserConfig *config);
+
   private:
     class LevelMeter : public juce::Component {
       public:
@@ -220,6 +254,24 @@ class PluginChainComponent : public juce::Component, public juce::DragAndDropCon
     juce::TextButton clearAllButton;
     juce::Label chainLabel;
 
+    // Chain snapshots
+    juce::ComboBox snapshotSelector;
+    juce::TextButton storeSnapshotButton;
+    juce::TextButton loadSnapshotButton;
+    juce::TextButton removeSnapshotButton;
+    std::unique_ptr<juce::FileChooser> snapshotChooser;
+    static constexpr double snapshotCrossfadeMs = 30.0;
+
+    // Chain presets
+    juce::TextButton presetsButton;
+    UserConfig *userConfig = nullptr;
+
+    // Per-slot meters - plugins are only metered while these are shown
+    juce::TextButton slotMetersButton;
+
+    // Per-slot output guards against NaN, infinite and denormal samples
+    juce::TextButton slotGuardsButton;
+
     // Metering
     std::array<std::unique_ptr<LevelMeter>, 2> levelMeters; // L/R channels
 
@@ -262,6 +314,21 @@ class PluginChainComponent : public juce::Component, public juce::DragAndDropCon
     void closePluginEditor(int slotIndex);
     void onEditorWindowClosed(int slotIndex);
 
+    // Snapshots
+    void storeSnapshot();
+    void loadSnapshot();
+    void removeSelectedSnapshot();
+    void switchToSelectedSnapshot();
+    void refreshSnapshotList();
+
+    // Presets
+    void showPresetMenu();
+    void saveChainAsPreset();
+
+    // Slot meters and guards
+    void updateSlotMetering();
+    void updateSlotGuards();
+
     // Callbacks
     void onPluginChainChanged();
     void onPluginError(int pluginIndex, const juce::String &error);
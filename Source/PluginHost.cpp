@@ -1,8 +1,42 @@
 #include "PluginHost.h"
+#include "StartupProfiler.h"
 #include "UserConfig.h"
 #include <vector>
 #include <cmath>
 #include <memory>
+#include <set>
+
+#if JUCE_WINDOWS
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif JUCE_MAC
+#include <mach/mach.h>
+#endif
+
+namespace {
+// Resident memory of this process, used to estimate what a plugin instance costs. 0 if unavailable.
+size_t getResidentMemoryBytes() {
+#if JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return (size_t)counters.WorkingSetSize;
+    return 0;
+#elif JUCE_MAC
+    mach_task_basic_info_data_t info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+        return (size_t)info.resident_size;
+    return 0;
+#elif JUCE_LINUX
+    // Second field of statm is the resident page count
+    auto fields = juce::StringArray::fromTokens(juce::File("/proc/self/statm").loadFileAsString(), false);
+    return fields.size() > 1 ? (size_t)fields[1].getLargeIntValue() * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#else
+    return 0;
+#endif
+}
+} // namespace
 
 //==============================================================================
 // Main Thread Scanning Timer
@@ -20,8 +54,25 @@ private:
     PluginHost& pluginHost;
 };
 
+//==============================================================================
+PluginHost::StateChangeListener::StateChangeListener(PluginInstance &instanceToWatch) : instance(instanceToWatch) {
+    instance.processor->addListener(this);
+}
+
+PluginHost::StateChangeListener::~StateChangeListener() { instance.processor->removeListener(this); }
+
+void PluginHost::StateChangeListener::audioProcessorParameterChanged(juce::AudioProcessor *, int, float) {
+    instance.stateChanged = true;
+}
+
+void PluginHost::StateChangeListener::audioProcessorChanged(juce::AudioProcessor *, const ChangeDetails &) {
+    instance.stateChanged = true;
+}
+
 //==============================================================================
 PluginHost::PluginHost() {
+    StartupProfiler::ScopedPhase phase("Plugin format setup");
+
     // Initialize format manager with supported formats
     formatManager.addFormat(new juce::VST3PluginFormat());
     
@@ -48,29 +99,60 @@ PluginHost::PluginHost() {
         }
     }
 
+    // The shell cache is loaded separately (loadScanCache), so startup can do it in parallel
+
     // Don't scan on initialization - plugins will be scanned on first access
     // Use scanForPlugins() or scanForPluginsAsync() when needed
 }
 
-PluginHost::~PluginHost() { 
-    clearAllPlugins(); 
+PluginHost::~PluginHost() {
+    cancelPendingUpdate();
+    clearAllPlugins();
+
+    // Snapshot plugins were created by formatManager, which is destroyed before these members
+    juce::OwnedArray<ChainSnapshot> remainingSnapshots;
+    juce::OwnedArray<PluginInstance> remainingFade;
+    {
+        juce::ScopedLock lock(pluginLock);
+        remainingSnapshots.swapWith(snapshots);
+        remainingFade.swapWith(fadingChain);
+        activeSnapshot = -1;
+        fadingSnapshot = -1;
+        crossfadeSamples = 0;
+    }
+}
+
+void PluginHost::loadScanCache() {
+    // Restore previously enumerated shells so rescans only reload changed binaries
+    scanCache.loadFromFile();
 }
 
 //==============================================================================
-void PluginHost::prepareToPlay(int samplesPerBlock, double sampleRate) {
+void PluginHost::prepareToPlay(int samplesPerBlock, double sampleRate, int numChannels) {
     juce::ScopedLock lock(pluginLock);
 
     currentBlockSize = samplesPerBlock;
     currentSampleRate = sampleRate;
+    currentNumChannels = numChannels;
 
-    // Prepare all plugins in the chain
+    // Prepare all plugins in the chain, and every snapshot so switching never has to
     for (auto *plugin : pluginChain) {
         if (plugin->isValid()) {
-            plugin->processor->prepareToPlay(sampleRate, samplesPerBlock);
+            preparePlugin(*plugin);
+        }
+    }
+
+    for (auto *snapshot : snapshots) {
+        for (auto *plugin : snapshot->chain) {
+            if (plugin->isValid()) {
+                preparePlugin(*plugin);
+            }
         }
     }
 
+    crossfadeBuffer.setSize(numChannels, samplesPerBlock);
     isPrepared = true;
+    ++prepareGeneration;
 }
 
 void PluginHost::processAudio(juce::AudioBuffer<float> &buffer) {
@@ -79,25 +161,212 @@ void PluginHost::processAudio(juce::AudioBuffer<float> &buffer) {
     if (!isPrepared)
         return;
 
+    // Snapshot switch in progress - run both chains and fade between them
+    if (crossfadePosition < crossfadeSamples) {
+        processWithCrossfade(buffer);
+        return;
+    }
+
+    processChain(pluginChain, buffer);
+}
+
+void PluginHost::processChain(juce::OwnedArray<PluginInstance> &chain, juce::AudioBuffer<float> &buffer) {
     // Process through each plugin in the chain
-    for (auto *plugin : pluginChain) {
+    for (auto *plugin : chain) {
+        auto isMetered = plugin->meter.enabled.load(std::memory_order_relaxed);
+        if (isMetered)
+            measureSlot(plugin->meter, buffer, false);
+
         if (plugin->isValid() && !plugin->bypassed) {
-            try {
-                // Create MIDI buffer (empty for now)
-                juce::MidiBuffer midiBuffer;
+            auto startTicks = juce::Time::getHighResolutionTicks();
 
-                // Process the audio
-                plugin->processor->processBlock(buffer, midiBuffer);
+            try {
+                processPlugin(*plugin, buffer);
             } catch (const std::exception &e) {
                 // Handle plugin processing errors
                 plugin->errorMessage = "Processing error: " + juce::String(e.what());
                 plugin->bypassed = true; // Bypass plugin on error
 
                 if (onPluginError) {
-                    onPluginError(pluginChain.indexOf(plugin), plugin->errorMessage);
+                    onPluginError(chain.indexOf(plugin), plugin->errorMessage);
                 }
             }
+
+            guardSlot(plugin->guard, buffer, juce::Time::getHighResolutionTicks() - startTicks);
+        }
+
+        if (isMetered)
+            measureSlot(plugin->meter, buffer, true);
+    }
+}
+
+void PluginHost::processPlugin(PluginInstance &plugin, juce::AudioBuffer<float> &buffer) {
+    // Create MIDI buffer (empty for now)
+    juce::MidiBuffer midiBuffer;
+
+    auto numChannels = buffer.getNumChannels();
+    auto numSamples = buffer.getNumSamples();
+
+    if (plugin.numChannels == numChannels) {
+        plugin.processor->processBlock(buffer, midiBuffer);
+        return;
+    }
+
+    if (plugin.numChannels < numChannels) {
+        // Narrower plugin: processes the first channels in place, the others pass through.
+        // Refers to the chain's channels - no allocation for up to 32 of them.
+        juce::AudioBuffer<float> channels(buffer.getArrayOfWritePointers(), plugin.numChannels, numSamples);
+        plugin.processor->processBlock(channels, midiBuffer);
+        return;
+    }
+
+    // Wider plugin: gets the chain's channels plus silent ones, and only the chain's channels come back
+    auto &wideBuffer = plugin.wideBuffer;
+    wideBuffer.setSize(plugin.numChannels, numSamples, false, false, true);
+    for (int channel = 0; channel < plugin.numChannels; ++channel) {
+        if (channel < numChannels)
+            wideBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+        else
+            wideBuffer.clear(channel, 0, numSamples);
+    }
+
+    plugin.processor->processBlock(wideBuffer, midiBuffer);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        buffer.copyFrom(channel, 0, wideBuffer, channel, 0, numSamples);
+}
+
+void PluginHost::measureSlot(SlotMeter &meter, const juce::AudioBuffer<float> &buffer, bool isOutput) {
+    // One fused pass per channel: peak, sum of squares and clipped samples together
+    SignalKernels::Levels levels;
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        SignalKernels::measureLevels(buffer.getReadPointer(channel), buffer.getNumSamples(), levels);
+
+    auto decay = (float)std::exp(-buffer.getNumSamples() / (currentSampleRate * slotPeakDecaySeconds));
+
+    // Only the audio thread writes, so the current values can be read outside the SeqLock
+    auto &current = meter.levels;
+    auto reset = !isOutput && meter.resetPending.exchange(false);
+    auto heldPeak = reset ? 0.0f : (isOutput ? current.outputPeak : current.inputPeak) * decay;
+    auto peak = juce::jmax(levels.peak, heldPeak);
+
+    meter.levelsLock.beginWrite();
+    if (reset)
+        current = {};
+
+    if (isOutput) {
+        current.outputPeak = peak;
+        current.outputRMS = levels.getRMS();
+        current.outputClips += (juce::uint32)levels.numClipped;
+    } else {
+        current.inputPeak = peak;
+        current.inputRMS = levels.getRMS();
+        current.inputClips += (juce::uint32)levels.numClipped;
+    }
+    meter.levelsLock.endWrite();
+}
+
+void PluginHost::guardSlot(SlotGuard &guard, juce::AudioBuffer<float> &buffer, juce::int64 processTicks) {
+    auto blockTicks = (double)buffer.getNumSamples() / currentSampleRate *
+                      (double)juce::Time::getHighResolutionTicksPerSecond();
+    auto updateLoad = [blockTicks](std::atomic<float> &load, juce::int64 ticks) {
+        auto current = load.load(std::memory_order_relaxed);
+        load.store(current + slotCostSmoothing * ((float)(ticks / blockTicks) - current), std::memory_order_relaxed);
+    };
+
+    updateLoad(guard.processLoad, processTicks);
+
+    if (!guard.enabled.load(std::memory_order_relaxed)) {
+        guard.guardLoad.store(0.0f, std::memory_order_relaxed);
+        return;
+    }
+
+    // One vectorised pass per channel, in place
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    SignalKernels::Repairs repairs;
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        SignalKernels::repairSamples(buffer.getWritePointer(channel), buffer.getNumSamples(), repairs);
+    updateLoad(guard.guardLoad, juce::Time::getHighResolutionTicks() - startTicks);
+
+    guard.numDenormals += (juce::uint32)repairs.numDenormals;
+    if (repairs.numNonFinite > 0) {
+        guard.numNonFinite += (juce::uint32)repairs.numNonFinite;
+
+        // Reported from the message thread
+        triggerAsyncUpdate();
+    }
+}
+
+void PluginHost::reportGuardRepairs() {
+    auto now = juce::Time::getMillisecondCounter();
+    juce::uint32 nextReportDelayMs = 0;
+
+    auto reportChain = [&](juce::OwnedArray<PluginInstance> &chain, bool isFadingOut) {
+        for (int i = 0; i < chain.size(); ++i) {
+            auto &guard = chain[i]->guard;
+            auto numNonFinite = guard.numNonFinite.load();
+            if (numNonFinite == guard.reportedNonFinite)
+                continue;
+
+            // Too soon after the last report - the timer reports it (and whatever happens meanwhile) later
+            auto sinceLastReportMs = now - guard.lastReportMs;
+            if (sinceLastReportMs < guardReportIntervalMs) {
+                auto delayMs = guardReportIntervalMs - sinceLastReportMs;
+                nextReportDelayMs = nextReportDelayMs > 0 ? juce::jmin(nextReportDelayMs, delayMs) : delayMs;
+                continue;
+            }
+
+            auto numNew = numNonFinite - guard.reportedNonFinite;
+            guard.reportedNonFinite = numNonFinite;
+            guard.lastReportMs = now;
+
+            if (!onPluginError)
+                continue;
+
+            auto message = "Output " + juce::String(numNew) + " NaN or infinite samples, replaced with silence";
+            if (isFadingOut)
+                onPluginError(-1, chain[i]->info.name + " (fading out): " + message);
+            else
+                onPluginError(i, message);
         }
+    };
+
+    // The chain fading out after a snapshot switch is still guarded, so it's reported too
+    reportChain(pluginChain, false);
+    reportChain(fadingChain, true);
+
+    if (nextReportDelayMs > 0)
+        guardReportTimer.startTimer((int)nextReportDelayMs);
+}
+
+void PluginHost::processWithCrossfade(juce::AudioBuffer<float> &buffer) {
+    auto numChannels = buffer.getNumChannels();
+    auto numSamples = buffer.getNumSamples();
+
+    // Outgoing chain gets its own copy of the input. Only reallocates if the device
+    // has more channels than prepareToPlay allowed for.
+    crossfadeBuffer.setSize(numChannels, numSamples, false, false, true);
+    for (int channel = 0; channel < numChannels; ++channel)
+        crossfadeBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+
+    processChain(fadingChain, crossfadeBuffer);
+    processChain(pluginChain, buffer);
+
+    // Linear fade over the first fadeSamples, the incoming chain alone after that
+    auto fadeSamples = juce::jmin(numSamples, crossfadeSamples - crossfadePosition);
+    auto startGain = (float)crossfadePosition / (float)crossfadeSamples;
+    auto endGain = (float)(crossfadePosition + fadeSamples) / (float)crossfadeSamples;
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        buffer.applyGainRamp(channel, 0, fadeSamples, startGain, endGain);
+        buffer.addFromWithRamp(channel, 0, crossfadeBuffer.getReadPointer(channel), fadeSamples, 1.0f - startGain,
+                               1.0f - endGain);
+    }
+
+    crossfadePosition += fadeSamples;
+    if (crossfadePosition >= crossfadeSamples) {
+        // Outgoing plugins are suspended and handed back to their snapshot on the message thread
+        triggerAsyncUpdate();
     }
 }
 
@@ -110,32 +379,77 @@ void PluginHost::releaseResources() {
         }
     }
 
+    for (auto *snapshot : snapshots) {
+        for (auto *plugin : snapshot->chain) {
+            if (plugin->isValid()) {
+                plugin->processor->releaseResources();
+            }
+        }
+    }
+
     isPrepared = false;
+    ++prepareGeneration;
 }
 
 //==============================================================================
 bool PluginHost::loadPlugin(const juce::String &pluginPath) {
-    // Find plugin info by path
-    for (const auto &pluginInfo : availablePlugins) {
-        if (pluginInfo.fileOrIdentifier == pluginPath) {
-            return loadPlugin(pluginInfo);
-        }
+    // Find plugin info by identifier, or by path for plugins without one
+    PluginInfo pluginInfo;
+    if (findAvailablePlugin(pluginPath, pluginInfo)) {
+        return loadPlugin(pluginInfo);
     }
     return false;
 }
 
 bool PluginHost::loadPlugin(const PluginInfo &pluginInfo) {
+    if (!addPluginToChain(pluginInfo))
+        return false;
+
+    // Recently used plugins rank higher in the plugin browser search. Plugins restored with a session
+    // don't count, or every restore would look like a use of each of them.
+    if (userConfig != nullptr) {
+        userConfig->notePluginUsed(pluginInfo.identifier,
+                                   pluginInfo.shell != nullptr ? pluginInfo.shell->file : pluginInfo.fileOrIdentifier);
+    }
+
+    return true;
+}
+
+bool PluginHost::addPluginToChain(const PluginInfo &pluginInfo) {
     juce::ScopedLock lock(pluginLock);
 
+    auto instance = createPluginInstance(pluginInfo);
+    if (instance == nullptr) {
+        return false;
+    }
+
+    // Prepare plugin if we're already prepared
+    if (isPrepared) {
+        preparePlugin(*instance);
+    }
+
+    // Add to chain
+    pluginChain.add(instance.release());
+
+    // Notify listeners
+    ++chainChangeCount;
+    if (onPluginChainChanged) {
+        onPluginChainChanged();
+    }
+
+    return true;
+}
+
+std::unique_ptr<PluginHost::PluginInstance> PluginHost::createPluginInstance(const PluginInfo &pluginInfo) {
     // Check architecture compatibility before attempting to load
     if (!pluginInfo.isCompatible) {
         DBG("Attempting to load incompatible plugin: " + pluginInfo.name + " (" + pluginInfo.architectureString + ")");
 
         if (onPluginError) {
             onPluginError(-1, "Plugin architecture (" + pluginInfo.architectureString +
-                         ") is incompatible with host (" + (isHostArchitecture64Bit() ? "x64" : "x86") + ")");
+                         ") is incompatible with host (" + getHostArchitecture() + ")");
         }
-        return false;
+        return nullptr;
     }
 
     // Check if trying to load an instrument (effects only)
@@ -145,13 +459,13 @@ bool PluginHost::loadPlugin(const PluginInfo &pluginInfo) {
         if (onPluginError) {
             onPluginError(-1, "Cannot load instrument '" + pluginInfo.name + "'");
         }
-        return false;
+        return nullptr;
     }
 
     // Use the stored JUCE description if available, otherwise create one manually
     juce::PluginDescription description;
-    if (pluginInfo.hasJuceDescription) {
-        description = pluginInfo.juceDescription;
+    if (pluginInfo.juceDescription != nullptr) {
+        description = *pluginInfo.juceDescription;
         DBG("Using stored JUCE description for: " + pluginInfo.name);
     } else {
         // Fallback: create description manually
@@ -167,7 +481,8 @@ bool PluginHost::loadPlugin(const PluginInfo &pluginInfo) {
         DBG("Using manual description for: " + pluginInfo.name);
     }
 
-    // Create plugin instance
+    // Create plugin instance - resident memory before and after gives a rough cost per instance
+    auto memoryBefore = getResidentMemoryBytes();
     juce::String errorMessage;
     std::unique_ptr<juce::AudioProcessor> processor(
         formatManager.createPluginInstance(description, currentSampleRate, currentBlockSize, errorMessage));
@@ -181,7 +496,7 @@ bool PluginHost::loadPlugin(const PluginInfo &pluginInfo) {
         if (onPluginError) {
             onPluginError(-1, "Failed to load plugin: " + errorMessage);
         }
-        return false;
+        return nullptr;
     }
 
     // Validate plugin
@@ -189,32 +504,21 @@ bool PluginHost::loadPlugin(const PluginInfo &pluginInfo) {
         if (onPluginError) {
             onPluginError(-1, "Plugin validation failed");
         }
-        return false;
+        return nullptr;
     }
 
     // Create plugin instance wrapper
-    auto *instance = new PluginInstance();
+    auto instance = std::make_unique<PluginInstance>();
     instance->processor = std::move(processor);
     instance->info = pluginInfo;
     instance->bypassed = false;
+    instance->stateListener = std::make_unique<StateChangeListener>(*instance);
+    instance->memoryBytes = juce::jmax(memoryBefore, getResidentMemoryBytes()) - memoryBefore;
 
     // Initialize the plugin
-    initializePlugin(instance);
-
-    // Add to chain
-    pluginChain.add(instance);
-
-    // Prepare plugin if we're already prepared
-    if (isPrepared) {
-        instance->processor->prepareToPlay(currentSampleRate, currentBlockSize);
-    }
-
-    // Notify listeners
-    if (onPluginChainChanged) {
-        onPluginChainChanged();
-    }
+    initializePlugin(instance.get());
 
-    return true;
+    return instance;
 }
 
 void PluginHost::unloadPlugin(int index) {
@@ -228,6 +532,7 @@ void PluginHost::unloadPlugin(int index) {
         pluginChain.remove(index);
 
         // Notify listeners
+        ++chainChangeCount;
         if (onPluginChainChanged) {
             onPluginChainChanged();
         }
@@ -246,6 +551,7 @@ void PluginHost::clearAllPlugins() {
     pluginChain.clear();
 
     // Notify listeners
+    ++chainChangeCount;
     if (onPluginChainChanged) {
         onPluginChainChanged();
     }
@@ -259,6 +565,7 @@ void PluginHost::movePlugin(int fromIndex, int toIndex) {
         juce::isPositiveAndBelow(toIndex, pluginChain.size()) && fromIndex != toIndex) {
         pluginChain.move(fromIndex, toIndex);
 
+        ++chainChangeCount;
         if (onPluginChainChanged) {
             onPluginChainChanged();
         }
@@ -268,8 +575,9 @@ void PluginHost::movePlugin(int fromIndex, int toIndex) {
 void PluginHost::bypassPlugin(int index, bool shouldBypass) {
     juce::ScopedLock lock(pluginLock);
 
-    if (juce::isPositiveAndBelow(index, pluginChain.size())) {
+    if (juce::isPositiveAndBelow(index, pluginChain.size()) && pluginChain[index]->bypassed != shouldBypass) {
         pluginChain[index]->bypassed = shouldBypass;
+        ++chainChangeCount;
     }
 }
 
@@ -282,6 +590,70 @@ bool PluginHost::isPluginBypassed(int index) const {
     return false;
 }
 
+//==============================================================================
+void PluginHost::setSlotMeteringEnabled(int index, bool shouldMeter) {
+    if (!juce::isPositiveAndBelow(index, pluginChain.size()))
+        return;
+
+    auto &meter = pluginChain[index]->meter;
+    if (meter.enabled.load() == shouldMeter)
+        return;
+
+    // Start from zero again - cleared by the audio thread, the only writer
+    if (shouldMeter)
+        meter.resetPending = true;
+
+    meter.enabled = shouldMeter;
+}
+
+bool PluginHost::isSlotMeteringEnabled(int index) const {
+    return juce::isPositiveAndBelow(index, pluginChain.size()) && pluginChain[index]->meter.enabled.load();
+}
+
+bool PluginHost::getSlotLevels(int index, SlotLevels &levels, juce::uint64 &lastVersion) const {
+    // The chain only changes on the message thread, so no need to hold pluginLock here
+    if (!juce::isPositiveAndBelow(index, pluginChain.size()))
+        return false;
+
+    const auto &meter = pluginChain[index]->meter;
+    return meter.levelsLock.read(lastVersion, [&] { levels = meter.levels; });
+}
+
+void PluginHost::setSlotGuardEnabled(int index, bool shouldGuard) {
+    if (!juce::isPositiveAndBelow(index, pluginChain.size()))
+        return;
+
+    auto &guard = pluginChain[index]->guard;
+    if (guard.enabled.load() == shouldGuard)
+        return;
+
+    // Count from zero again
+    if (shouldGuard) {
+        guard.numNonFinite = 0;
+        guard.numDenormals = 0;
+        guard.reportedNonFinite = 0;
+    }
+
+    guard.enabled = shouldGuard;
+}
+
+bool PluginHost::isSlotGuardEnabled(int index) const {
+    return juce::isPositiveAndBelow(index, pluginChain.size()) && pluginChain[index]->guard.enabled.load();
+}
+
+PluginHost::SlotCost PluginHost::getSlotCost(int index) const {
+    SlotCost cost;
+    if (!juce::isPositiveAndBelow(index, pluginChain.size()))
+        return cost;
+
+    const auto &guard = pluginChain[index]->guard;
+    cost.processLoad = guard.processLoad.load();
+    cost.guardLoad = guard.guardLoad.load();
+    cost.numNonFinite = guard.numNonFinite.load();
+    cost.numDenormals = guard.numDenormals.load();
+    return cost;
+}
+
 //==============================================================================
 juce::AudioProcessor *PluginHost::getPlugin(int index) {
     juce::ScopedLock lock(pluginLock);
@@ -313,6 +685,7 @@ PluginHost::PluginInfo PluginHost::getPluginInfo(int index) const {
 //==============================================================================
 void PluginHost::scanForPlugins(bool useCache) {
     // Check if we should use cache and have valid cached plugins
+    auto availablePlugins = catalog.getView();
     if (useCache && pluginCacheValid && !availablePlugins.isEmpty()) {
         DBG("Using cached plugin list (" + juce::String(availablePlugins.size()) + " plugins)");
         return;
@@ -357,25 +730,68 @@ juce::ValueTree PluginHost::getState() const {
     for (int i = 0; i < pluginChain.size(); ++i) {
         auto *instance = pluginChain[i];
         if (instance->isValid()) {
-            juce::ValueTree pluginState("Plugin");
-            pluginState.setProperty("name", instance->info.name, nullptr);
-            pluginState.setProperty("manufacturer", instance->info.manufacturer, nullptr);
-            pluginState.setProperty("version", instance->info.version, nullptr);
-            pluginState.setProperty("fileOrIdentifier", instance->info.fileOrIdentifier, nullptr);
-            pluginState.setProperty("bypassed", instance->bypassed, nullptr);
-
-            // Save plugin internal state
+            // Save plugin internal state - kept binary, SessionFile stores it as a raw chunk
             juce::MemoryBlock stateBlock;
             instance->processor->getStateInformation(stateBlock);
-            pluginState.setProperty("state", stateBlock.toBase64Encoding(), nullptr);
-
-            state.appendChild(pluginState, nullptr);
+            state.appendChild(createPluginState(*instance, stateBlock), nullptr);
         }
     }
 
     return state;
 }
 
+bool PluginHost::getStateIfChanged(juce::ValueTree &state) {
+    // The chain only changes on the message thread, so it can be walked without pluginLock here -
+    // plugins serialise themselves while the audio thread carries on processing
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    bool hasChanges = chainChangeCount != autosavedChainChangeCount;
+    autosavedChainChangeCount = chainChangeCount;
+
+    // Plugins that never report changes are re-read too, one per call
+    int sweepIndex = pluginChain.isEmpty() ? -1 : (int)(autosaveSweepCount++ % (juce::uint32)pluginChain.size());
+
+    for (int i = 0; i < pluginChain.size(); ++i) {
+        auto *instance = pluginChain[i];
+        if (!instance->isValid())
+            continue;
+
+        if (!instance->stateChanged.exchange(false) && i != sweepIndex)
+            continue;
+
+        // Change notifications are also sent for things that aren't saved (latency, names...)
+        juce::MemoryBlock stateBlock;
+        instance->processor->getStateInformation(stateBlock);
+        if (stateBlock != instance->savedState) {
+            instance->savedState = std::move(stateBlock);
+            hasChanges = true;
+        }
+    }
+
+    if (!hasChanges)
+        return false;
+
+    state = juce::ValueTree("PluginChain");
+    for (auto *instance : pluginChain) {
+        if (instance->isValid())
+            state.appendChild(createPluginState(*instance, instance->savedState), nullptr);
+    }
+
+    return true;
+}
+
+juce::ValueTree PluginHost::createPluginState(const PluginInstance &instance, const juce::MemoryBlock &stateBlock) {
+    juce::ValueTree pluginState("Plugin");
+    pluginState.setProperty("name", instance.info.name, nullptr);
+    pluginState.setProperty("manufacturer", instance.info.manufacturer, nullptr);
+    pluginState.setProperty("version", instance.info.version, nullptr);
+    pluginState.setProperty("fileOrIdentifier", instance.info.fileOrIdentifier, nullptr);
+    pluginState.setProperty("identifier", instance.info.identifier, nullptr);
+    pluginState.setProperty("bypassed", instance.bypassed, nullptr);
+    pluginState.setProperty("state", juce::var(stateBlock), nullptr);
+    return pluginState;
+}
+
 void PluginHost::setState(const juce::ValueTree &state) {
     if (!state.hasType("PluginChain"))
         return;
@@ -385,238 +801,607 @@ void PluginHost::setState(const juce::ValueTree &state) {
     for (int i = 0; i < state.getNumChildren(); ++i) {
         juce::ValueTree pluginState = state.getChild(i);
         if (pluginState.hasType("Plugin")) {
-            PluginInfo info;
-            info.name = pluginState.getProperty("name", "");
-            info.manufacturer = pluginState.getProperty("manufacturer", "");
-            info.version = pluginState.getProperty("version", "");
-            info.fileOrIdentifier = pluginState.getProperty("fileOrIdentifier", "");
-
-            if (loadPlugin(info)) {
-                int pluginIndex = pluginChain.size() - 1;
-
-                // Restore bypass state
-                bool bypassed = pluginState.getProperty("bypassed", false);
-                bypassPlugin(pluginIndex, bypassed);
-
-                // Restore plugin internal state
-                juce::String stateString = pluginState.getProperty("state", "");
-                if (stateString.isNotEmpty()) {
-                    juce::MemoryBlock stateBlock;
-                    stateBlock.fromBase64Encoding(stateString);
-
-                    if (auto *processor = getPlugin(pluginIndex)) {
-                        processor->setStateInformation(stateBlock.getData(), (int)stateBlock.getSize());
-                    }
-                }
+            if (addPluginToChain(getPluginInfoFromState(pluginState))) {
+                bypassPlugin(getNumPlugins() - 1, pluginState.getProperty("bypassed", false));
+                restorePluginState(*pluginChain.getLast(), pluginState);
             }
         }
     }
 }
 
-void PluginHost::processPluginFile(const juce::File &pluginFile, juce::AudioPluginFormat *format, juce::Array<PluginInfo> &pluginList) {
-    DBG("  Found plugin file: " + pluginFile.getFullPathName() + " (Format: " + format->getName() + ")");
+PluginHost::PluginInfo PluginHost::getPluginInfoFromState(const juce::ValueTree &pluginState) const {
+    PluginInfo info;
+    info.name = pluginState.getProperty("name", "");
+    info.manufacturer = pluginState.getProperty("manufacturer", "");
+    info.version = pluginState.getProperty("version", "");
+    info.fileOrIdentifier = pluginState.getProperty("fileOrIdentifier", "");
+    info.identifier = pluginState.getProperty("identifier", "");
+
+    // Use the scanned description when available so shell plugins load the right sub-plugin
+    if (info.identifier.isNotEmpty()) {
+        findAvailablePlugin(info.identifier, info);
+    }
 
-    // Check architecture compatibility FIRST, before JUCE tries to load it
-    juce::String architecture = getPluginArchitecture(pluginFile);
-    bool isCompatible = isPluginArchitectureCompatible(pluginFile);
+    return info;
+}
 
-    DBG("    Plugin architecture: " + architecture + ", Compatible: " + (isCompatible ? "Yes" : "No"));
+void PluginHost::restorePluginState(PluginInstance &instance, const juce::ValueTree &pluginState) {
+    // Restore plugin internal state (binary, or a base64 string from older sessions)
+    auto stateValue = pluginState.getProperty("state");
+    juce::MemoryBlock stateBlock;
+    if (auto *binaryState = stateValue.getBinaryData()) {
+        stateBlock = *binaryState;
+    } else if (stateValue.toString().isNotEmpty()) {
+        stateBlock.fromBase64Encoding(stateValue.toString());
+    }
 
-    // Skip incompatible plugins entirely
-    if (!isCompatible) {
-        DBG("    Skipped incompatible plugin: " + pluginFile.getFileNameWithoutExtension() +
-            " (" + architecture + " vs host " + (isHostArchitecture64Bit() ? "x64" : "x86") + ")");
-        return;
+    if (stateBlock.getSize() > 0) {
+        instance.processor->setStateInformation(stateBlock.getData(), (int)stateBlock.getSize());
     }
+}
 
-    // Try to get proper plugin description using JUCE (only for compatible plugins)
-    juce::OwnedArray<juce::PluginDescription> descriptions;
-    format->findAllTypesForFile(descriptions, pluginFile.getFullPathName());
+//==============================================================================
+// Chain snapshots
+int PluginHost::storeSnapshot(const juce::String &name) {
+    JUCE_ASSERT_MESSAGE_THREAD
 
-    bool foundDescription = descriptions.size() > 0 && descriptions[0] != nullptr;
-    if (foundDescription) {
-        DBG("    Successfully read plugin description");
-    } else {
-        DBG("    Could not read plugin description, using fallback");
+    // The live chain becomes the new snapshot. The snapshot it belonged to gets its
+    // own copy of the chain as it is now, loaded while the live chain keeps playing.
+    if (auto *previous = snapshots[activeSnapshot]) {
+        juce::OwnedArray<PluginInstance> copy;
+        auto preparedGeneration = instantiateChain(getState(), copy);
+
+        juce::ScopedLock lock(pluginLock);
+        prepareChainIfStale(copy, preparedGeneration);
+        previous->chain.swapWith(copy);
     }
 
-    // Create plugin info from description or fallback
-    PluginInfo info;
-    if (foundDescription) {
-        auto *description = descriptions[0]; // Use first description
-        info.name = description->name.isNotEmpty() ? description->name
-                                                   : pluginFile.getFileNameWithoutExtension();
-        info.manufacturer =
-            description->manufacturerName.isNotEmpty() ? description->manufacturerName : "Unknown";
-        info.version = description->version.isNotEmpty() ? description->version : "1.0";
-        info.pluginFormatName = description->pluginFormatName;
-        info.fileOrIdentifier = description->fileOrIdentifier;
-        info.numInputChannels = description->numInputChannels;
-        info.numOutputChannels = description->numOutputChannels;
-        info.isInstrument = description->isInstrument;
-        info.hasEditor = description->hasSharedContainer;
-
-        // Store the complete JUCE description for accurate loading
-        info.juceDescription = *description;
-        info.hasJuceDescription = true;
-    } else {
-        // Fallback to basic info - assume it's an effect if we can't determine
-        info.name = pluginFile.getFileNameWithoutExtension();
-        info.manufacturer = "Unknown";
-        info.version = "1.0";
-        info.pluginFormatName = format->getName();
-        info.fileOrIdentifier = pluginFile.getFullPathName();
-        info.numInputChannels = 2;
-        info.numOutputChannels = 2;
-        info.isInstrument = false; // Assume effect when unknown
-        info.hasEditor = true;
-        info.hasJuceDescription = false;
-    }
-
-    // Skip instrument plugins (effects only)
-    if (info.isInstrument) {
-        DBG("    Skipped instrument plugin: " + info.name + " (effects only)");
-        return;
+    auto snapshot = std::make_unique<ChainSnapshot>();
+    snapshot->name = name;
+
+    {
+        juce::ScopedLock lock(pluginLock);
+        snapshots.add(snapshot.release());
+        activeSnapshot = snapshots.size() - 1;
     }
 
-    // Set architecture information
-    info.architectureString = architecture;
-    info.is64Bit = architecture.containsIgnoreCase("64") || architecture.containsIgnoreCase("x64");
-    info.isCompatible = isCompatible;
+    DBG("Stored chain snapshot '" + name + "'");
+    return activeSnapshot;
+}
+
+int PluginHost::addSnapshot(const juce::String &name, const juce::ValueTree &state) {
+    JUCE_ASSERT_MESSAGE_THREAD
 
-    // Add compatible effect to the list
-    pluginList.add(info);
-    DBG("    Added effect: " + info.name + " by " + info.manufacturer);
+    auto snapshot = std::make_unique<ChainSnapshot>();
+    snapshot->name = name;
+    auto preparedGeneration = instantiateChain(state, snapshot->chain);
+
+    juce::ScopedLock lock(pluginLock);
+    prepareChainIfStale(snapshot->chain, preparedGeneration);
+    snapshots.add(snapshot.release());
+    return snapshots.size() - 1;
 }
 
-void PluginHost::processPluginBundle(const juce::File &bundleFile, juce::AudioPluginFormat *format, juce::Array<PluginInfo> &pluginList) {
-    DBG("  Found plugin bundle: " + bundleFile.getFullPathName() + " (Format: " + format->getName() + ")");
+bool PluginHost::switchToSnapshot(int index, double crossfadeMs) {
+    JUCE_ASSERT_MESSAGE_THREAD
 
-    // Validate bundle structure based on format
-    bool validBundle = false;
-    if (format->getName().containsIgnoreCase("VST3")) {
-        auto contentsDir = bundleFile.getChildFile("Contents");
-#if JUCE_MAC
-        auto macOSDir = contentsDir.getChildFile("MacOS");
-        validBundle = contentsDir.exists() && macOSDir.exists();
-#elif JUCE_WINDOWS
-        auto x64Dir = contentsDir.getChildFile("x86_64-win");
-        validBundle = contentsDir.exists() && x64Dir.exists();
-#endif
-    } else if (format->getName().containsIgnoreCase("AudioUnit")) {
-        // AU bundles have different structure - assume valid if it's a directory
-        validBundle = bundleFile.isDirectory();
-    } else {
-        // For other formats, assume valid if it's a directory
-        validBundle = bundleFile.isDirectory();
+    auto *target = snapshots[index];
+    if (target == nullptr || index == activeSnapshot) {
+        return false;
     }
 
-    if (!validBundle) {
-        DBG("    Invalid bundle structure for format " + format->getName());
-        return;
+    // The live chain isn't in any snapshot yet - keep it as one rather than deleting it
+    if (activeSnapshot < 0 && !pluginChain.isEmpty())
+        storeSnapshot("Unsaved chain");
+
+    // A fade that's still running is cut short
+    finishCrossfade();
+
+    // Wake the incoming chain up first, so the audio thread only has to swap pointers
+    for (auto *instance : target->chain) {
+        instance->processor->reset();
+        instance->processor->suspendProcessing(false);
     }
 
-    DBG("    Valid bundle structure");
+    auto previousSnapshot = activeSnapshot;
+    juce::OwnedArray<PluginInstance> outgoingChain;
 
-    // Check architecture compatibility FIRST, before JUCE tries to load it
-    juce::String architecture = getPluginArchitecture(bundleFile);
-    bool isCompatible = isPluginArchitectureCompatible(bundleFile);
+    {
+        // The audio thread holds this lock for a whole block, so the switch lands on a block boundary
+        juce::ScopedLock lock(pluginLock);
 
-    DBG("    Plugin architecture: " + architecture + ", Compatible: " + (isCompatible ? "Yes" : "No"));
+        outgoingChain.swapWith(pluginChain);
+        pluginChain.swapWith(target->chain);
 
-    // Skip incompatible plugins entirely
-    if (!isCompatible) {
-        DBG("    Skipped incompatible plugin: " + bundleFile.getFileNameWithoutExtension() +
-            " (" + architecture + " vs host " + (isHostArchitecture64Bit() ? "x64" : "x86") + ")");
-        return;
-    }
+        auto fadeSamples = isPrepared ? juce::roundToInt(crossfadeMs * 0.001 * currentSampleRate) : 0;
+        if (fadeSamples > 0) {
+            fadingChain.swapWith(outgoingChain);
+            fadingSnapshot = previousSnapshot;
+            crossfadeSamples = fadeSamples;
+            crossfadePosition = 0;
+        }
 
-    // Try to get proper plugin description using JUCE (only for compatible plugins)
-    juce::OwnedArray<juce::PluginDescription> descriptions;
-    format->findAllTypesForFile(descriptions, bundleFile.getFullPathName());
+        activeSnapshot = index;
+        ++chainChangeCount;
+    }
 
-    bool foundDescription = descriptions.size() > 0 && descriptions[0] != nullptr;
-    if (foundDescription) {
-        DBG("    Successfully read plugin description");
-    } else {
-        DBG("    Could not read plugin description, using fallback");
+    // Without a fade the outgoing chain goes straight back to its snapshot
+    suspendChain(outgoingChain);
+    if (auto *previous = snapshots[previousSnapshot]) {
+        juce::ScopedLock lock(pluginLock);
+        previous->chain.swapWith(outgoingChain);
     }
 
-    // Create plugin info from description or fallback
-    PluginInfo info;
-    if (foundDescription) {
-        auto *description = descriptions[0]; // Use first description
-        info.name = description->name.isNotEmpty() ? description->name
-                                                   : bundleFile.getFileNameWithoutExtension();
-        info.manufacturer =
-            description->manufacturerName.isNotEmpty() ? description->manufacturerName : "Unknown";
-        info.version = description->version.isNotEmpty() ? description->version : "1.0";
-        info.pluginFormatName = description->pluginFormatName;
-        info.fileOrIdentifier = description->fileOrIdentifier;
-        info.numInputChannels = description->numInputChannels;
-        info.numOutputChannels = description->numOutputChannels;
-        info.isInstrument = description->isInstrument;
-        info.hasEditor = description->hasSharedContainer;
-
-        // Store the complete JUCE description for accurate loading
-        info.juceDescription = *description;
-        info.hasJuceDescription = true;
+    // Only an empty chain is left over here - a live chain was stored as a snapshot above
+    outgoingChain.clear();
+
+    DBG("Switched to chain snapshot '" + target->name + "'");
+
+    if (onPluginChainChanged) {
+        onPluginChainChanged();
+    }
+    return true;
+}
+
+void PluginHost::removeSnapshot(int index) {
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (!juce::isPositiveAndBelow(index, snapshots.size())) {
+        return;
+    }
+
+    finishCrossfade();
+
+    std::unique_ptr<ChainSnapshot> removed;
+    {
+        juce::ScopedLock lock(pluginLock);
+        removed.reset(snapshots.removeAndReturn(index));
+
+        // Removing the active snapshot keeps its plugins live, as an unnamed chain
+        if (activeSnapshot == index) {
+            activeSnapshot = -1;
+        } else if (activeSnapshot > index) {
+            --activeSnapshot;
+        }
+    }
+
+    // Plugins are deleted here, outside the audio lock
+    removed.reset();
+}
+
+PluginHost::SnapshotInfo PluginHost::getSnapshotInfo(int index) const {
+    juce::ScopedLock lock(pluginLock);
+
+    SnapshotInfo info;
+    if (auto *snapshot = snapshots[index]) {
+        info.name = snapshot->name;
+        info.isActive = index == activeSnapshot;
+
+        const auto &chain = info.isActive ? pluginChain : snapshot->chain;
+        info.numPlugins = chain.size();
+        for (auto *instance : chain) {
+            info.memoryBytes += instance->memoryBytes;
+        }
+    }
+    return info;
+}
+
+int PluginHost::instantiateChain(const juce::ValueTree &state, juce::OwnedArray<PluginInstance> &chain) {
+    double sampleRate;
+    int blockSize, numChannels, preparedGeneration;
+    bool shouldPrepare;
+    {
+        juce::ScopedLock lock(pluginLock);
+        sampleRate = currentSampleRate;
+        blockSize = currentBlockSize;
+        numChannels = currentNumChannels;
+        shouldPrepare = isPrepared;
+        preparedGeneration = prepareGeneration;
+    }
+
+    for (const auto &pluginState : state) {
+        if (!pluginState.hasType("Plugin")) {
+            continue;
+        }
+
+        auto instance = createPluginInstance(getPluginInfoFromState(pluginState));
+        if (instance == nullptr) {
+            continue;
+        }
+
+        instance->bypassed = pluginState.getProperty("bypassed", false);
+        restorePluginState(*instance, pluginState);
+
+        // Prepared outside the audio lock - a plugin can take a while over prepareToPlay
+        if (shouldPrepare) {
+            preparePlugin(*instance, sampleRate, blockSize, numChannels);
+        }
+
+        // Loaded and prepared, but costs nothing until it's switched in
+        instance->processor->suspendProcessing(true);
+        chain.add(instance.release());
+    }
+
+    return preparedGeneration;
+}
+
+void PluginHost::prepareChainIfStale(juce::OwnedArray<PluginInstance> &chain, int preparedGeneration) {
+    // The device was reopened or closed while the chain loaded, which is rare enough to redo here
+    if (preparedGeneration == prepareGeneration) {
+        return;
+    }
+
+    for (auto *instance : chain) {
+        if (!instance->isValid()) {
+            continue;
+        }
+
+        if (isPrepared) {
+            preparePlugin(*instance);
+        } else {
+            instance->processor->releaseResources();
+        }
+    }
+}
+
+void PluginHost::suspendChain(juce::OwnedArray<PluginInstance> &chain) {
+    for (auto *instance : chain) {
+        if (instance->isValid()) {
+            instance->processor->suspendProcessing(true);
+        }
+    }
+}
+
+void PluginHost::finishCrossfade() {
+    juce::OwnedArray<PluginInstance> finishedChain;
+    int targetSnapshot = -1;
+
+    {
+        juce::ScopedLock lock(pluginLock);
+        crossfadeSamples = 0;
+        crossfadePosition = 0;
+        finishedChain.swapWith(fadingChain);
+        std::swap(targetSnapshot, fadingSnapshot);
+    }
+
+    suspendChain(finishedChain);
+    if (auto *snapshot = snapshots[targetSnapshot]) {
+        juce::ScopedLock lock(pluginLock);
+        snapshot->chain.swapWith(finishedChain);
+    }
+}
+
+void PluginHost::handleAsyncUpdate() {
+    // Also triggered by the slot guards, so only finish a crossfade that has run its course
+    bool crossfadeFinished;
+    {
+        juce::ScopedLock lock(pluginLock);
+        crossfadeFinished = crossfadeSamples > 0 && crossfadePosition >= crossfadeSamples;
+    }
+
+    // Before a finished fade's chain goes back to its snapshot, while its repairs can still be reported
+    reportGuardRepairs();
+
+    if (crossfadeFinished)
+        finishCrossfade();
+}
+
+void PluginHost::restoreState(const juce::ValueTree &state) {
+    if (!state.hasType("PluginChain") || state.getNumChildren() == 0)
+        return;
+
+    // Plugins already scanned (or nothing left to scan) - restore straight away
+    if (pluginCacheValid && !isCurrentlyScanning) {
+        setState(state);
+        if (onSessionRestored) {
+            onSessionRestored();
+        }
+        return;
+    }
+
+    // Otherwise the scan puts the session's plugins first and restores the chain
+    // as soon as their entries are in the catalog
+    pendingSessionState = state.createCopy();
+    if (!isCurrentlyScanning) {
+        startPluginScan();
+    }
+}
+
+void PluginHost::restorePendingSession() {
+    if (!pendingSessionState.isValid())
+        return;
+
+    auto state = pendingSessionState;
+    pendingSessionState = {};
+
+    // Don't replace a chain the user started building while the scan was running
+    if (getNumPlugins() > 0) {
+        DBG("Plugin chain changed during scan, not restoring previous session");
+        return;
+    }
+
+    DBG("Session plugins scanned, restoring plugin chain");
+    setState(state);
+
+    if (onSessionRestored) {
+        onSessionRestored();
+    }
+}
+
+void PluginHost::sortFilesToScanByPriority() {
+    // Tier 1: plugins referenced by the session waiting to be restored
+    std::set<juce::String> sessionFiles;
+    for (const auto &pluginState : pendingSessionState) {
+        sessionFiles.insert(pluginState.getProperty("fileOrIdentifier").toString());
+    }
+
+    // Tier 2: recently used plugins
+    std::set<juce::String> recentFiles;
+    if (userConfig != nullptr) {
+        for (const auto &[identifier, usage] : userConfig->getPluginUsage()) {
+            if (usage.file.isNotEmpty())
+                recentFiles.insert(usage.file);
+        }
+    }
+
+    // Tier 3: everything else, in directory order
+    auto getPriority = [&](const juce::File &file) {
+        auto path = file.getFullPathName();
+        if (sessionFiles.count(path) > 0)
+            return ScanPriority::session;
+        if (recentFiles.count(path) > 0)
+            return ScanPriority::recent;
+        return ScanPriority::background;
+    };
+
+    std::stable_sort(filesToScan.begin(), filesToScan.end(), [&](const juce::File &a, const juce::File &b) {
+        return getPriority(a) < getPriority(b);
+    });
+
+    numSessionFiles = 0;
+    numPriorityFiles = 0;
+    for (const auto &file : filesToScan) {
+        auto priority = getPriority(file);
+        if (priority == ScanPriority::background)
+            break;
+
+        ++numPriorityFiles;
+        if (priority == ScanPriority::session)
+            ++numSessionFiles;
+    }
+
+    DBG("Scan order: " + juce::String(numSessionFiles) + " session, " +
+        juce::String(numPriorityFiles - numSessionFiles) + " recent, " +
+        juce::String(filesToScan.size() - numPriorityFiles) + " background");
+}
+
+void PluginHost::processPluginFile(const juce::File &pluginFile, juce::AudioPluginFormat *format) {
+    DBG("  Found plugin file: " + pluginFile.getFullPathName() + " (Format: " + format->getName() + ")");
+    ++scanStatistics.numFiles;
+
+    // Check architecture compatibility FIRST, before JUCE tries to load it
+    juce::String architecture = getPluginArchitecture(pluginFile);
+    bool isCompatible = isArchitectureCompatible(architecture);
+
+    DBG("    Plugin architecture: " + architecture + ", Compatible: " + (isCompatible ? "Yes" : "No"));
+
+    // Skip incompatible plugins entirely
+    if (!isCompatible) {
+        DBG("    Skipped incompatible plugin: " + pluginFile.getFileNameWithoutExtension() +
+            " (" + architecture + " vs host " + getHostArchitecture() + ")");
+        scanStatistics.incompatibleFiles.add(pluginFile.getFullPathName());
+        return;
+    }
+
+    // Index every plugin the file exposes (only for compatible plugins)
+    addPluginsFromShell(pluginFile, format, architecture);
+}
+
+void PluginHost::processPluginBundle(const juce::File &bundleFile, juce::AudioPluginFormat *format) {
+    DBG("  Found plugin bundle: " + bundleFile.getFullPathName() + " (Format: " + format->getName() + ")");
+    ++scanStatistics.numFiles;
+
+    // Validate bundle structure based on format
+    bool validBundle = false;
+    if (format->getName().containsIgnoreCase("VST3")) {
+        auto contentsDir = bundleFile.getChildFile("Contents");
+#if JUCE_MAC
+        auto macOSDir = contentsDir.getChildFile("MacOS");
+        validBundle = contentsDir.exists() && macOSDir.exists();
+#else
+        // Windows and Linux bundles keep one folder per architecture (x86_64-win, aarch64-linux...)
+        validBundle = contentsDir.exists() && findBundleBinary(bundleFile) != juce::File();
+#endif
+    } else if (format->getName().containsIgnoreCase("AudioUnit")) {
+        // AU bundles have different structure - assume valid if it's a directory
+        validBundle = bundleFile.isDirectory();
     } else {
+        // For other formats, assume valid if it's a directory
+        validBundle = bundleFile.isDirectory();
+    }
+
+    if (!validBundle) {
+        DBG("    Invalid bundle structure for format " + format->getName());
+        scanStatistics.failedFiles.add(bundleFile.getFullPathName());
+
+        // Cached without plugins, so loadCatalogFromCache doesn't take it for a new install
+        scanCache.storeDescriptions(bundleFile, format->getName(), {}, {});
+        return;
+    }
+
+    DBG("    Valid bundle structure");
+
+    // Check architecture compatibility FIRST, before JUCE tries to load it
+    juce::String architecture = getPluginArchitecture(bundleFile);
+    bool isCompatible = isArchitectureCompatible(architecture);
+
+    DBG("    Plugin architecture: " + architecture + ", Compatible: " + (isCompatible ? "Yes" : "No"));
+
+    // Skip incompatible plugins entirely
+    if (!isCompatible) {
+        DBG("    Skipped incompatible plugin: " + bundleFile.getFileNameWithoutExtension() +
+            " (" + architecture + " vs host " + getHostArchitecture() + ")");
+        scanStatistics.incompatibleFiles.add(bundleFile.getFullPathName());
+        return;
+    }
+
+    // Index every plugin the bundle exposes (only for compatible plugins)
+    addPluginsFromShell(bundleFile, format, architecture);
+}
+
+void PluginHost::addPluginsFromShell(const juce::File &shellFile, juce::AudioPluginFormat *format,
+                                     const juce::String &architecture) {
+    // Enumerating a shell is expensive - reuse the cached result until the binary changes
+    juce::Array<juce::PluginDescription> descriptions;
+    if (scanCache.getDescriptions(shellFile, format->getName(), descriptions)) {
+        DBG("    Using cached shell enumeration (" + juce::String(descriptions.size()) + " plugins)");
+        ++scanStatistics.numCached;
+    } else {
+        juce::OwnedArray<juce::PluginDescription> foundDescriptions;
+        format->findAllTypesForFile(foundDescriptions, shellFile.getFullPathName());
+
+        for (auto *description : foundDescriptions) {
+            if (description != nullptr)
+                descriptions.add(*description);
+        }
+
+        // Cache failed enumerations too, so broken shells aren't reloaded until they change
+        scanCache.storeDescriptions(shellFile, format->getName(), architecture, descriptions);
+        DBG("    Enumerated shell: " + juce::String(descriptions.size()) + " plugins");
+        ++scanStatistics.numEnumerated;
+    }
+
+    if (descriptions.isEmpty())
+        scanStatistics.failedFiles.add(shellFile.getFullPathName());
+
+    addShellToCatalog(shellFile, format->getName(), architecture, descriptions);
+}
+
+void PluginHost::addShellToCatalog(const juce::File &shellFile, const juce::String &formatName,
+                                   const juce::String &architecture,
+                                   const juce::Array<juce::PluginDescription> &descriptions) {
+    // Parent record shared by all plugins from this shell
+    PluginShellInfo shell;
+    shell.file = shellFile.getFullPathName();
+    shell.formatName = formatName;
+    shell.architectureString = architecture;
+    shell.numPlugins = juce::jmax(1, descriptions.size());
+    int shellRecord = catalog.addShell(shell);
+
+    if (descriptions.isEmpty()) {
+        DBG("    Could not read plugin description, using fallback");
+
         // Fallback to basic info - assume it's an effect if we can't determine
-        info.name = bundleFile.getFileNameWithoutExtension();
-        info.manufacturer = "Unknown";
-        info.version = "1.0";
-        info.pluginFormatName = format->getName();
-        info.fileOrIdentifier = bundleFile.getFullPathName();
-        info.numInputChannels = 2;
-        info.numOutputChannels = 2;
-        info.isInstrument = false; // Assume effect when unknown
-        info.hasEditor = true;
-        info.hasJuceDescription = false;
-    }
-
-    // Skip instrument plugins (effects only)
-    if (info.isInstrument) {
-        DBG("    Skipped instrument plugin: " + info.name + " (effects only)");
+        PluginCatalog::Record record;
+        record.name = shellFile.getFileNameWithoutExtension();
+        record.manufacturer = "Unknown";
+        record.version = "1.0";
+        record.formatName = formatName;
+        record.fileOrIdentifier = shellFile.getFullPathName();
+        record.identifier = formatName + "-" + shellFile.getFullPathName();
+        record.numInputChannels = 2;
+        record.numOutputChannels = 2;
+        record.flags = PluginCatalog::Record::editorFlag; // Assume effect when unknown
+        record.architectureString = architecture;
+        if (architecture.containsIgnoreCase("64") || architecture.containsIgnoreCase("x64"))
+            record.flags |= PluginCatalog::Record::is64BitFlag;
+        if (isArchitectureCompatible(architecture))
+            record.flags |= PluginCatalog::Record::compatibleFlag;
+        record.shell = shellRecord;
+
+        DBG("    Added effect: " + record.name + " by " + record.manufacturer);
+        catalog.addRecord(std::move(record));
         return;
     }
 
-    // Set architecture information
-    info.architectureString = architecture;
-    info.is64Bit = architecture.containsIgnoreCase("64") || architecture.containsIgnoreCase("x64");
-    info.isCompatible = isCompatible;
+    for (int i = 0; i < descriptions.size(); ++i) {
+        auto record = createCatalogRecord(descriptions.getReference(i), architecture);
+        record.shell = shellRecord;
+        record.shellIndex = (juce::uint16)i;
 
-    // Add compatible effect to the list
-    pluginList.add(info);
-    DBG("    Added effect: " + info.name + " by " + info.manufacturer);
+        // Skip instrument plugins (effects only)
+        if (record.isInstrument()) {
+            DBG("    Skipped instrument plugin: " + record.name + " (effects only)");
+            continue;
+        }
+
+        DBG("    Added effect: " + record.name + " by " + record.manufacturer + " (" + juce::String(i + 1) + "/" +
+            juce::String(descriptions.size()) + ")");
+        catalog.addRecord(std::move(record));
+    }
 }
 
 //==============================================================================
-PluginHost::PluginInfo PluginHost::createPluginInfo(const juce::PluginDescription &description) {
-    PluginInfo info;
-    info.name = description.name;
-    info.manufacturer = description.manufacturerName;
-    info.version = description.version;
-    info.pluginFormatName = description.pluginFormatName;
-    info.fileOrIdentifier = description.fileOrIdentifier;
-    info.numInputChannels = description.numInputChannels;
-    info.numOutputChannels = description.numOutputChannels;
-    info.isInstrument = description.isInstrument;
-    info.hasEditor = description.hasSharedContainer; // This might need adjustment
+PluginCatalog::Record PluginHost::createCatalogRecord(const juce::PluginDescription &description,
+                                                     const juce::String &architecture) const {
+    PluginCatalog::Record record;
+    record.name = description.name.isNotEmpty() ? description.name
+                                                : juce::File(description.fileOrIdentifier).getFileNameWithoutExtension();
+    record.manufacturer = description.manufacturerName.isNotEmpty() ? description.manufacturerName : "Unknown";
+    record.version = description.version.isNotEmpty() ? description.version : "1.0";
+    record.formatName = description.pluginFormatName;
+    record.fileOrIdentifier = description.fileOrIdentifier;
+    record.identifier = description.createIdentifierString();
+    record.uniqueId = description.uniqueId;
+    record.numInputChannels = (juce::uint16)juce::jlimit(0, 0xffff, description.numInputChannels);
+    record.numOutputChannels = (juce::uint16)juce::jlimit(0, 0xffff, description.numOutputChannels);
+
+    if (description.isInstrument)
+        record.flags |= PluginCatalog::Record::instrumentFlag;
+    if (description.hasSharedContainer) // This might need adjustment
+        record.flags |= PluginCatalog::Record::editorFlag;
 
     // Set architecture information
-    juce::File pluginFile(description.fileOrIdentifier);
-    info.architectureString = getPluginArchitecture(pluginFile);
-    info.is64Bit = info.architectureString.containsIgnoreCase("64") || info.architectureString.containsIgnoreCase("x64");
-    info.isCompatible = isPluginArchitectureCompatible(pluginFile);
+    record.architectureString = architecture;
+    if (architecture.containsIgnoreCase("64") || architecture.containsIgnoreCase("x64"))
+        record.flags |= PluginCatalog::Record::is64BitFlag;
+    if (isArchitectureCompatible(architecture))
+        record.flags |= PluginCatalog::Record::compatibleFlag;
 
     // Store the complete JUCE description
-    info.juceDescription = description;
-    info.hasJuceDescription = true;
+    record.description = std::make_shared<const juce::PluginDescription>(description);
+
+    return record;
+}
 
+PluginHost::PluginInfo PluginHost::createPluginInfo(const PluginCatalog::View &view,
+                                                    const PluginCatalog::Record &record) const {
+    // Strings are pooled and the description is shared, so nothing here is deep-copied
+    PluginInfo info;
+    info.name = record.name;
+    info.manufacturer = record.manufacturer;
+    info.version = record.version;
+    info.pluginFormatName = record.formatName;
+    info.fileOrIdentifier = record.fileOrIdentifier;
+    info.identifier = record.identifier;
+    info.numInputChannels = record.numInputChannels;
+    info.numOutputChannels = record.numOutputChannels;
+    info.isInstrument = record.isInstrument();
+    info.hasEditor = record.hasEditor();
+    info.is64Bit = record.is64Bit();
+    info.isCompatible = record.isCompatible();
+    info.architectureString = record.architectureString;
+    info.juceDescription = record.description;
+    info.shell = view.getShell(record.shell);
+    info.shellIndex = record.shellIndex;
     return info;
 }
 
+bool PluginHost::findAvailablePlugin(const juce::String &identifierOrPath, PluginInfo &result) const {
+    auto view = catalog.getView();
+
+    // Prefer the unique identifier - several plugins can share the same shell file
+    auto *record = view.findByIdentifier(identifierOrPath);
+    if (record == nullptr)
+        record = view.findByPath(identifierOrPath);
+
+    if (record == nullptr)
+        return false;
+
+    result = createPluginInfo(view, *record);
+    return true;
+}
+
 bool PluginHost::validatePlugin(juce::AudioProcessor *processor) {
     if (!processor)
         return false;
@@ -625,12 +1410,7 @@ bool PluginHost::validatePlugin(juce::AudioProcessor *processor) {
     if (processor->getName().isEmpty())
         return false;
 
-    // Check if plugin accepts stereo input/output
-    if (processor->getMainBusNumInputChannels() > 2 || processor->getMainBusNumOutputChannels() > 2) {
-        // For now, we only support mono/stereo plugins
-        return false;
-    }
-
+    // Any channel layout is fine - preparePlugin negotiates the buses
     return true;
 }
 
@@ -638,7 +1418,7 @@ void PluginHost::initializePlugin(PluginInstance *instance) {
     if (!instance || !instance->isValid())
         return;
 
-    // Set up bus layouts for stereo processing
+    // Start from every bus enabled - preparePlugin narrows the layout to the chain's channels
     auto *processor = instance->processor.get();
 
     // Configure input bus
@@ -652,18 +1432,185 @@ void PluginHost::initializePlugin(PluginInstance *instance) {
     }
 }
 
+//==============================================================================
+void PluginHost::preparePlugin(PluginInstance &instance) {
+    preparePlugin(instance, currentSampleRate, currentBlockSize, currentNumChannels);
+}
+
+void PluginHost::preparePlugin(PluginInstance &instance, double sampleRate, int blockSize, int numChannels) {
+    applyBusLayout(instance, numChannels);
+    instance.processor->prepareToPlay(sampleRate, blockSize);
+
+    // processBlock needs room for the wider of the plugin's inputs and outputs
+    auto &processor = *instance.processor;
+    instance.numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+
+    if (instance.numChannels > numChannels)
+        instance.wideBuffer.setSize(instance.numChannels, blockSize);
+    else
+        instance.wideBuffer.setSize(0, 0);
+}
+
+void PluginHost::applyBusLayout(PluginInstance &instance, int numChannels) {
+    auto &processor = *instance.processor;
+    auto identifier = instance.info.identifier.isNotEmpty() ? instance.info.identifier : instance.info.fileOrIdentifier;
+    auto cacheKey = identifier + "/" + juce::String(numChannels);
+
+    // Asking a plugin about layouts can be slow, and every instance of a plugin answers the same
+    juce::AudioProcessor::BusesLayout layout;
+    bool isCached;
+    {
+        juce::ScopedLock lock(busLayoutLock);
+        auto cached = busLayoutCache.find(cacheKey);
+        isCached = cached != busLayoutCache.end();
+        if (isCached)
+            layout = cached->second;
+    }
+
+    if (!isCached) {
+        layout = negotiateBusLayout(processor, numChannels);
+
+        juce::ScopedLock lock(busLayoutLock);
+        busLayoutCache.emplace(cacheKey, layout);
+    }
+
+    if (layout == processor.getBusesLayout())
+        return;
+
+    // Buses can only change while the plugin isn't prepared
+    processor.releaseResources();
+
+    if (!processor.setBusesLayout(layout))
+        DBG("Plugin " + instance.info.name + " refused its negotiated bus layout");
+}
+
+juce::AudioProcessor::BusesLayout PluginHost::negotiateBusLayout(const juce::AudioProcessor &processor,
+                                                                 int numChannels) {
+    // The chain's own layout first (ambisonics or discrete channels of the same width if the
+    // plugin prefers those), then stereo and mono - the remaining channels pass through
+    juce::Array<juce::AudioChannelSet> candidates{juce::AudioChannelSet::canonicalChannelSet(numChannels)};
+
+    auto ambisonicOrder = juce::roundToInt(std::sqrt((double)numChannels)) - 1;
+    if (ambisonicOrder > 0 && (ambisonicOrder + 1) * (ambisonicOrder + 1) == numChannels)
+        candidates.add(juce::AudioChannelSet::ambisonic(ambisonicOrder));
+
+    candidates.addIfNotAlreadyThere(juce::AudioChannelSet::discreteChannels(numChannels));
+
+    for (auto narrower : {2, 1})
+        if (narrower < numChannels)
+            candidates.add(juce::AudioChannelSet::canonicalChannelSet(narrower));
+
+    for (const auto &channelSet : candidates) {
+        auto layout = processor.getBusesLayout();
+
+        // Main buses only - side chain and aux buses would get nothing to process
+        for (auto *buses : {&layout.inputBuses, &layout.outputBuses})
+            for (int bus = 0; bus < buses->size(); ++bus)
+                buses->getReference(bus) = bus == 0 ? channelSet : juce::AudioChannelSet::disabled();
+
+        if (processor.checkBusesLayoutSupported(layout))
+            return layout;
+    }
+
+    // Nothing fits - keep the plugin's own layout, processed in its wide buffer if need be
+    DBG("No " + juce::String(numChannels) + " channel layout for " + processor.getName());
+    return processor.getBusesLayout();
+}
+
 void PluginHost::scanForPlugins(const juce::StringArray &searchPaths) {
-    // For specific search paths, always scan (don't use cache)
-    juce::ScopedLock lock(pluginLock);
-    availablePlugins.clear();
-    scanPluginsInPaths(searchPaths, availablePlugins);
+    // For specific search paths, always scan (shells still come from the scan cache when unchanged)
+    catalog.clear();
+    scanStatistics = {};
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    scanPluginsInPaths(searchPaths);
+    scanCache.removeMissingShells();
+    scanStatistics.cacheWritten = scanCache.saveToFile();
+    pluginCacheValid = true;
+
+    scanStatistics.numPlugins = catalog.getView().size();
+    scanStatistics.elapsedMs =
+        juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+}
+
+bool PluginHost::loadCatalogFromCache() {
+    juce::StringArray searchPaths;
+    if (userConfig != nullptr) {
+        searchPaths = userConfig->getVSTSearchPaths();
+    } else {
+        searchPaths = UserConfig::getDefaultVSTSearchPaths();
+    }
+
+    return loadCatalogFromCache(searchPaths);
+}
+
+bool PluginHost::loadCatalogFromCache(const juce::StringArray &searchPaths) {
+    if (isCurrentlyScanning) {
+        return false;
+    }
+
+    int numStale = 0;
+    auto cachedShells = scanCache.getValidShells(numStale);
+
+    // A changed plugin needs a real scan - so does a cache built for other paths
+    if (numStale > 0) {
+        DBG("Plugin cache has " + juce::String(numStale) + " changed plugins, a rescan is needed");
+        return false;
+    }
+
+    // Plugins the cache doesn't know were installed after it was written. Incompatible ones are never cached,
+    // so they don't count.
+    auto numNew = 0;
+    for (const auto &file : findPluginFiles(searchPaths)) {
+        if (!scanCache.contains(file) && isPluginArchitectureCompatible(file))
+            ++numNew;
+    }
+
+    if (numNew > 0) {
+        DBG(juce::String(numNew) + " plugins were installed after the plugin cache was written, a rescan is needed");
+        return false;
+    }
+
+    auto isInSearchPaths = [&searchPaths](const juce::File &file) {
+        for (const auto &path : searchPaths) {
+            juce::File dir(path);
+            if (file == dir || file.isAChildOf(dir))
+                return true;
+        }
+        return false;
+    };
+
+    juce::Array<PluginScanCache::CachedShell> shellsToAdd;
+    for (const auto &shell : cachedShells) {
+        if (isInSearchPaths(shell.file) && isArchitectureCompatible(shell.architecture))
+            shellsToAdd.add(shell);
+    }
+
+    if (shellsToAdd.isEmpty()) {
+        DBG("Plugin cache has no plugins for the current search paths");
+        return false;
+    }
+
+    catalog.clear();
+    for (const auto &shell : shellsToAdd) {
+        addShellToCatalog(shell.file, shell.formatName, shell.architecture, shell.descriptions);
+    }
+
     pluginCacheValid = true;
+    DBG("Loaded " + juce::String(catalog.getView().size()) + " plugins from " + juce::String(shellsToAdd.size()) +
+        " cached shells, skipping the scan");
+    return true;
 }
 
-void PluginHost::scanPluginsInPaths(const juce::StringArray &searchPaths, juce::Array<PluginInfo> &pluginList) {
-    // Clear the provided list
-    pluginList.clear();
+void PluginHost::setScanCacheFile(const juce::File &cacheFile) {
+    scanCache.setCacheFile(cacheFile);
+}
 
+juce::File PluginHost::getScanCacheFile() const {
+    return scanCache.getCacheFile();
+}
+
+void PluginHost::scanPluginsInPaths(const juce::StringArray &searchPaths) {
     DBG("=== Starting Plugin Scan ===");
     DBG("Search paths: " + searchPaths.joinIntoString(", "));
 
@@ -698,7 +1645,7 @@ void PluginHost::scanPluginsInPaths(const juce::StringArray &searchPaths, juce::
                 
                 for (const auto &pluginFile : pluginFiles) {
                     if (auto *format = getFormatForFile(pluginFile)) {
-                        processPluginFile(pluginFile, format, pluginList);
+                        processPluginFile(pluginFile, format);
                     }
                 }
             }
@@ -710,27 +1657,25 @@ void PluginHost::scanPluginsInPaths(const juce::StringArray &searchPaths, juce::
                 
                 for (const auto &bundleFile : pluginBundles) {
                     if (auto *format = getFormatForFile(bundleFile)) {
-                        processPluginBundle(bundleFile, format, pluginList);
+                        processPluginBundle(bundleFile, format);
                     }
                 }
             }
         }
     }
 
-    DBG("Final available plugins count: " + juce::String(pluginList.size()));
+    DBG("Final available plugins count: " + juce::String(catalog.getView().size()));
     DBG("=== Plugin Scan Complete ===");
 }
 
 void PluginHost::addPluginToList(const juce::PluginDescription &description) {
-    // Check if plugin is already in the list
-    for (const auto &existing : availablePlugins) {
-        if (existing.fileOrIdentifier == description.fileOrIdentifier && existing.name == description.name) {
-            return; // Already exists
-        }
+    // Check if plugin is already in the catalog
+    if (catalog.getView().findByIdentifier(description.createIdentifierString()) != nullptr) {
+        return; // Already exists
     }
 
-    // Add to list
-    availablePlugins.add(createPluginInfo(description));
+    // Add to catalog
+    catalog.addRecord(createCatalogRecord(description, getPluginArchitecture(juce::File(description.fileOrIdentifier))));
 }
 
 //==============================================================================
@@ -744,18 +1689,21 @@ bool PluginHost::isHostArchitecture64Bit() const {
 }
 
 bool PluginHost::isPluginArchitectureCompatible(const juce::File &pluginFile) const {
-    bool hostIs64Bit = isHostArchitecture64Bit();
-    juce::String pluginArch = getPluginArchitecture(pluginFile);
+    return isArchitectureCompatible(getPluginArchitecture(pluginFile));
+}
 
-    if (pluginArch.isEmpty()) {
+bool PluginHost::isArchitectureCompatible(const juce::String &pluginArch) const {
+    if (pluginArch.isEmpty() || pluginArch == "Unknown") {
         // If we can't determine architecture, assume compatible
         return true;
     }
 
-    bool pluginIs64Bit = pluginArch.containsIgnoreCase("64") || pluginArch.containsIgnoreCase("x64");
+    // Universal binaries list every architecture they contain, e.g. "x64+ARM64"
+    return juce::StringArray::fromTokens(pluginArch, "+", "").contains(getHostArchitecture());
+}
 
-    // Compatible if both are same architecture
-    return hostIs64Bit == pluginIs64Bit;
+juce::String PluginHost::getHostArchitecture() const {
+    return BinaryArchitecture::getCpuName(BinaryArchitecture::getHostCpu());
 }
 
 juce::String PluginHost::getPluginArchitecture(const juce::File &pluginFile) const {
@@ -763,107 +1711,58 @@ juce::String PluginHost::getPluginArchitecture(const juce::File &pluginFile) con
         return "Unknown";
     }
 
-#if JUCE_WINDOWS
-    // For Windows, check the file or bundle structure
-    if (pluginFile.isDirectory()) {
-        // VST3 bundle - check subdirectories
-        auto contentsDir = pluginFile.getChildFile("Contents");
-        if (contentsDir.exists()) {
-            if (contentsDir.getChildFile("x86_64-win").exists()) {
-                return "x64";
-            } else if (contentsDir.getChildFile("x86-win").exists()) {
-                return "x86";
-            }
-        }
-    } else {
-        // Single VST3 file - we need to check the PE header
-        return analyzeWindowsPEArchitecture(pluginFile);
-    }
-#elif JUCE_MAC
-    // For macOS, check bundle structure
-    if (pluginFile.isDirectory()) {
-        auto contentsDir = pluginFile.getChildFile("Contents");
-        if (contentsDir.exists()) {
-            auto macOSDir = contentsDir.getChildFile("MacOS");
-            if (macOSDir.exists()) {
-                // Check for universal binary or specific architectures
-                auto binaries = macOSDir.findChildFiles(juce::File::findFiles, false);
-                if (!binaries.isEmpty()) {
-                    return analyzeMacBinaryArchitecture(binaries[0]);
-                }
-            }
-        }
-    }
-#endif
-
-    return "Unknown";
-}
-
-juce::String PluginHost::analyzeWindowsPEArchitecture(const juce::File &pluginFile) const {
-#if JUCE_WINDOWS
-    // Read PE header to determine architecture
-    juce::FileInputStream stream(pluginFile);
-    if (!stream.openedOk()) {
+    // Bundles are probed through the binary the host would actually load
+    auto binaryFile = pluginFile.isDirectory() ? findBundleBinary(pluginFile) : pluginFile;
+    if (binaryFile == juce::File()) {
         return "Unknown";
     }
 
-    // Read DOS header
-    char dosHeader[64];
-    if (stream.read(dosHeader, 64) != 64) {
-        return "Unknown";
-    }
+    // Header-only probe, cached per file - the binary is never loaded here
+    return architectureProbe.getArchitecture(binaryFile).toString();
+}
 
-    // Check DOS signature
-    if (dosHeader[0] != 'M' || dosHeader[1] != 'Z') {
-        return "Unknown";
+juce::File PluginHost::findBundleBinary(const juce::File &bundleFile) const {
+    auto contentsDir = bundleFile.getChildFile("Contents");
+    if (!contentsDir.isDirectory()) {
+        return {};
     }
 
-    // Get PE header offset
-    uint32_t peOffset = *reinterpret_cast<uint32_t*>(&dosHeader[60]);
-    stream.setPosition(peOffset);
-
-    // Read PE signature
-    char peSignature[4];
-    if (stream.read(peSignature, 4) != 4) {
-        return "Unknown";
-    }
+    auto findBinaryIn = [&bundleFile](const juce::File &dir) -> juce::File {
+        // Prefer the binary named after the bundle, otherwise take the first file
+        auto binaries = dir.findChildFiles(juce::File::findFiles, false);
+        for (const auto &binary : binaries) {
+            if (binary.getFileNameWithoutExtension() == bundleFile.getFileNameWithoutExtension())
+                return binary;
+        }
+        return binaries.isEmpty() ? juce::File() : binaries.getFirst();
+    };
 
-    if (memcmp(peSignature, "PE\0\0", 4) != 0) {
-        return "Unknown";
+    // macOS bundles (VST3, AU, VST, CLAP) - a single, possibly universal, binary
+    auto macOSDir = contentsDir.getChildFile("MacOS");
+    if (macOSDir.isDirectory()) {
+        return findBinaryIn(macOSDir);
     }
 
-    // Read COFF header
-    uint16_t machine;
-    if (stream.read(&machine, 2) != 2) {
-        return "Unknown";
+    // VST3 bundles on Windows and Linux - use the host's architecture folder when present,
+    // otherwise report whatever the bundle does contain so it gets rejected
+    auto hostFolderName = BinaryArchitecture::getVST3BundleFolder(BinaryArchitecture::getHostCpu());
+    if (hostFolderName.isNotEmpty() && contentsDir.getChildFile(hostFolderName).isDirectory()) {
+        return findBinaryIn(contentsDir.getChildFile(hostFolderName));
     }
 
-    switch (machine) {
-        case 0x8664: // IMAGE_FILE_MACHINE_AMD64
-            return "x64";
-        case 0x014c: // IMAGE_FILE_MACHINE_I386
-            return "x86";
-        case 0xAA64: // IMAGE_FILE_MACHINE_ARM64
-            return "ARM64";
-        default:
-            return "Unknown (" + juce::String::toHexString(machine) + ")";
-    }
+#if JUCE_WINDOWS
+    const juce::String folderPattern("*-win");
 #else
-    juce::ignoreUnused(pluginFile);
-    return "Unknown";
+    const juce::String folderPattern("*-linux");
 #endif
-}
 
-juce::String PluginHost::analyzeMacBinaryArchitecture(const juce::File &binaryFile) const {
-#if JUCE_MAC
-    // For macOS, we can use the `file` command or read Mach-O headers
-    // For simplicity, assume 64-bit on modern macOS
-    juce::ignoreUnused(binaryFile);
-    return "x64"; // Most modern Mac plugins are 64-bit
-#else
-    juce::ignoreUnused(binaryFile);
-    return "Unknown";
-#endif
+    for (const auto &folder : contentsDir.findChildFiles(juce::File::findDirectories, false, folderPattern)) {
+        auto binary = findBinaryIn(folder);
+        if (binary != juce::File())
+            return binary;
+    }
+
+    return {};
 }
 
 //==============================================================================
@@ -882,9 +1781,13 @@ void PluginHost::startPluginScan() {
         // Prepare the scan
         filesToScan.clear();
         currentScanIndex = 0;
+        numSessionFiles = 0;
+        numPriorityFiles = 0;
+        scanStatistics = {};
+        scanStartTicks = juce::Time::getHighResolutionTicks();
 
-        juce::ScopedLock lock(pluginLock);
-        availablePlugins.clear();
+        // Readers holding a view of the previous scan keep it until they refresh
+        catalog.clear();
 
         // Get search paths
         juce::StringArray searchPaths;
@@ -898,30 +1801,7 @@ void PluginHost::startPluginScan() {
         DBG("Search paths: " + searchPaths.joinIntoString(", "));
 
         // Collect all files to scan
-        auto supportedFormats = getSupportedFormats();
-        for (const auto &path : searchPaths) {
-            juce::File dir(path);
-            if (dir.exists() && dir.isDirectory()) {
-                DBG("Scanning directory recursively: " + dir.getFullPathName());
-
-                // Find plugin files for all supported formats (recursive search)
-                for (const auto &formatInfo : supportedFormats) {
-                    // Find files with the format's extensions (recursive)
-                    for (const auto &extension : formatInfo.fileExtensions) {
-                        juce::Array<juce::File> pluginFiles;
-                        dir.findChildFiles(pluginFiles, juce::File::findFiles, true, "*." + extension);
-                        filesToScan.addArray(pluginFiles);
-                    }
-
-                    // Find directories with the format's extensions (bundles, recursive)
-                    for (const auto &extension : formatInfo.directoryExtensions) {
-                        juce::Array<juce::File> pluginBundles;
-                        dir.findChildFiles(pluginBundles, juce::File::findDirectories, true, "*." + extension);
-                        filesToScan.addArray(pluginBundles);
-                    }
-                }
-            }
-        }
+        filesToScan = findPluginFiles(searchPaths);
 
         DBG("Found " + juce::String(filesToScan.size()) + " plugin files/bundles to scan");
 
@@ -929,6 +1809,7 @@ void PluginHost::startPluginScan() {
             // No files to scan, finish immediately
             pluginCacheValid = true;
             isCurrentlyScanning = false;
+            restorePendingSession();
 
             if (onPluginScanComplete) {
                 onPluginScanComplete();
@@ -936,12 +1817,41 @@ void PluginHost::startPluginScan() {
             return;
         }
 
-        // Start the timer-based scanning
+        // Session and recently used plugins first, so a working chain is available early
+        sortFilesToScanByPriority();
+
+        // Start the timer-based scanning - priority files back to back, the rest in the background
         scanningTimer.reset(new PluginScanningTimer(*this));
-        scanningTimer->startTimer(10); // Scan one plugin every 10ms
+        scanningTimer->startTimer(numPriorityFiles > 0 ? priorityScanIntervalMs : backgroundScanIntervalMs);
     });
 }
 
+juce::Array<juce::File> PluginHost::findPluginFiles(const juce::StringArray &searchPaths) const {
+    juce::Array<juce::File> pluginFiles;
+    auto supportedFormats = getSupportedFormats();
+
+    for (const auto &path : searchPaths) {
+        juce::File dir(path);
+        if (!dir.isDirectory())
+            continue;
+
+        DBG("Scanning directory recursively: " + dir.getFullPathName());
+
+        // Find plugin files for all supported formats (recursive search)
+        for (const auto &formatInfo : supportedFormats) {
+            // Find files with the format's extensions (recursive)
+            for (const auto &extension : formatInfo.fileExtensions)
+                dir.findChildFiles(pluginFiles, juce::File::findFiles, true, "*." + extension);
+
+            // Find directories with the format's extensions (bundles, recursive)
+            for (const auto &extension : formatInfo.directoryExtensions)
+                dir.findChildFiles(pluginFiles, juce::File::findDirectories, true, "*." + extension);
+        }
+    }
+
+    return pluginFiles;
+}
+
 void PluginHost::refreshPluginCache() {
     pluginCacheValid = false;
     startPluginScan();
@@ -949,16 +1859,32 @@ void PluginHost::refreshPluginCache() {
 
 void PluginHost::scanNextPlugin()
 {
+    // All of the session's plugins are in the catalog - no need to wait for the rest
+    if (currentScanIndex >= numSessionFiles) {
+        restorePendingSession();
+    }
+
+    // Priority tiers done, continue at background pace to keep the message thread responsive
+    if (currentScanIndex == numPriorityFiles && numPriorityFiles > 0 && scanningTimer != nullptr) {
+        DBG("Priority plugins scanned, continuing in the background");
+        scanningTimer->startTimer(backgroundScanIntervalMs);
+    }
+
     if (currentScanIndex >= filesToScan.size()) {
         // Scanning complete
         scanningTimer.reset();
 
-        juce::ScopedLock lock(pluginLock);
         pluginCacheValid = true;
         isCurrentlyScanning = false;
+        scanCache.removeMissingShells();
+        scanCache.saveToFile();
+
+        scanStatistics.numPlugins = catalog.getView().size();
+        scanStatistics.elapsedMs =
+            juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - scanStartTicks) * 1000.0;
 
         DBG("=== Plugin Scan Complete ===");
-        DBG("Final available plugins count: " + juce::String(availablePlugins.size()));
+        DBG("Final available plugins count: " + juce::String(catalog.getView().size()));
 
         if (onPluginScanComplete) {
             DBG("Calling onPluginScanComplete callback");
@@ -974,13 +1900,12 @@ void PluginHost::scanNextPlugin()
     // Process current file
     const auto& currentFile = filesToScan[currentScanIndex];
 
-    juce::ScopedLock lock(pluginLock);
-
+    // Results go straight into the catalog - the audio lock is never taken while scanning
     if (auto *format = getFormatForFile(currentFile)) {
         if (currentFile.isDirectory()) {
-            processPluginBundle(currentFile, format, availablePlugins);
+            processPluginBundle(currentFile, format);
         } else {
-            processPluginFile(currentFile, format, availablePlugins);
+            processPluginFile(currentFile, format);
         }
     }
 
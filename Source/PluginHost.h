@@ -1,11 +1,17 @@
 #pragma once
 
+#include "BinaryArchitecture.h"
+#include "PluginCatalog.h"
+#include "PluginScanCache.h"
+#include "SeqLock.h"
+#include "SignalKernels.h"
 #include "UserConfig.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
+#include <map>
 
 //==============================================================================
 /**
@@ -17,9 +23,19 @@
     - Processing audio through the plugin chain
     - Plugin parameter management
     - Plugin state saving/loading
+    - Chain snapshots: whole chains kept loaded, prepared and suspended, switched
+      at a block boundary with an optional crossfade
+    - Optional per-slot metering before and after each plugin
+    - Any channel count: each plugin's main buses are negotiated to the chain's
+      layout (or the nearest one it supports) when it's prepared, and the
+      result is cached per plugin and channel count
 */
-class PluginHost {
+class PluginHost : private juce::AsyncUpdater {
   public:
+    //==============================================================================
+    // Parent record shared by every plugin exposed by the same file or bundle
+    using PluginShellInfo = PluginCatalog::ShellRecord;
+
     //==============================================================================
     struct PluginInfo {
         juce::String name;
@@ -27,6 +43,7 @@ class PluginHost {
         juce::String version;
         juce::String pluginFormatName;
         juce::String fileOrIdentifier;
+        juce::String identifier; // Unique per plugin, even for plugins sharing a shell file
         int numInputChannels = 0;
         int numOutputChannels = 0;
         bool isInstrument = false;
@@ -37,17 +54,59 @@ class PluginHost {
         bool isCompatible = true;
         juce::String architectureString;
 
-        // Store the complete JUCE plugin description for accurate loading
-        juce::PluginDescription juceDescription;
-        bool hasJuceDescription = false;
+        // Complete JUCE plugin description for accurate loading (shared with the catalog)
+        std::shared_ptr<const juce::PluginDescription> juceDescription;
+
+        // Shell this plugin was enumerated from, and its position within it
+        std::shared_ptr<const PluginShellInfo> shell;
+        int shellIndex = 0;
+    };
+
+    //==============================================================================
+    // Results of the last completed scan
+    struct ScanStatistics {
+        int numFiles = 0;      // Plugin files and bundles found in the search paths
+        int numCached = 0;     // Shells taken from the scan cache
+        int numEnumerated = 0; // Shells loaded and enumerated
+        int numPlugins = 0;    // Plugins added to the catalog
+        juce::StringArray failedFiles;       // Invalid bundles and shells that exposed no plugins
+        juce::StringArray incompatibleFiles; // Skipped for their architecture
+        double elapsedMs = 0.0;
+        bool cacheWritten = false; // The scan cache was saved, or was already up to date on disk
+    };
+
+    // A stored chain snapshot, for display
+    struct SnapshotInfo {
+        juce::String name;
+        int numPlugins = 0;
+        bool isActive = false;
+        size_t memoryBytes = 0; // Approximate - resident memory growth while its plugins were loaded
+    };
+
+    // Levels going into and coming out of a plugin, over all channels
+    struct SlotLevels {
+        float inputPeak = 0.0f; // Gain, held with a decay
+        float inputRMS = 0.0f;  // Gain, over the last block
+        float outputPeak = 0.0f;
+        float outputRMS = 0.0f;
+        juce::uint32 inputClips = 0; // Clipped samples since metering was enabled
+        juce::uint32 outputClips = 0;
+    };
+
+    // What a plugin costs, and what its output guard had to repair
+    struct SlotCost {
+        float processLoad = 0.0f;      // Share of the block's duration spent in the plugin, averaged
+        float guardLoad = 0.0f;        // The same for the guard, while it's on
+        juce::uint32 numNonFinite = 0; // NaN and infinite output samples replaced since the guard was enabled
+        juce::uint32 numDenormals = 0; // Denormal output samples flushed to zero
     };
 
     //==============================================================================
     PluginHost();
     ~PluginHost();
 
-    // Audio processing
-    void prepareToPlay(int samplesPerBlock, double sampleRate);
+    // Audio processing - numChannels is the chain's width, i.e. the buffers processAudio will get
+    void prepareToPlay(int samplesPerBlock, double sampleRate, int numChannels);
     void processAudio(juce::AudioBuffer<float> &buffer);
     void releaseResources();
 
@@ -73,12 +132,39 @@ class PluginHost {
     void scanForPlugins(const juce::StringArray &searchPaths);        // Scan specific paths
     void refreshPluginCache();                                        // Force refresh
     bool isPluginCacheValid() const { return pluginCacheValid; }
+    void loadScanCache(); // Thread safe, call before the first scan
+    void setScanCacheFile(const juce::File &cacheFile);
+    juce::File getScanCacheFile() const;
+    const ScanStatistics &getLastScanStatistics() const { return scanStatistics; }
+
+    // Fills the catalog from the scan cache alone, e.g. one built by a headless scan. Returns
+    // false, leaving the catalog untouched, if a cached plugin changed, a plugin was installed
+    // since the cache was written, or nothing matches the paths.
+    bool loadCatalogFromCache();
+    bool loadCatalogFromCache(const juce::StringArray &searchPaths);
     bool isScanning() const { return isCurrentlyScanning; }
-    const juce::Array<PluginInfo> &getAvailablePlugins() const { return availablePlugins; }
+
+    // Scanned plugins - views are copy-free and safe to use while a scan is running
+    PluginCatalog::View getAvailablePlugins() const { return catalog.getView(); }
+    const PluginCatalog &getPluginCatalog() const { return catalog; }
+    PluginInfo createPluginInfo(const PluginCatalog::View &view, const PluginCatalog::Record &record) const;
 
     // Configuration
     void setUserConfig(UserConfig *config) { userConfig = config; }
 
+    // Per-slot metering. A slot is only measured while its metering is enabled - otherwise it costs
+    // nothing. getSlotLevels returns false if nothing new was measured since lastVersion. Message thread only.
+    void setSlotMeteringEnabled(int index, bool shouldMeter);
+    bool isSlotMeteringEnabled(int index) const;
+    bool getSlotLevels(int index, SlotLevels &levels, juce::uint64 &lastVersion) const;
+
+    // Per-slot output guard: zeroes NaNs, infinities and denormals the plugin outputs, so they can't
+    // reach the plugins after it. Non-finite output is reported through onPluginError, at most once
+    // per slot every guardReportIntervalMs. Message thread only.
+    void setSlotGuardEnabled(int index, bool shouldGuard);
+    bool isSlotGuardEnabled(int index) const;
+    SlotCost getSlotCost(int index) const;
+
     // Plugin editors
     juce::AudioProcessorEditor *createEditorForPlugin(int index);
     void closeEditorForPlugin(int index);
@@ -87,13 +173,74 @@ class PluginHost {
     juce::ValueTree getState() const;
     void setState(const juce::ValueTree &state);
 
+    // Incremental state for autosave: only re-reads plugins that reported a change since the
+    // last call (and one other plugin per call, for plugins that never report changes).
+    // Returns false if nothing changed. Message thread only.
+    bool getStateIfChanged(juce::ValueTree &state);
+
+    // Chain snapshots. The live chain belongs to the active snapshot, so edits change it.
+    // storeSnapshot makes the live chain a new, active snapshot (the previously active one
+    // keeps a copy); addSnapshot loads a saved chain as an inactive snapshot. Switching away from
+    // a chain that isn't in a snapshot stores it as one first. Editors of the live chain should be
+    // closed before switching. Message thread only.
+    int storeSnapshot(const juce::String &name);
+    int addSnapshot(const juce::String &name, const juce::ValueTree &state);
+    bool switchToSnapshot(int index, double crossfadeMs = 0.0);
+    void removeSnapshot(int index);
+    int getNumSnapshots() const { return snapshots.size(); }
+    int getActiveSnapshot() const { return activeSnapshot; }
+    SnapshotInfo getSnapshotInfo(int index) const;
+
+    // Session restore - scans the session's plugins first and loads the chain as soon as they're available
+    void restoreState(const juce::ValueTree &state);
+    bool isSessionRestorePending() const { return pendingSessionState.isValid(); }
+
     // Callbacks
     std::function<void()> onPluginChainChanged;
     std::function<void(int, const juce::String &)> onPluginError;
     std::function<void()> onPluginScanComplete;
+    std::function<void()> onSessionRestored;
 
   private:
     //==============================================================================
+    struct PluginInstance;
+
+    // Flags a plugin for autosave when it reports a parameter or state change (from any thread)
+    class StateChangeListener : public juce::AudioProcessorListener {
+      public:
+        explicit StateChangeListener(PluginInstance &instanceToWatch);
+        ~StateChangeListener() override;
+
+        void audioProcessorParameterChanged(juce::AudioProcessor *, int, float) override;
+        void audioProcessorChanged(juce::AudioProcessor *, const ChangeDetails &) override;
+
+      private:
+        PluginInstance &instance;
+
+        JUCE_DECLARE_NON_COPYABLE(StateChangeListener)
+    };
+
+    // Per-slot levels, measured on the audio thread and published under a SeqLock
+    struct SlotMeter {
+        std::atomic<bool> enabled{false};
+        std::atomic<bool> resetPending{false};
+        SlotLevels levels;
+        SeqLock levelsLock;
+    };
+
+    // Per-slot output guard and processing cost. Written by the audio thread, except for the report state.
+    struct SlotGuard {
+        std::atomic<bool> enabled{false};
+        std::atomic<float> processLoad{0.0f};
+        std::atomic<float> guardLoad{0.0f};
+        std::atomic<juce::uint32> numNonFinite{0};
+        std::atomic<juce::uint32> numDenormals{0};
+
+        // Message thread
+        juce::uint32 reportedNonFinite = 0;
+        juce::uint32 lastReportMs = 0;
+    };
+
     struct PluginInstance {
         std::unique_ptr<juce::AudioProcessor> processor;
         std::unique_ptr<juce::AudioProcessorEditor> editor;
@@ -101,6 +248,18 @@ class PluginHost {
         bool bypassed = false;
         juce::String errorMessage;
 
+        // Autosave - the state last written, and whether the plugin changed since it was read
+        std::atomic<bool> stateChanged{true};
+        juce::MemoryBlock savedState;
+        size_t memoryBytes = 0; // Resident memory growth while the plugin was instantiated
+        SlotMeter meter;
+        SlotGuard guard;
+
+        // Channels the negotiated bus layout processes, and a buffer for plugins wider than the chain
+        int numChannels = 0;
+        juce::AudioBuffer<float> wideBuffer;
+        std::unique_ptr<StateChangeListener> stateListener; // Declared last, removed before the processor is deleted
+
         bool isValid() const { return processor != nullptr; }
     };
 
@@ -111,9 +270,27 @@ class PluginHost {
         juce::StringArray directoryExtensions;
     };
 
+    //==============================================================================
+    // A complete chain kept in memory. Its chain is empty while it's the active snapshot.
+    struct ChainSnapshot {
+        juce::String name;
+        juce::OwnedArray<PluginInstance> chain;
+    };
+
     //==============================================================================
     juce::OwnedArray<PluginInstance> pluginChain;
-    juce::Array<PluginInfo> availablePlugins;
+
+    // Snapshots, and the outgoing chain while a switch crossfades (all guarded by pluginLock)
+    juce::OwnedArray<ChainSnapshot> snapshots;
+    int activeSnapshot = -1;
+    juce::OwnedArray<PluginInstance> fadingChain;
+    int fadingSnapshot = -1; // Where fadingChain goes when the fade ends, -1 to delete it
+    int crossfadeSamples = 0;
+    int crossfadePosition = 0;
+    juce::AudioBuffer<float> crossfadeBuffer;
+
+    // Scanned plugins, with its own locking so scans never block the audio thread
+    PluginCatalog catalog;
 
     // Audio format managers
     juce::AudioPluginFormatManager formatManager;
@@ -121,43 +298,119 @@ class PluginHost {
     // Audio processing
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
+    int currentNumChannels = 2;
     bool isPrepared = false;
+    int prepareGeneration = 0; // Bumped by every prepareToPlay and releaseResources
+
+    static constexpr double slotPeakDecaySeconds = 0.23;
+    static constexpr float slotCostSmoothing = 0.05f; // Per block
+    static constexpr juce::uint32 guardReportIntervalMs = 10000;
+
+    // Reports repairs held back by the interval above, in case nothing triggers a report by then
+    juce::TimedCallback guardReportTimer{[this] {
+        guardReportTimer.stopTimer();
+        reportGuardRepairs();
+    }};
 
-    // Threading
+    // Negotiated bus layouts by plugin identifier and channel count
+    std::map<juce::String, juce::AudioProcessor::BusesLayout> busLayoutCache;
+    juce::CriticalSection busLayoutLock;
+
+    // Threading - guards the plugin chain only, shared with the audio thread
     juce::CriticalSection pluginLock;
 
+    // Autosave change tracking - bumped by every chain edit (load, unload, move, bypass)
+    juce::uint32 chainChangeCount = 0;
+    juce::uint32 autosavedChainChangeCount = 0;
+    juce::uint32 autosaveSweepCount = 0;
+
     // Configuration
     UserConfig *userConfig = nullptr;
 
     // Plugin cache and scanning state
-    bool pluginCacheValid = false;
-    bool isCurrentlyScanning = false;
+    std::atomic<bool> pluginCacheValid{false};
+    std::atomic<bool> isCurrentlyScanning{false};
 
     // Scanning state
     juce::Array<juce::File> filesToScan;
     int currentScanIndex = 0;
     std::unique_ptr<juce::Timer> scanningTimer;
 
+    // Scan priority - filesToScan is ordered session files, recent files, then the rest
+    enum class ScanPriority { session, recent, background };
+    int numSessionFiles = 0;
+    int numPriorityFiles = 0;
+    juce::ValueTree pendingSessionState;
+    static constexpr int priorityScanIntervalMs = 1;
+    static constexpr int backgroundScanIntervalMs = 20;
+
+    // Shell enumeration cache (persists between scans and launches)
+    PluginScanCache scanCache;
+    ScanStatistics scanStatistics;
+    juce::int64 scanStartTicks = 0;
+
+    // Binary header probe, cached per file so rescans don't touch unchanged binaries
+    BinaryArchitecture architectureProbe;
+
     // Helper methods
-    PluginInfo createPluginInfo(const juce::PluginDescription &description);
+    PluginCatalog::Record createCatalogRecord(const juce::PluginDescription &description,
+                                              const juce::String &architecture) const;
+    bool findAvailablePlugin(const juce::String &identifierOrPath, PluginInfo &result) const;
+    static juce::ValueTree createPluginState(const PluginInstance &instance, const juce::MemoryBlock &stateBlock);
+    std::unique_ptr<PluginInstance> createPluginInstance(const PluginInfo &pluginInfo);
+    bool addPluginToChain(const PluginInfo &pluginInfo); // loadPlugin without noting the use
+    PluginInfo getPluginInfoFromState(const juce::ValueTree &pluginState) const;
+    static void restorePluginState(PluginInstance &instance, const juce::ValueTree &pluginState);
+
+    // Audio processing
+    void processChain(juce::OwnedArray<PluginInstance> &chain, juce::AudioBuffer<float> &buffer);
+    void processWithCrossfade(juce::AudioBuffer<float> &buffer);
+    static void processPlugin(PluginInstance &plugin, juce::AudioBuffer<float> &buffer);
+    void measureSlot(SlotMeter &meter, const juce::AudioBuffer<float> &buffer, bool isOutput);
+    void guardSlot(SlotGuard &guard, juce::AudioBuffer<float> &buffer, juce::int64 processTicks);
+    void reportGuardRepairs();
+
+    // Snapshots
+    // Loads and prepares a chain without holding pluginLock, returning the prepareGeneration it was
+    // prepared for. Before swapping it in, call prepareChainIfStale with pluginLock held.
+    int instantiateChain(const juce::ValueTree &state, juce::OwnedArray<PluginInstance> &chain);
+    void prepareChainIfStale(juce::OwnedArray<PluginInstance> &chain, int preparedGeneration);
+    static void suspendChain(juce::OwnedArray<PluginInstance> &chain);
+    void finishCrossfade();
+    void handleAsyncUpdate() override;
     bool validatePlugin(juce::AudioProcessor *processor);
     void initializePlugin(PluginInstance *instance);
 
+    // Channel layouts
+    void preparePlugin(PluginInstance &instance);
+    void preparePlugin(PluginInstance &instance, double sampleRate, int blockSize, int numChannels);
+    void applyBusLayout(PluginInstance &instance, int numChannels);
+    static juce::AudioProcessor::BusesLayout negotiateBusLayout(const juce::AudioProcessor &processor,
+                                                                int numChannels);
+
     // Architecture detection
     bool isHostArchitecture64Bit() const;
     bool isPluginArchitectureCompatible(const juce::File &pluginFile) const;
+    bool isArchitectureCompatible(const juce::String &architecture) const;
+    juce::String getHostArchitecture() const;
     juce::String getPluginArchitecture(const juce::File &pluginFile) const;
-    juce::String analyzeWindowsPEArchitecture(const juce::File &pluginFile) const;
-    juce::String analyzeMacBinaryArchitecture(const juce::File &binaryFile) const;
+    juce::File findBundleBinary(const juce::File &bundleFile) const;
 
     // Consolidated plugin scanning
-    void scanPluginsInPaths(const juce::StringArray &searchPaths, juce::Array<PluginInfo> &pluginList);
+    void scanPluginsInPaths(const juce::StringArray &searchPaths);
+    juce::Array<juce::File> findPluginFiles(const juce::StringArray &searchPaths) const; // Files and bundles
     void startPluginScan();
     void scanNextPlugin();
+    void sortFilesToScanByPriority();
+    void restorePendingSession();
 
     // Format-specific processing
-    void processPluginFile(const juce::File &pluginFile, juce::AudioPluginFormat *format, juce::Array<PluginInfo> &pluginList);
-    void processPluginBundle(const juce::File &bundleFile, juce::AudioPluginFormat *format, juce::Array<PluginInfo> &pluginList);
+    void processPluginFile(const juce::File &pluginFile, juce::AudioPluginFormat *format);
+    void processPluginBundle(const juce::File &bundleFile, juce::AudioPluginFormat *format);
+    void addPluginsFromShell(const juce::File &shellFile, juce::AudioPluginFormat *format,
+                             const juce::String &architecture);
+    void addShellToCatalog(const juce::File &shellFile, const juce::String &formatName, const juce::String &architecture,
+                           const juce::Array<juce::PluginDescription> &descriptions);
     juce::Array<PluginFormatInfo> getSupportedFormats() const;
     juce::AudioPluginFormat* getFormatForFile(const juce::File &pluginFile) const;
 
@@ -0,0 +1,196 @@
+#include "PluginScanCache.h"
+
+//==============================================================================
+PluginScanCache::PluginScanCache() : cacheFile(getDefaultCacheFile()) {}
+
+PluginScanCache::~PluginScanCache() = default;
+
+//==============================================================================
+bool PluginScanCache::getDescriptions(const juce::File &shellFile, const juce::String &formatName,
+                                      juce::Array<juce::PluginDescription> &descriptions) const {
+    juce::ScopedLock lock(cacheLock);
+
+    auto it = shells.find(shellFile.getFullPathName());
+    if (it == shells.end() || it->second.formatName != formatName)
+        return false;
+
+    // The shell binary changed since it was enumerated, the cached entry is stale
+    if (it->second.identity != getFileIdentity(shellFile)) {
+        DBG("    Cached shell entry is stale: " + shellFile.getFullPathName());
+        return false;
+    }
+
+    descriptions = it->second.descriptions;
+    return true;
+}
+
+void PluginScanCache::storeDescriptions(const juce::File &shellFile, const juce::String &formatName,
+                                        const juce::String &architecture,
+                                        const juce::Array<juce::PluginDescription> &descriptions) {
+    ShellEntry entry;
+    entry.formatName = formatName;
+    entry.architecture = architecture;
+    entry.identity = getFileIdentity(shellFile);
+    entry.descriptions = descriptions;
+
+    juce::ScopedLock lock(cacheLock);
+    shells[shellFile.getFullPathName()] = std::move(entry);
+    isDirty = true;
+}
+
+void PluginScanCache::invalidate(const juce::File &shellFile) {
+    juce::ScopedLock lock(cacheLock);
+
+    if (shells.erase(shellFile.getFullPathName()) > 0)
+        isDirty = true;
+}
+
+void PluginScanCache::clear() {
+    juce::ScopedLock lock(cacheLock);
+    shells.clear();
+    isDirty = true;
+}
+
+int PluginScanCache::getNumShells() const {
+    juce::ScopedLock lock(cacheLock);
+    return (int)shells.size();
+}
+
+bool PluginScanCache::contains(const juce::File &shellFile) const {
+    juce::ScopedLock lock(cacheLock);
+    return shells.find(shellFile.getFullPathName()) != shells.end();
+}
+
+void PluginScanCache::removeMissingShells() {
+    juce::ScopedLock lock(cacheLock);
+
+    for (auto it = shells.begin(); it != shells.end();) {
+        if (!juce::File(it->first).exists()) {
+            it = shells.erase(it);
+            isDirty = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+juce::Array<PluginScanCache::CachedShell> PluginScanCache::getValidShells(int &numStale) const {
+    juce::Array<CachedShell> validShells;
+    numStale = 0;
+
+    juce::ScopedLock lock(cacheLock);
+
+    for (const auto &[path, entry] : shells) {
+        // Uninstalled plugins just drop out, changed ones need enumerating again
+        juce::File shellFile(path);
+        if (!shellFile.exists())
+            continue;
+
+        if (entry.identity != getFileIdentity(shellFile)) {
+            ++numStale;
+            continue;
+        }
+
+        validShells.add({shellFile, entry.formatName, entry.architecture, entry.descriptions});
+    }
+
+    return validShells;
+}
+
+//==============================================================================
+void PluginScanCache::setCacheFile(const juce::File &file) {
+    juce::ScopedLock lock(cacheLock);
+    cacheFile = file;
+}
+
+bool PluginScanCache::saveToFile() const {
+    juce::ScopedLock lock(cacheLock);
+
+    if (!isDirty && cacheFile.existsAsFile())
+        return true;
+
+    juce::XmlElement cache("AudioChainPluginCache");
+    cache.setAttribute("version", 1);
+
+    for (const auto &[path, entry] : shells) {
+        auto *shellElement = cache.createNewChildElement("Shell");
+        shellElement->setAttribute("file", path);
+        shellElement->setAttribute("format", entry.formatName);
+        shellElement->setAttribute("architecture", entry.architecture);
+        shellElement->setAttribute("modified", juce::String(entry.identity.lastModified.toMilliseconds()));
+        shellElement->setAttribute("size", juce::String(entry.identity.size));
+
+        for (const auto &description : entry.descriptions) {
+            if (auto xml = description.createXml())
+                shellElement->addChildElement(xml.release());
+        }
+    }
+
+    cacheFile.getParentDirectory().createDirectory();
+    if (!cache.writeTo(cacheFile)) {
+        DBG("Failed to write plugin cache: " + cacheFile.getFullPathName());
+        return false;
+    }
+
+    isDirty = false;
+    DBG("Saved plugin cache with " + juce::String((int)shells.size()) + " shells to " + cacheFile.getFullPathName());
+    return true;
+}
+
+void PluginScanCache::loadFromFile() {
+    juce::ScopedLock lock(cacheLock);
+
+    if (!cacheFile.existsAsFile())
+        return;
+
+    auto cache = juce::XmlDocument::parse(cacheFile);
+    if (cache == nullptr || !cache->hasTagName("AudioChainPluginCache"))
+        return;
+
+    shells.clear();
+
+    for (auto *shellElement : cache->getChildWithTagNameIterator("Shell")) {
+        ShellEntry entry;
+        entry.formatName = shellElement->getStringAttribute("format");
+        entry.architecture = shellElement->getStringAttribute("architecture");
+        entry.identity.lastModified = juce::Time(shellElement->getStringAttribute("modified").getLargeIntValue());
+        entry.identity.size = shellElement->getStringAttribute("size").getLargeIntValue();
+
+        for (auto *descriptionElement : shellElement->getChildIterator()) {
+            juce::PluginDescription description;
+            if (description.loadFromXml(*descriptionElement))
+                entry.descriptions.add(description);
+        }
+
+        shells[shellElement->getStringAttribute("file")] = std::move(entry);
+    }
+
+    isDirty = false;
+    DBG("Loaded plugin cache with " + juce::String((int)shells.size()) + " shells");
+}
+
+//==============================================================================
+PluginScanCache::FileIdentity PluginScanCache::getFileIdentity(const juce::File &shellFile) {
+    FileIdentity identity;
+
+    if (shellFile.isDirectory()) {
+        // Bundle directories keep their timestamp when the binary inside is replaced,
+        // so identify them by the newest file and the total size of their contents
+        for (const auto &entry : juce::RangedDirectoryIterator(shellFile, true, "*", juce::File::findFiles)) {
+            identity.size += entry.getFileSize();
+            if (entry.getModificationTime() > identity.lastModified)
+                identity.lastModified = entry.getModificationTime();
+        }
+    } else {
+        identity.lastModified = shellFile.getLastModificationTime();
+        identity.size = shellFile.getSize();
+    }
+
+    return identity;
+}
+
+juce::File PluginScanCache::getDefaultCacheFile() {
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("AudioChain")
+        .getChildFile("plugin-cache.xml");
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_core/juce_core.h>
+#include <map>
+
+//==============================================================================
+/**
+    Persistent cache of plugin shell enumerations.
+
+    A shell is a plugin file or bundle that can expose any number of plugins
+    (WaveShell-style VST binaries, multi-effect VST3 bundles, AU components...).
+    Enumerating a shell through findAllTypesForFile is expensive, so the full
+    result is cached as one unit, keyed by the shell path, and is only
+    invalidated when the shell binary itself changes (modification time or size).
+*/
+class PluginScanCache {
+  public:
+    //==============================================================================
+    struct FileIdentity {
+        juce::Time lastModified;
+        juce::int64 size = 0;
+
+        bool operator==(const FileIdentity &other) const {
+            return lastModified == other.lastModified && size == other.size;
+        }
+        bool operator!=(const FileIdentity &other) const { return !operator==(other); }
+    };
+
+    // A cached shell enumeration, as returned by getValidShells
+    struct CachedShell {
+        juce::File file;
+        juce::String formatName;
+        juce::String architecture;
+        juce::Array<juce::PluginDescription> descriptions;
+    };
+
+    //==============================================================================
+    PluginScanCache();
+    ~PluginScanCache();
+
+    // Shell lookups - return false if the shell is unknown or has changed on disk
+    bool getDescriptions(const juce::File &shellFile, const juce::String &formatName,
+                         juce::Array<juce::PluginDescription> &descriptions) const;
+    void storeDescriptions(const juce::File &shellFile, const juce::String &formatName,
+                           const juce::String &architecture, const juce::Array<juce::PluginDescription> &descriptions);
+    void invalidate(const juce::File &shellFile);
+    void clear();
+
+    int getNumShells() const;
+    bool contains(const juce::File &shellFile) const; // Enumerated, whether it changed since or not
+
+    // Every cached shell still on disk. Shells that changed since they were
+    // enumerated are left out and counted in numStale.
+    juce::Array<CachedShell> getValidShells(int &numStale) const;
+    void removeMissingShells();
+
+    // Persistence
+    void setCacheFile(const juce::File &file);
+    juce::File getCacheFile() const { return cacheFile; }
+    bool saveToFile() const; // False if the file couldn't be written
+    void loadFromFile();
+
+    // Identity of a shell on disk. Bundles are identified by the files they contain.
+    static FileIdentity getFileIdentity(const juce::File &shellFile);
+    static juce::File getDefaultCacheFile();
+
+  private:
+    //==============================================================================
+    struct ShellEntry {
+        juce::String formatName;
+        juce::String architecture;
+        FileIdentity identity;
+        juce::Array<juce::PluginDescription> descriptions;
+    };
+
+    std::map<juce::String, ShellEntry> shells;
+    juce::File cacheFile;
+    mutable bool isDirty = false;
+
+    // Cache has its own lock so it never contends with audio processing
+    juce::CriticalSection cacheLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginScanCache)
+};
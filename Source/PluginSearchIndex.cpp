@@ -0,0 +1,264 @@
+#include "PluginSearchIndex.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Fraction of a term's trigrams an entry must contain to count as a fuzzy match
+constexpr float fuzzyMatchThreshold = 0.6f;
+
+// Match quality scores, per query term
+constexpr float nameStartScore = 100.0f;
+constexpr float nameWordStartScore = 70.0f;
+constexpr float otherWordStartScore = 50.0f;
+constexpr float substringScore = 30.0f;
+constexpr float fuzzyScore = 20.0f;
+constexpr float usageScore = 25.0f;
+
+bool hasWordStartingWith(const juce::String &text, const juce::String &prefix) {
+    for (int index = text.indexOf(prefix); index >= 0; index = text.indexOf(index + 1, prefix)) {
+        if (index == 0 || !juce::CharacterFunctions::isLetterOrDigit(text[index - 1]))
+            return true;
+    }
+    return false;
+}
+} // namespace
+
+//==============================================================================
+PluginSearchIndex::PluginSearchIndex() = default;
+
+PluginSearchIndex::~PluginSearchIndex() = default;
+
+//==============================================================================
+bool PluginSearchIndex::update(const PluginCatalog::View &view) {
+    auto changed = false;
+
+    // A rescan starts a new catalog generation, whose indices don't match ours
+    if (view.getGeneration() != indexedGeneration || view.size() < size()) {
+        changed = !entries.empty();
+        clear();
+        indexedGeneration = view.getGeneration();
+    }
+
+    for (int i = size(); i < view.size(); ++i) {
+        addEntry(view[i]);
+        changed = true;
+    }
+
+    return changed;
+}
+
+void PluginSearchIndex::clear() {
+    entries.clear();
+    trigrams.clear();
+    words.clear();
+    indexedGeneration = 0;
+}
+
+void PluginSearchIndex::setRecentUsage(const UserConfig::PluginUsageMap &usage) {
+    recentUsage = usage;
+
+    for (auto &entry : entries)
+        entry.usageBoost = getUsageBoost(entry.identifier);
+}
+
+//==============================================================================
+void PluginSearchIndex::addEntry(const PluginCatalog::Record &record) {
+    auto entryIndex = (int)entries.size();
+
+    Entry entry;
+    entry.identifier = record.identifier;
+    entry.name = record.name.toLowerCase();
+    entry.manufacturer = record.manufacturer.toLowerCase();
+    entry.format = record.formatName.toLowerCase();
+    entry.displayName = record.name.toUpperCase();
+    entry.displayFormat = record.formatName.toUpperCase();
+    entry.usageBoost = getUsageBoost(record.identifier);
+
+    // Entries are added in ascending order, so posting lists stay sorted and only
+    // need checking against their last element for duplicates
+    for (auto key : getTrigrams(entry.name + " " + entry.manufacturer + " " + entry.format, true)) {
+        auto &postings = trigrams[key];
+        if (postings.empty() || postings.back() != entryIndex)
+            postings.push_back(entryIndex);
+    }
+
+    for (const auto &field : {entry.name, entry.manufacturer, entry.format}) {
+        for (const auto &word : tokenise(field)) {
+            auto &postings = words[word];
+            if (postings.empty() || postings.back() != entryIndex)
+                postings.push_back(entryIndex);
+        }
+    }
+
+    entries.push_back(std::move(entry));
+}
+
+float PluginSearchIndex::getUsageBoost(const juce::String &identifier) const {
+    auto it = recentUsage.find(identifier);
+    if (it == recentUsage.end())
+        return 0.0f;
+
+    // Frequency counts logarithmically, recency decays over about a week
+    auto daysSinceUsed = (juce::Time::getCurrentTime() - it->second.lastUsed).inDays();
+    auto frequency = std::log2(1.0f + (float)it->second.useCount) / 4.0f;
+    auto recency = 1.0f / (1.0f + (float)juce::jmax(0.0, daysSinceUsed) / 7.0f);
+
+    return usageScore * (juce::jmin(1.0f, frequency) + recency) * 0.5f;
+}
+
+//==============================================================================
+std::vector<int> PluginSearchIndex::search(const juce::String &query, int maxResults) const {
+    std::vector<int> results;
+    auto terms = tokenise(query.toLowerCase());
+
+    auto byScore = [this](int a, int b) {
+        if (scores[(size_t)a] != scores[(size_t)b])
+            return scores[(size_t)a] > scores[(size_t)b];
+        return a < b;
+    };
+
+    scores.assign(entries.size(), 0.0f);
+
+    if (terms.isEmpty()) {
+        results.resize(entries.size());
+        for (int i = 0; i < size(); ++i) {
+            results[(size_t)i] = i;
+            scores[(size_t)i] = entries[(size_t)i].usageBoost;
+        }
+    } else {
+        termsMatched.assign(entries.size(), 0);
+        touched.clear();
+
+        // Every term has to match (AND), each adding its match score
+        for (int termIndex = 0; termIndex < terms.size(); ++termIndex) {
+            findTermMatches(terms[termIndex], [&](int entryIndex, float score) {
+                auto &matched = termsMatched[(size_t)entryIndex];
+                if (matched != termIndex)
+                    return;
+
+                if (termIndex == 0)
+                    touched.push_back(entryIndex);
+
+                ++matched;
+                scores[(size_t)entryIndex] += score;
+            });
+        }
+
+        for (auto entryIndex : touched) {
+            if (termsMatched[(size_t)entryIndex] == terms.size()) {
+                scores[(size_t)entryIndex] += entries[(size_t)entryIndex].usageBoost;
+                results.push_back(entryIndex);
+            }
+        }
+    }
+
+    // Only the visible part of the list needs to be fully ordered
+    if (maxResults >= 0 && maxResults < (int)results.size()) {
+        std::partial_sort(results.begin(), results.begin() + maxResults, results.end(), byScore);
+        results.resize((size_t)maxResults);
+    } else {
+        std::sort(results.begin(), results.end(), byScore);
+    }
+
+    return results;
+}
+
+template <typename Callback>
+void PluginSearchIndex::findTermMatches(const juce::String &term, Callback &&addMatch) const {
+    termCandidates.clear();
+
+    if (term.length() < 3) {
+        // Too short for trigrams - use the word prefix index
+        for (auto it = words.lower_bound(term); it != words.end() && it->first.startsWith(term); ++it)
+            termCandidates.insert(termCandidates.end(), it->second.begin(), it->second.end());
+
+        std::sort(termCandidates.begin(), termCandidates.end());
+        termCandidates.erase(std::unique(termCandidates.begin(), termCandidates.end()), termCandidates.end());
+    } else {
+        auto termTrigrams = getTrigrams(term, false);
+        auto requiredHits = juce::jmax(1, (int)std::ceil((float)termTrigrams.size() * fuzzyMatchThreshold));
+
+        // Count how many of the term's trigrams each entry contains
+        trigramHits.resize(entries.size(), 0);
+        for (auto key : termTrigrams) {
+            auto it = trigrams.find(key);
+            if (it == trigrams.end())
+                continue;
+
+            for (auto entryIndex : it->second) {
+                if (trigramHits[(size_t)entryIndex]++ == 0)
+                    termCandidates.push_back(entryIndex);
+            }
+        }
+
+        // Report candidates sharing enough trigrams, resetting the counters for the next term
+        for (auto entryIndex : termCandidates) {
+            auto &hits = trigramHits[(size_t)entryIndex];
+            if (hits >= requiredHits) {
+                auto score = scoreTerm(entries[(size_t)entryIndex], term);
+                addMatch(entryIndex, score > 0.0f ? score : fuzzyScore * (float)hits / (float)termTrigrams.size());
+            }
+            hits = 0;
+        }
+        return;
+    }
+
+    for (auto entryIndex : termCandidates)
+        addMatch(entryIndex, scoreTerm(entries[(size_t)entryIndex], term));
+}
+
+float PluginSearchIndex::scoreTerm(const Entry &entry, const juce::String &term) const {
+    if (entry.name.startsWith(term))
+        return nameStartScore;
+    if (hasWordStartingWith(entry.name, term))
+        return nameWordStartScore;
+    if (hasWordStartingWith(entry.manufacturer, term) || hasWordStartingWith(entry.format, term))
+        return otherWordStartScore;
+    if (entry.name.contains(term) || entry.manufacturer.contains(term) || entry.format.contains(term))
+        return substringScore;
+
+    return 0.0f;
+}
+
+//==============================================================================
+juce::StringArray PluginSearchIndex::tokenise(const juce::String &foldedText) {
+    juce::StringArray tokens;
+    juce::String currentToken;
+
+    for (auto character : foldedText) {
+        if (juce::CharacterFunctions::isLetterOrDigit(character)) {
+            currentToken += character;
+        } else if (currentToken.isNotEmpty()) {
+            tokens.add(currentToken);
+            currentToken.clear();
+        }
+    }
+
+    if (currentToken.isNotEmpty())
+        tokens.add(currentToken);
+
+    return tokens;
+}
+
+std::vector<PluginSearchIndex::TrigramKey> PluginSearchIndex::getTrigrams(const juce::String &foldedText,
+                                                                          bool includeWordStart) {
+    std::vector<TrigramKey> keys;
+
+    // Unicode code points fit in 21 bits, so three of them pack into one 63-bit key
+    constexpr TrigramKey keyMask = ((TrigramKey)1 << 63) - 1;
+
+    // A leading space gives the start of the text a trigram of its own
+    TrigramKey window = includeWordStart ? (TrigramKey)' ' : 0;
+    int windowLength = includeWordStart ? 1 : 0;
+
+    for (auto character : foldedText) {
+        window = ((window << 21) | (TrigramKey)(character & 0x1fffff)) & keyMask;
+
+        if (++windowLength >= 3)
+            keys.push_back(window);
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "PluginCatalog.h"
+#include "UserConfig.h"
+#include <juce_core/juce_core.h>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+//==============================================================================
+/**
+    Search index over the plugin catalog, used by the plugin browser.
+
+    - Trigram index for substring and typo-tolerant (fuzzy) matching
+    - Word prefix index for short queries (one or two characters)
+    - Indexes name, manufacturer and format
+    - Updated incrementally from catalog views while a scan is running
+    - Results are ranked by match quality, then by recent usage
+
+    Display strings for the browser rows are built once here, so painting a row
+    doesn't do any string work. Not thread safe - owned and used by the message thread.
+*/
+class PluginSearchIndex {
+  public:
+    //==============================================================================
+    PluginSearchIndex();
+    ~PluginSearchIndex();
+
+    // Indexes records added to the catalog since the last update. A view from a
+    // new catalog generation rebuilds the index. Returns true if anything changed.
+    bool update(const PluginCatalog::View &view);
+    void clear();
+
+    // Ranking boost for recently and frequently used plugins
+    void setRecentUsage(const UserConfig::PluginUsageMap &usage);
+
+    // Returns catalog indices of matching plugins, best match first.
+    // An empty query returns every plugin, recently used ones first.
+    std::vector<int> search(const juce::String &query, int maxResults = -1) const;
+
+    int size() const noexcept { return (int)entries.size(); }
+
+    // Preformatted row text
+    const juce::String &getDisplayName(int index) const { return entries[(size_t)index].displayName; }
+    const juce::String &getDisplayFormat(int index) const { return entries[(size_t)index].displayFormat; }
+
+  private:
+    //==============================================================================
+    struct Entry {
+        juce::String identifier;
+        juce::String name;         // Folded (lower case)
+        juce::String manufacturer; // Folded
+        juce::String format;       // Folded
+        juce::String displayName;
+        juce::String displayFormat;
+        float usageBoost = 0.0f;
+    };
+
+    using TrigramKey = juce::uint64;
+
+    std::vector<Entry> entries;
+    std::unordered_map<TrigramKey, std::vector<int>> trigrams; // Posting lists, ascending entry order
+    std::map<juce::String, std::vector<int>> words;            // Sorted, for prefix range scans
+    UserConfig::PluginUsageMap recentUsage;
+    juce::uint32 indexedGeneration = 0;
+
+    // Scratch space reused between searches
+    mutable std::vector<float> scores;
+    mutable std::vector<juce::uint16> termsMatched;
+    mutable std::vector<juce::uint16> trigramHits;
+    mutable std::vector<int> touched;
+    mutable std::vector<int> termCandidates;
+
+    void addEntry(const PluginCatalog::Record &record);
+    float getUsageBoost(const juce::String &identifier) const;
+
+    // Calls addMatch(entryIndex, score) for every entry matching a single query term
+    template <typename Callback> void findTermMatches(const juce::String &term, Callback &&addMatch) const;
+    float scoreTerm(const Entry &entry, const juce::String &term) const;
+
+    static juce::StringArray tokenise(const juce::String &foldedText);
+    static std::vector<TrigramKey> getTrigrams(const juce::String &foldedText, bool includeWordStart);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginSearchIndex)
+};
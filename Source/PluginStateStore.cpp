@@ -0,0 +1,152 @@
+#include "PluginStateStore.h"
+#include <juce_cryptography/juce_cryptography.h>
+
+//==============================================================================
+PluginStateStore::PluginStateStore(const juce::File &storeDirectory) : directory(storeDirectory) {}
+
+PluginStateStore::~PluginStateStore() = default;
+
+PluginStateStore &PluginStateStore::getInstance() {
+    static PluginStateStore instance(getDefaultDirectory());
+    return instance;
+}
+
+juce::File PluginStateStore::getDefaultDirectory() {
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("AudioChain")
+        .getChildFile("states");
+}
+
+//==============================================================================
+juce::String PluginStateStore::store(const juce::MemoryBlock &state) {
+    auto hash = getHash(state.getData(), state.getSize());
+    auto blobFile = getBlobFile(hash);
+
+    // File I/O happens outside the lock. Two threads storing the same blob both write it, and
+    // the rename leaves one complete copy. If the blob is already stored it's just marked as in
+    // use so it isn't collected - that fails if it was collected meanwhile, and it's written again.
+    if (!blobFile.existsAsFile() || !blobFile.setLastModificationTime(juce::Time::getCurrentTime())) {
+        blobFile.getParentDirectory().createDirectory();
+
+        // Written under a temporary name, so a blob file is always complete
+        juce::TemporaryFile tempFile(blobFile);
+        if (!tempFile.getFile().replaceWithData(state.getData(), state.getSize()) ||
+            !tempFile.overwriteTargetFileWithTemporary()) {
+            DBG("Failed to store plugin state blob " + hash);
+            return {};
+        }
+    }
+
+    // Loading it again later won't touch the disk, whether it was just written or already there
+    const juce::ScopedLock lock(storeLock);
+    if (loadedBlobs.count(hash) == 0)
+        addLoadedBlob(hash, std::make_shared<const juce::MemoryBlock>(state));
+    return hash;
+}
+
+PluginStateStore::Blob PluginStateStore::load(const juce::String &hash) {
+    if (!isValidHash(hash))
+        return nullptr;
+
+    {
+        const juce::ScopedLock lock(storeLock);
+        auto it = loadedBlobs.find(hash);
+        if (it != loadedBlobs.end())
+            return it->second;
+    }
+
+    // Read and verified outside the lock, like store() writes
+    auto blobFile = getBlobFile(hash);
+    auto data = std::make_shared<juce::MemoryBlock>();
+    if (!blobFile.loadFileAsData(*data)) {
+        DBG("Plugin state blob missing: " + hash);
+        return nullptr;
+    }
+
+    if (getHash(data->getData(), data->getSize()) != hash) {
+        DBG("Plugin state blob damaged: " + hash);
+        return nullptr;
+    }
+
+    blobFile.setLastModificationTime(juce::Time::getCurrentTime());
+
+    const juce::ScopedLock lock(storeLock);
+
+    // Another thread may have loaded it meanwhile - keep one copy in memory
+    auto it = loadedBlobs.find(hash);
+    if (it != loadedBlobs.end())
+        return it->second;
+
+    Blob blob = std::move(data);
+    addLoadedBlob(hash, blob);
+    return blob;
+}
+
+bool PluginStateStore::contains(const juce::String &hash) const {
+    return isValidHash(hash) && getBlobFile(hash).existsAsFile();
+}
+
+int PluginStateStore::removeUnreferenced(const juce::StringArray &referencedHashes, juce::RelativeTime minimumAge) {
+    auto cutoff = juce::Time::getCurrentTime() - minimumAge;
+    int numRemoved = 0;
+
+    // The directory is walked without the lock, so storing and loading carry on meanwhile
+    for (const auto &entry : juce::RangedDirectoryIterator(directory, true, "*", juce::File::findFiles)) {
+        auto blobFile = entry.getFile();
+        auto hash = blobFile.getFileName();
+
+        if (!isValidHash(hash) || referencedHashes.contains(hash) || entry.getModificationTime() > cutoff)
+            continue;
+
+        // Checked again right before deleting, in case it was stored or loaded since the walk started
+        if (blobFile.getLastModificationTime() > cutoff || !blobFile.deleteFile())
+            continue;
+
+        const juce::ScopedLock lock(storeLock);
+        auto loaded = loadedBlobs.find(hash);
+        if (loaded != loadedBlobs.end()) {
+            loadedBytes -= loaded->second->getSize();
+            loadedBlobs.erase(loaded);
+        }
+        ++numRemoved;
+    }
+
+    if (numRemoved > 0)
+        DBG("Removed " + juce::String(numRemoved) + " unreferenced plugin state blobs");
+
+    return numRemoved;
+}
+
+//==============================================================================
+juce::String PluginStateStore::getHash(const void *data, size_t size) {
+    return juce::SHA256(data, size).toHexString();
+}
+
+juce::File PluginStateStore::getBlobFile(const juce::String &hash) const {
+    return directory.getChildFile(hash.substring(0, 2)).getChildFile(hash);
+}
+
+void PluginStateStore::addLoadedBlob(const juce::String &hash, Blob blob) {
+    if (loadedBlobs.count(hash) > 0)
+        return;
+
+    loadedBytes += blob->getSize();
+    loadedBlobs[hash] = std::move(blob);
+
+    if (loadedBytes <= maxLoadedBytes)
+        return;
+
+    // Over budget - forget blobs that nothing outside the store holds on to
+    for (auto it = loadedBlobs.begin(); it != loadedBlobs.end() && loadedBytes > maxLoadedBytes;) {
+        if (it->second.use_count() == 1) {
+            loadedBytes -= it->second->getSize();
+            it = loadedBlobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool PluginStateStore::isValidHash(const juce::String &hash) {
+    return hash.length() == 64 && hash.containsOnly("0123456789abcdef");
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <map>
+#include <memory>
+
+//==============================================================================
+/**
+    Content-addressed store for plugin state blobs.
+
+    Large states (convolution IRs, sampler data...) are often identical across
+    sessions, snapshots and autosaves. Each blob is stored once, in a file named
+    after the SHA-256 of its contents, and session files refer to it by hash.
+
+    - store() skips the write if the blob is already there, so autosaves only
+      write states that actually changed
+    - load() verifies the hash and keeps the blob in memory, so identical states
+      are read from disk once per process
+    - removeUnreferenced() deletes blobs nothing refers to any more
+
+    Thread safe. Blobs live in AudioChain/states, fanned out by the first two hash digits.
+*/
+class PluginStateStore {
+  public:
+    //==============================================================================
+    using Blob = std::shared_ptr<const juce::MemoryBlock>;
+
+    explicit PluginStateStore(const juce::File &storeDirectory);
+    ~PluginStateStore();
+
+    // Shared store in the default location
+    static PluginStateStore &getInstance();
+    static juce::File getDefaultDirectory();
+
+    // Returns the blob's hash, or an empty string if it couldn't be written
+    juce::String store(const juce::MemoryBlock &state);
+
+    // Returns nullptr if the blob is missing or damaged
+    Blob load(const juce::String &hash);
+
+    bool contains(const juce::String &hash) const;
+
+    // Deletes blobs that aren't in referencedHashes and haven't been stored or
+    // loaded for at least minimumAge (other instances may still be using newer ones)
+    int removeUnreferenced(const juce::StringArray &referencedHashes, juce::RelativeTime minimumAge);
+
+    static juce::String getHash(const void *data, size_t size);
+
+  private:
+    //==============================================================================
+    const juce::File directory;
+
+    std::map<juce::String, Blob> loadedBlobs;
+    size_t loadedBytes = 0;
+    juce::CriticalSection storeLock;
+
+    // Blobs nobody else holds are dropped from memory beyond this
+    static constexpr size_t maxLoadedBytes = 256 * 1024 * 1024;
+
+    juce::File getBlobFile(const juce::String &hash) const;
+    void addLoadedBlob(const juce::String &hash, Blob blob);
+    static bool isValidHash(const juce::String &hash);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginStateStore)
+};
@@ -0,0 +1,303 @@
+#include "RealFFT.h"
+
+#if JUCE_INTEL
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define AUDIOCHAIN_TARGET(isa) __attribute__((target(isa)))
+#else
+#define AUDIOCHAIN_TARGET(isa)
+#endif
+#define AUDIOCHAIN_FFT_X86 1
+#elif JUCE_ARM && (defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define AUDIOCHAIN_FFT_NEON 1
+#endif
+
+namespace {
+//==============================================================================
+// One row of butterflies, count of them with the same twiddle:
+//   y0 = a + b, y1 = (a - b) * w
+struct Row {
+    const float *aReal, *aImag, *bReal, *bImag;
+    float *y0Real, *y0Imag, *y1Real, *y1Imag;
+    float wReal, wImag;
+};
+
+void butterfliesScalar(const Row &row, int start, int count) {
+    for (int q = start; q < count; ++q) {
+        auto differenceReal = row.aReal[q] - row.bReal[q];
+        auto differenceImag = row.aImag[q] - row.bImag[q];
+
+        row.y0Real[q] = row.aReal[q] + row.bReal[q];
+        row.y0Imag[q] = row.aImag[q] + row.bImag[q];
+        row.y1Real[q] = differenceReal * row.wReal - differenceImag * row.wImag;
+        row.y1Imag[q] = differenceReal * row.wImag + differenceImag * row.wReal;
+    }
+}
+
+#if AUDIOCHAIN_FFT_X86
+AUDIOCHAIN_TARGET("sse2") void butterfliesSSE2(const Row &row, int count) {
+    auto wReal = _mm_set1_ps(row.wReal);
+    auto wImag = _mm_set1_ps(row.wImag);
+    auto numVectorised = count & ~3;
+
+    for (int q = 0; q < numVectorised; q += 4) {
+        auto aReal = _mm_loadu_ps(row.aReal + q), aImag = _mm_loadu_ps(row.aImag + q);
+        auto bReal = _mm_loadu_ps(row.bReal + q), bImag = _mm_loadu_ps(row.bImag + q);
+        auto differenceReal = _mm_sub_ps(aReal, bReal);
+        auto differenceImag = _mm_sub_ps(aImag, bImag);
+
+        _mm_storeu_ps(row.y0Real + q, _mm_add_ps(aReal, bReal));
+        _mm_storeu_ps(row.y0Imag + q, _mm_add_ps(aImag, bImag));
+        _mm_storeu_ps(row.y1Real + q, _mm_sub_ps(_mm_mul_ps(differenceReal, wReal), _mm_mul_ps(differenceImag, wImag)));
+        _mm_storeu_ps(row.y1Imag + q, _mm_add_ps(_mm_mul_ps(differenceReal, wImag), _mm_mul_ps(differenceImag, wReal)));
+    }
+
+    butterfliesScalar(row, numVectorised, count);
+}
+
+AUDIOCHAIN_TARGET("avx2,fma") void butterfliesAVX2(const Row &row, int count) {
+    auto wReal = _mm256_set1_ps(row.wReal);
+    auto wImag = _mm256_set1_ps(row.wImag);
+    auto numVectorised = count & ~7;
+
+    for (int q = 0; q < numVectorised; q += 8) {
+        auto aReal = _mm256_loadu_ps(row.aReal + q), aImag = _mm256_loadu_ps(row.aImag + q);
+        auto bReal = _mm256_loadu_ps(row.bReal + q), bImag = _mm256_loadu_ps(row.bImag + q);
+        auto differenceReal = _mm256_sub_ps(aReal, bReal);
+        auto differenceImag = _mm256_sub_ps(aImag, bImag);
+
+        _mm256_storeu_ps(row.y0Real + q, _mm256_add_ps(aReal, bReal));
+        _mm256_storeu_ps(row.y0Imag + q, _mm256_add_ps(aImag, bImag));
+        _mm256_storeu_ps(row.y1Real + q,
+                         _mm256_fmsub_ps(differenceReal, wReal, _mm256_mul_ps(differenceImag, wImag)));
+        _mm256_storeu_ps(row.y1Imag + q,
+                         _mm256_fmadd_ps(differenceReal, wImag, _mm256_mul_ps(differenceImag, wReal)));
+    }
+
+    // The rest of the build may be SSE code, which stalls on dirty upper halves
+    _mm256_zeroupper();
+
+    butterfliesScalar(row, numVectorised, count);
+}
+#endif
+
+#if AUDIOCHAIN_FFT_NEON
+void butterfliesNEON(const Row &row, int count) {
+    auto wReal = vdupq_n_f32(row.wReal);
+    auto wImag = vdupq_n_f32(row.wImag);
+    auto numVectorised = count & ~3;
+
+    for (int q = 0; q < numVectorised; q += 4) {
+        auto aReal = vld1q_f32(row.aReal + q), aImag = vld1q_f32(row.aImag + q);
+        auto bReal = vld1q_f32(row.bReal + q), bImag = vld1q_f32(row.bImag + q);
+        auto differenceReal = vsubq_f32(aReal, bReal);
+        auto differenceImag = vsubq_f32(aImag, bImag);
+
+        vst1q_f32(row.y0Real + q, vaddq_f32(aReal, bReal));
+        vst1q_f32(row.y0Imag + q, vaddq_f32(aImag, bImag));
+        vst1q_f32(row.y1Real + q, vmlsq_f32(vmulq_f32(differenceReal, wReal), differenceImag, wImag));
+        vst1q_f32(row.y1Imag + q, vmlaq_f32(vmulq_f32(differenceReal, wImag), differenceImag, wReal));
+    }
+
+    butterfliesScalar(row, numVectorised, count);
+}
+#endif
+
+void butterfliesScalarRow(const Row &row, int count) { butterfliesScalar(row, 0, count); }
+
+//==============================================================================
+// A whole stage: row p combines inputs p and p + half into outputs 2p and 2p + 1, stride apart.
+// Rows narrower than a vector go through the scalar butterflies.
+template <void (*butterflies)(const Row &, int), int vectorSize>
+void performStage(int half, int stride, const float *twiddleReal, const float *twiddleImag, const float *inReal,
+                  const float *inImag, float *outReal, float *outImag) {
+    auto isVectorised = stride >= vectorSize;
+
+    for (int p = 0; p < half; ++p) {
+        auto input = (size_t)p * (size_t)stride;
+        auto secondInput = (size_t)(p + half) * (size_t)stride;
+        auto output = (size_t)(2 * p) * (size_t)stride;
+
+        Row row;
+        row.aReal = inReal + input;
+        row.aImag = inImag + input;
+        row.bReal = inReal + secondInput;
+        row.bImag = inImag + secondInput;
+        row.y0Real = outReal + output;
+        row.y0Imag = outImag + output;
+        row.y1Real = outReal + output + (size_t)stride;
+        row.y1Imag = outImag + output + (size_t)stride;
+        row.wReal = twiddleReal[p];
+        row.wImag = twiddleImag[p];
+
+        if (isVectorised)
+            butterflies(row, stride);
+        else
+            butterfliesScalar(row, 0, stride);
+    }
+}
+} // namespace
+
+//==============================================================================
+RealFFT::RealFFT(int order, Engine engineToUse) : size(1 << order), engine(engineToUse) {
+    if (engine == Engine::juce) {
+        juceFFT = std::make_unique<juce::dsp::FFT>(order);
+    } else {
+        instructionSet = getBestInstructionSet();
+        createInTreeEngine();
+    }
+}
+
+RealFFT::RealFFT(int order, InstructionSet instructionSetToUse)
+    : size(1 << order), engine(Engine::inTree), instructionSet(instructionSetToUse) {
+    // Only what this CPU supports
+    if (!getSupportedInstructionSets().contains(instructionSet))
+        instructionSet = InstructionSet::scalar;
+
+    createInTreeEngine();
+}
+
+void RealFFT::createInTreeEngine() {
+    jassert(size >= 4);
+
+    // Complex FFT of half the size, one radix-2 stage per halving
+    auto complexSize = size / 2;
+    stages.clear();
+    twiddleReal.clear();
+    twiddleImag.clear();
+
+    for (int length = complexSize, stride = 1; length >= 2; length /= 2, stride *= 2) {
+        Stage stage;
+        stage.half = length / 2;
+        stage.stride = stride;
+        stage.twiddleOffset = twiddleReal.size();
+        stages.push_back(stage);
+
+        for (int p = 0; p < stage.half; ++p) {
+            auto angle = -juce::MathConstants<double>::twoPi * p / length;
+            twiddleReal.push_back((float)std::cos(angle));
+            twiddleImag.push_back((float)std::sin(angle));
+        }
+    }
+
+    // Separating the even and odd samples' spectra: W^k for bins 0 to complexSize
+    splitReal.resize((size_t)complexSize + 1);
+    splitImag.resize((size_t)complexSize + 1);
+    for (int k = 0; k <= complexSize; ++k) {
+        auto angle = -juce::MathConstants<double>::twoPi * k / size;
+        splitReal[(size_t)k] = (float)std::cos(angle);
+        splitImag[(size_t)k] = (float)std::sin(angle);
+    }
+
+    for (int buffer = 0; buffer < 2; ++buffer) {
+        workReal[buffer].assign((size_t)complexSize, 0.0f);
+        workImag[buffer].assign((size_t)complexSize, 0.0f);
+    }
+
+    runStage = getStageFunction(instructionSet);
+}
+
+RealFFT::StageFunction RealFFT::getStageFunction(InstructionSet instructionSetToUse) {
+    switch (instructionSetToUse) {
+#if AUDIOCHAIN_FFT_X86
+    case InstructionSet::avx2:
+        return performStage<butterfliesAVX2, 8>;
+    case InstructionSet::sse2:
+        return performStage<butterfliesSSE2, 4>;
+#endif
+#if AUDIOCHAIN_FFT_NEON
+    case InstructionSet::neon:
+        return performStage<butterfliesNEON, 4>;
+#endif
+    default:
+        return performStage<butterfliesScalarRow, 1>;
+    }
+}
+
+//==============================================================================
+void RealFFT::performForward(float *data) {
+    if (juceFFT != nullptr)
+        juceFFT->performRealOnlyForwardTransform(data, true);
+    else
+        performInTree(data);
+}
+
+void RealFFT::performInTree(float *data) {
+    auto complexSize = size / 2;
+
+    // Even samples are the real parts, odd samples the imaginary parts
+    auto current = 0;
+    auto *real = workReal[0].data();
+    auto *imag = workImag[0].data();
+    for (int k = 0; k < complexSize; ++k) {
+        real[k] = data[2 * k];
+        imag[k] = data[2 * k + 1];
+    }
+
+    for (const auto &stage : stages) {
+        runStage(stage.half, stage.stride, twiddleReal.data() + stage.twiddleOffset,
+                 twiddleImag.data() + stage.twiddleOffset, workReal[current].data(), workImag[current].data(),
+                 workReal[1 - current].data(), workImag[1 - current].data());
+        current = 1 - current;
+    }
+
+    // Z = E + iO, where E and O are the spectra of the even and odd samples:
+    // E[k] = (Z[k] + conj(Z[-k])) / 2, O[k] = (Z[k] - conj(Z[-k])) / 2i, X[k] = E[k] + W^k O[k]
+    real = workReal[current].data();
+    imag = workImag[current].data();
+
+    for (int k = 0; k <= complexSize; ++k) {
+        auto index = k % complexSize;
+        auto mirror = (complexSize - k) % complexSize;
+
+        auto evenReal = 0.5f * (real[index] + real[mirror]);
+        auto evenImag = 0.5f * (imag[index] - imag[mirror]);
+        auto oddReal = 0.5f * (imag[index] + imag[mirror]);
+        auto oddImag = -0.5f * (real[index] - real[mirror]);
+
+        auto wReal = splitReal[(size_t)k], wImag = splitImag[(size_t)k];
+        data[2 * k] = evenReal + oddReal * wReal - oddImag * wImag;
+        data[2 * k + 1] = evenImag + oddReal * wImag + oddImag * wReal;
+    }
+}
+
+//==============================================================================
+RealFFT::Engine RealFFT::getDefaultEngine() {
+#if JUCE_MAC || JUCE_IOS || JUCE_DSP_USE_INTEL_MKL || JUCE_DSP_USE_SHARED_FFTW || JUCE_DSP_USE_STATIC_FFTW
+    return Engine::juce;
+#else
+    return Engine::inTree;
+#endif
+}
+
+RealFFT::InstructionSet RealFFT::getBestInstructionSet() { return getSupportedInstructionSets().getLast(); }
+
+juce::Array<RealFFT::InstructionSet> RealFFT::getSupportedInstructionSets() {
+    // Slowest first
+    juce::Array<InstructionSet> instructionSets{InstructionSet::scalar};
+
+#if AUDIOCHAIN_FFT_X86
+    if (juce::SystemStats::hasSSE2())
+        instructionSets.add(InstructionSet::sse2);
+    if (juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+        instructionSets.add(InstructionSet::avx2);
+#elif AUDIOCHAIN_FFT_NEON
+    instructionSets.add(InstructionSet::neon);
+#endif
+
+    return instructionSets;
+}
+
+juce::String RealFFT::getName(InstructionSet instructionSetToName) {
+    switch (instructionSetToName) {
+    case InstructionSet::sse2:
+        return "sse2";
+    case InstructionSet::avx2:
+        return "avx2";
+    case InstructionSet::neon:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+//==============================================================================
+/**
+    Forward FFT of real signals, from JUCE's engine or our own.
+
+    The in-tree engine computes a size N real FFT as a complex FFT of N / 2
+    points (even samples as real parts, odd ones as imaginary parts) followed
+    by one twiddle pass that separates them. The complex FFT is a radix-2
+    Stockham transform on split real and imaginary arrays: no bit reversal,
+    and every stage from the fourth on runs along contiguous rows, so the
+    butterflies are vector operations.
+
+    The butterflies have AVX2, SSE2 and NEON versions. The best one the CPU
+    supports is picked at runtime, so a generic x86-64 build still uses AVX2
+    where it's there.
+
+    JUCE's engine is the better choice where JUCE has an accelerated one
+    (vDSP on Apple platforms, IPP or FFTW if compiled in); elsewhere it falls
+    back to a generic FFT, which the in-tree engine beats.
+
+    The output layout is the same for both engines, that of
+    juce::dsp::FFT::performRealOnlyForwardTransform(data, true).
+*/
+class RealFFT {
+  public:
+    //==============================================================================
+    enum class Engine { juce, inTree };
+    enum class InstructionSet { scalar, sse2, avx2, neon };
+
+    // Uses the best instruction set for the in-tree engine
+    RealFFT(int order, Engine engine);
+    RealFFT(int order, InstructionSet instructionSet);
+
+    // data holds getSize() samples and has room for 2 * getSize() floats. On return it holds
+    // interleaved real and imaginary parts of bins 0 to getSize() / 2, unscaled.
+    void performForward(float *data);
+
+    int getSize() const { return size; }
+    Engine getEngine() const { return engine; }
+    InstructionSet getInstructionSet() const { return instructionSet; }
+
+    // JUCE's engine where it's accelerated, the in-tree engine otherwise
+    static Engine getDefaultEngine();
+
+    static InstructionSet getBestInstructionSet();
+    static juce::Array<InstructionSet> getSupportedInstructionSets();
+    static juce::String getName(InstructionSet instructionSet);
+
+  private:
+    //==============================================================================
+    // One radix-2 Stockham stage: half length, stride and twiddle offset
+    struct Stage {
+        int half = 0;
+        int stride = 0;
+        size_t twiddleOffset = 0;
+    };
+
+    // Runs one stage from the input to the output arrays
+    using StageFunction = void (*)(int half, int stride, const float *twiddleReal, const float *twiddleImag,
+                                   const float *inReal, const float *inImag, float *outReal, float *outImag);
+
+    const int size;
+    const Engine engine;
+    InstructionSet instructionSet = InstructionSet::scalar;
+
+    std::unique_ptr<juce::dsp::FFT> juceFFT;
+
+    // In-tree engine
+    std::vector<Stage> stages;
+    std::vector<float> twiddleReal, twiddleImag; // Per stage
+    std::vector<float> splitReal, splitImag;     // Post-processing twiddles, one per output bin
+    std::vector<float> workReal[2], workImag[2]; // Stockham ping-pong buffers
+    StageFunction runStage = nullptr;
+
+    void createInTreeEngine();
+    static StageFunction getStageFunction(InstructionSet instructionSet);
+    void performInTree(float *data);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealFFT)
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <thread>
+
+//==============================================================================
+/**
+    Sequence lock for publishing frames of data from one writer thread to any
+    number of readers.
+
+    The writer never waits: it bumps the sequence to an odd number, updates the
+    data in place and bumps it back to even. Readers copy the data and retry if
+    the sequence changed meanwhile, so they always end up with a complete frame
+    and never block the writer. The sequence doubles as a frame version, which
+    tells readers whether anything was published since their last copy.
+
+    The protected data must stay at the same address and size while readers may
+    be copying it - allocate it once, before publishing starts.
+*/
+class SeqLock {
+  public:
+    //==============================================================================
+    // Writer
+    void beginWrite() {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endWrite() { sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Number of frames published so far
+    juce::uint64 getVersion() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+    //==============================================================================
+    /** Calls copyFrame() until it has copied a complete frame.
+
+        Returns false without copying if nothing was published since lastVersion,
+        or if the writer kept interrupting the copy. On success, lastVersion is
+        set to the version that was copied.
+    */
+    template <typename CopyFunction> bool read(juce::uint64 &lastVersion, CopyFunction &&copyFrame) const {
+        for (int attempt = 0; attempt < maxReadAttempts; ++attempt) {
+            auto before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (before / 2 == lastVersion)
+                return false;
+
+            copyFrame();
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                lastVersion = before / 2;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+  private:
+    //==============================================================================
+    std::atomic<juce::uint64> sequence{0};
+
+    static constexpr int maxReadAttempts = 8;
+};
@@ -0,0 +1,70 @@
+#include "SessionAutosaver.h"
+#include "SessionFile.h"
+
+//==============================================================================
+SessionAutosaver::SessionAutosaver(PluginHost &host, const juce::File &fileToSave)
+    : juce::Thread("Session autosave"), pluginHost(host), sessionFile(fileToSave) {
+    startThread(juce::Thread::Priority::low);
+    startTimer(autosaveIntervalMs);
+}
+
+SessionAutosaver::~SessionAutosaver() {
+    stopTimer();
+
+    // The thread writes whatever is still pending before it exits
+    signalThreadShouldExit();
+    notify();
+    stopThread(10000);
+}
+
+void SessionAutosaver::triggerSave() { timerCallback(); }
+
+//==============================================================================
+void SessionAutosaver::timerCallback() {
+    // Don't overwrite the last session with an empty chain before it has been restored
+    if (pluginHost.isSessionRestorePending())
+        return;
+
+    juce::ValueTree session;
+    if (!pluginHost.getStateIfChanged(session))
+        return;
+
+    {
+        const juce::ScopedLock lock(pendingLock);
+        pendingSession = session;
+    }
+
+    notify();
+}
+
+void SessionAutosaver::run() {
+    while (!threadShouldExit()) {
+        wait(-1);
+        writePendingSession();
+    }
+
+    writePendingSession();
+}
+
+void SessionAutosaver::writePendingSession() {
+    juce::ValueTree session;
+    {
+        const juce::ScopedLock lock(pendingLock);
+        std::swap(session, pendingSession);
+    }
+
+    if (!session.isValid())
+        return;
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    if (SessionFile::write(session, sessionFile, SessionFile::Compression::zlib, &PluginStateStore::getInstance())) {
+        DBG("Autosaved session (" + juce::String(session.getNumChildren()) + " plugins) in " +
+            juce::String(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) *
+                             1000.0,
+                         1) +
+            " ms");
+    } else {
+        DBG("Autosave failed: " + sessionFile.getFullPathName());
+    }
+}
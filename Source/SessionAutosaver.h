@@ -0,0 +1,44 @@
+#pragma once
+
+#include "PluginHost.h"
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+//==============================================================================
+/**
+    Periodically saves the plugin chain, so a crash only loses the last few seconds.
+
+    - Every couple of seconds the message thread asks the PluginHost for the
+      chain's state - only plugins that reported a change are serialised again,
+      and nothing is written if nothing changed
+    - The session file is written on a background thread, atomically (temporary
+      file, then rename), so a crash mid-write never leaves a broken session
+    - Saves that pile up while a write is running are coalesced into one
+
+    Pending saves are written before the autosaver is destroyed.
+*/
+class SessionAutosaver : private juce::Timer, private juce::Thread {
+  public:
+    //==============================================================================
+    SessionAutosaver(PluginHost &host, const juce::File &fileToSave);
+    ~SessionAutosaver() override;
+
+    // Checks for changes straight away instead of waiting for the next interval
+    void triggerSave();
+
+    static constexpr int autosaveIntervalMs = 2000;
+
+  private:
+    //==============================================================================
+    PluginHost &pluginHost;
+    const juce::File sessionFile;
+
+    juce::ValueTree pendingSession;
+    juce::CriticalSection pendingLock;
+
+    void timerCallback() override;
+    void run() override;
+    void writePendingSession();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionAutosaver)
+};
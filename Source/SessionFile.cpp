@@ -0,0 +1,275 @@
+#include "SessionFile.h"
+#include <map>
+
+namespace {
+constexpr juce::uint32 makeChunkId(char a, char b, char c, char d) {
+    return (juce::uint32)(juce::uint8)a | ((juce::uint32)(juce::uint8)b << 8) | ((juce::uint32)(juce::uint8)c << 16) |
+           ((juce::uint32)(juce::uint8)d << 24);
+}
+
+constexpr juce::uint32 fileMagic = makeChunkId('A', 'C', 'S', 'N');
+constexpr juce::uint32 chainTableId = makeChunkId('C', 'H', 'N', 'T');
+constexpr juce::uint32 stateId = makeChunkId('S', 'T', 'A', 'T');
+
+constexpr juce::uint32 compressedFlag = 1;
+
+constexpr size_t fileHeaderSize = 12;  // magic, version, header size, chunk count
+constexpr size_t chunkHeaderSize = 16; // id, flags, stored size, size
+
+// Compressing only pays for itself on load if it saves a decent amount of space
+constexpr double minCompressionSaving = 0.125;
+} // namespace
+
+//==============================================================================
+bool SessionFile::write(const juce::ValueTree &session, const juce::File &file, Compression compression,
+                        PluginStateStore *stateStore) {
+    // Chain table holds everything except the states, which go into their own chunks or the state store
+    auto chainTable = session.createCopy();
+    juce::Array<juce::MemoryBlock> states;
+    std::map<juce::String, int> stateChunksByHash;
+
+    for (auto pluginState : chainTable) {
+        if (!pluginState.hasProperty("state"))
+            continue;
+
+        auto state = pluginState.getProperty("state");
+        juce::MemoryBlock stateBlock;
+        if (auto *binaryState = state.getBinaryData()) {
+            stateBlock = *binaryState;
+        } else {
+            stateBlock.fromBase64Encoding(state.toString()); // Session loaded from an old XML file
+        }
+
+        pluginState.removeProperty("state", nullptr);
+
+        if (stateStore != nullptr && stateBlock.getSize() >= minStoredStateSize) {
+            auto hash = stateStore->store(stateBlock);
+            if (hash.isNotEmpty()) {
+                pluginState.setProperty("stateHash", hash, nullptr);
+                continue;
+            }
+            // Couldn't write to the store - keep the state in the file instead
+        }
+
+        auto hash = PluginStateStore::getHash(stateBlock.getData(), stateBlock.getSize());
+        auto existing = stateChunksByHash.find(hash);
+        if (existing != stateChunksByHash.end()) {
+            pluginState.setProperty("stateChunk", existing->second, nullptr);
+            continue;
+        }
+
+        stateChunksByHash[hash] = states.size();
+        pluginState.setProperty("stateChunk", states.size(), nullptr);
+        states.add(std::move(stateBlock));
+    }
+
+    juce::MemoryOutputStream chainTableData;
+    chainTable.writeToStream(chainTableData);
+
+    juce::TemporaryFile tempFile(file);
+    {
+        juce::FileOutputStream stream(tempFile.getFile());
+        if (!stream.openedOk()) {
+            DBG("Failed to open session file for writing: " + file.getFullPathName());
+            return false;
+        }
+
+        stream.writeInt((int)fileMagic);
+        stream.writeShort((short)currentVersion);
+        stream.writeShort((short)fileHeaderSize);
+        stream.writeInt(1 + states.size());
+
+        writeChunk(stream, chainTableId, chainTableData.getData(), chainTableData.getDataSize(), Compression::none);
+        for (const auto &state : states)
+            writeChunk(stream, stateId, state.getData(), state.getSize(), compression);
+
+        stream.flush();
+        if (stream.getStatus().failed()) {
+            DBG("Failed to write session file: " + stream.getStatus().getErrorMessage());
+            return false;
+        }
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
+
+void SessionFile::writeChunk(juce::OutputStream &stream, juce::uint32 id, const void *data, size_t size,
+                             Compression compression) {
+    juce::MemoryOutputStream compressedData;
+    if (compression == Compression::zlib && size > 0) {
+        juce::GZIPCompressorOutputStream compressor(compressedData);
+        compressor.write(data, size);
+        compressor.flush();
+    }
+
+    auto useCompressed = compressedData.getDataSize() > 0 &&
+                         (double)compressedData.getDataSize() < (double)size * (1.0 - minCompressionSaving);
+
+    auto storedSize = useCompressed ? compressedData.getDataSize() : size;
+
+    stream.writeInt((int)id);
+    stream.writeInt(useCompressed ? (int)compressedFlag : 0);
+    stream.writeInt((int)storedSize);
+    stream.writeInt((int)size);
+    stream.write(useCompressed ? compressedData.getData() : data, storedSize);
+}
+
+//==============================================================================
+juce::ValueTree SessionFile::read(const juce::File &file, PluginStateStore *stateStore) {
+    if (!file.existsAsFile())
+        return {};
+
+    if (!isBinarySessionFile(file))
+        return readXml(file);
+
+    juce::MemoryMappedFile mappedFile(file, juce::MemoryMappedFile::readOnly);
+    if (mappedFile.getData() != nullptr)
+        return readBinary(static_cast<const juce::uint8 *>(mappedFile.getData()), mappedFile.getSize(), stateStore);
+
+    // Mapping can fail on some file systems - read it the slow way
+    juce::MemoryBlock fileData;
+    if (!file.loadFileAsData(fileData))
+        return {};
+
+    return readBinary(static_cast<const juce::uint8 *>(fileData.getData()), fileData.getSize(), stateStore);
+}
+
+juce::StringArray SessionFile::getStateHashes(const juce::File &file) {
+    juce::StringArray hashes;
+
+    juce::MemoryBlock fileData;
+    if (!isBinarySessionFile(file) || !file.loadFileAsData(fileData))
+        return hashes;
+
+    juce::Array<Chunk> stateChunks;
+    auto chainTable =
+        readChainTable(static_cast<const juce::uint8 *>(fileData.getData()), fileData.getSize(), stateChunks);
+
+    for (const auto &pluginState : chainTable)
+        if (pluginState.hasProperty("stateHash"))
+            hashes.addIfNotAlreadyThere(pluginState.getProperty("stateHash").toString());
+
+    return hashes;
+}
+
+juce::ValueTree SessionFile::readBinary(const juce::uint8 *data, size_t size, PluginStateStore *stateStore) {
+    juce::Array<Chunk> stateChunks;
+    auto session = readChainTable(data, size, stateChunks);
+
+    for (auto pluginState : session) {
+        if (pluginState.hasProperty("stateHash")) {
+            auto hash = pluginState.getProperty("stateHash").toString();
+            pluginState.removeProperty("stateHash", nullptr);
+
+            if (auto blob = stateStore != nullptr ? stateStore->load(hash) : nullptr) {
+                pluginState.setProperty("state", juce::var(*blob), nullptr);
+            } else {
+                DBG("Missing stored state for plugin: " + pluginState.getProperty("name").toString());
+            }
+            continue;
+        }
+
+        if (!pluginState.hasProperty("stateChunk"))
+            continue;
+
+        auto stateIndex = (int)pluginState.getProperty("stateChunk");
+        pluginState.removeProperty("stateChunk", nullptr);
+
+        juce::MemoryBlock stateBlock;
+        if (juce::isPositiveAndBelow(stateIndex, stateChunks.size()) &&
+            readChunkData(stateChunks.getReference(stateIndex), stateBlock)) {
+            pluginState.setProperty("state", juce::var(std::move(stateBlock)), nullptr);
+        } else {
+            DBG("Missing or damaged state for plugin: " + pluginState.getProperty("name").toString());
+        }
+    }
+
+    return session;
+}
+
+juce::ValueTree SessionFile::readChainTable(const juce::uint8 *data, size_t size, juce::Array<Chunk> &stateChunks) {
+    if (size < fileHeaderSize || juce::ByteOrder::littleEndianInt(data) != fileMagic)
+        return {};
+
+    auto version = juce::ByteOrder::littleEndianShort(data + 4);
+    auto headerSize = (size_t)juce::ByteOrder::littleEndianShort(data + 6);
+    auto numChunks = juce::ByteOrder::littleEndianInt(data + 8);
+
+    if (version > currentVersion) {
+        DBG("Session file version " + juce::String(version) + " is newer than this build supports");
+        return {};
+    }
+
+    // Collect the chunks, checking every length against the file size
+    Chunk chainTableChunk;
+
+    auto offset = headerSize;
+    for (juce::uint32 i = 0; i < numChunks; ++i) {
+        if (offset + chunkHeaderSize > size) {
+            DBG("Session file is truncated");
+            return {};
+        }
+
+        Chunk chunk;
+        chunk.id = juce::ByteOrder::littleEndianInt(data + offset);
+        chunk.flags = juce::ByteOrder::littleEndianInt(data + offset + 4);
+        chunk.storedSize = juce::ByteOrder::littleEndianInt(data + offset + 8);
+        chunk.size = juce::ByteOrder::littleEndianInt(data + offset + 12);
+        chunk.data = data + offset + chunkHeaderSize;
+
+        offset += chunkHeaderSize + chunk.storedSize;
+        if (offset > size) {
+            DBG("Session file is truncated");
+            return {};
+        }
+
+        if (chunk.id == chainTableId) {
+            chainTableChunk = chunk;
+        } else if (chunk.id == stateId) {
+            stateChunks.add(chunk);
+        }
+    }
+
+    juce::MemoryBlock chainTableData;
+    if (chainTableChunk.data == nullptr || !readChunkData(chainTableChunk, chainTableData))
+        return {};
+
+    return juce::ValueTree::readFromData(chainTableData.getData(), chainTableData.getSize());
+}
+
+bool SessionFile::readChunkData(const Chunk &chunk, juce::MemoryBlock &result) {
+    if ((chunk.flags & compressedFlag) == 0) {
+        if (chunk.storedSize != chunk.size)
+            return false;
+
+        result.replaceAll(chunk.data, chunk.size);
+        return true;
+    }
+
+    juce::MemoryInputStream compressedStream(chunk.data, chunk.storedSize, false);
+    juce::GZIPDecompressorInputStream decompressor(compressedStream);
+
+    result.setSize(chunk.size);
+    return chunk.size == 0 || decompressor.read(result.getData(), (int)chunk.size) == (int)chunk.size;
+}
+
+//==============================================================================
+bool SessionFile::writeXml(const juce::ValueTree &session, const juce::File &file) {
+    if (auto xml = session.createXml())
+        return xml->writeTo(file);
+
+    return false;
+}
+
+juce::ValueTree SessionFile::readXml(const juce::File &file) {
+    if (auto xml = juce::XmlDocument::parse(file))
+        return juce::ValueTree::fromXml(*xml);
+
+    return {};
+}
+
+bool SessionFile::isBinarySessionFile(const juce::File &file) {
+    juce::FileInputStream stream(file);
+    return stream.openedOk() && stream.getTotalLength() >= (juce::int64)fileHeaderSize &&
+           (juce::uint32)stream.readInt() == fileMagic;
+}
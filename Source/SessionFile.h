@@ -0,0 +1,75 @@
+#pragma once
+
+#include "PluginStateStore.h"
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+
+//==============================================================================
+/**
+    Binary container for plugin chain sessions.
+
+    Layout (all integers little endian):
+    - Header: "ACSN" magic, format version, header size, chunk count
+    - Chunks, each with a 16 byte header: id, flags, stored size, original size
+        - "CHNT" chain table: the PluginChain tree without plugin states, in
+          ValueTree's binary form. Each plugin refers to its state chunk by index.
+        - "STAT" raw getStateInformation blobs, optionally zlib compressed. Plugins
+          with identical states share one chunk.
+
+    With a PluginStateStore, large states go into the store instead and the chain
+    table refers to them by hash ("stateHash"), so a state shared by several
+    sessions, or unchanged between autosaves, is only written once.
+
+    Files are read through a memory map - the chain table is parsed in place and
+    uncompressed states are copied once, straight from the mapped pages, with no
+    base64 or text decoding. Unknown chunk ids are skipped so newer files can add
+    chunks without breaking older readers.
+
+    Plugin states in the session tree are MemoryBlock vars. XML files (the format
+    used before) can still be read and written; JUCE stores binary properties in
+    XML as base64 attributes.
+*/
+class SessionFile {
+  public:
+    //==============================================================================
+    enum class Compression { none, zlib };
+
+    // Writes the session in the binary format. States are only stored compressed when it saves space.
+    // With a state store, states of at least minStoredStateSize bytes are written to the store.
+    static bool write(const juce::ValueTree &session, const juce::File &file,
+                      Compression compression = Compression::zlib, PluginStateStore *stateStore = nullptr);
+
+    // Reads a binary or XML session, detected from the file contents. Returns an invalid tree on failure.
+    // States referenced by hash are loaded from the state store.
+    static juce::ValueTree read(const juce::File &file, PluginStateStore *stateStore = nullptr);
+
+    // Hashes of the store blobs a binary session refers to
+    static juce::StringArray getStateHashes(const juce::File &file);
+
+    // XML import and export
+    static bool writeXml(const juce::ValueTree &session, const juce::File &file);
+    static juce::ValueTree readXml(const juce::File &file);
+
+    static bool isBinarySessionFile(const juce::File &file);
+
+    static constexpr juce::uint16 currentVersion = 1;
+    static constexpr size_t minStoredStateSize = 16 * 1024;
+
+  private:
+    //==============================================================================
+    struct Chunk {
+        juce::uint32 id = 0;
+        juce::uint32 flags = 0;
+        const juce::uint8 *data = nullptr;
+        juce::uint32 storedSize = 0;
+        juce::uint32 size = 0;
+    };
+
+    static juce::ValueTree readBinary(const juce::uint8 *data, size_t size, PluginStateStore *stateStore);
+    static juce::ValueTree readChainTable(const juce::uint8 *data, size_t size, juce::Array<Chunk> &stateChunks);
+    static bool readChunkData(const Chunk &chunk, juce::MemoryBlock &result);
+    static void writeChunk(juce::OutputStream &stream, juce::uint32 id, const void *data, size_t size,
+                           Compression compression);
+
+    SessionFile() = delete;
+};
@@ -0,0 +1,296 @@
+#include "SignalKernels.h"
+
+namespace {
+using FloatVector = juce::dsp::SIMDRegister<float>;
+using MaskVector = FloatVector::vMaskType;
+
+// Where the vectorised part of a block starts and ends
+struct AlignedRange {
+    const float *start;
+    const float *end;
+};
+
+AlignedRange getAlignedRange(const float *samples, int numSamples) {
+    auto *blockEnd = samples + numSamples;
+    auto *start = juce::snapPointerToAlignment(samples, FloatVector::SIMDRegisterSize);
+    if (start >= blockEnd)
+        return {blockEnd, blockEnd};
+
+    auto numVectors = (size_t)(blockEnd - start) / FloatVector::SIMDNumElements;
+    return {start, start + numVectors * FloatVector::SIMDNumElements};
+}
+
+// Denormals are told apart by their bits (exponent zero, mantissa not), not by comparisons: with
+// denormals-are-zero on, as under the audio callback's ScopedNoDenormals, those see them as zero
+constexpr juce::uint32 exponentBits = 0x7f800000;
+constexpr juce::uint32 mantissaBits = 0x007fffff;
+
+bool isDenormal(float value) {
+    juce::uint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & exponentBits) == 0 && (bits & mantissaBits) != 0;
+}
+
+// All ones per lane holding a denormal, for the aligned samples
+MaskVector getDenormalMask(const float *samples) {
+    auto bits = MaskVector::fromRawArray(reinterpret_cast<const juce::uint32 *>(samples));
+    auto zero = MaskVector::expand(0);
+
+    return MaskVector::equal(bits & MaskVector::expand(exponentBits), zero) &
+           MaskVector::notEqual(bits & MaskVector::expand(mantissaBits), zero);
+}
+} // namespace
+
+//==============================================================================
+void SignalKernels::measureLevels(const float *samples, int numSamples, Levels &levels) {
+    if (numSamples <= 0)
+        return;
+
+    auto range = getAlignedRange(samples, numSamples);
+    auto peak = levels.peak;
+    auto sumOfSquares = 0.0f;
+    auto numClipped = 0;
+
+    auto measureScalar = [&](const float *start, const float *end) {
+        for (auto *sample = start; sample < end; ++sample) {
+            auto magnitude = std::abs(*sample);
+            peak = juce::jmax(peak, magnitude);
+            sumOfSquares += *sample * *sample;
+            numClipped += magnitude >= clipLevel ? 1 : 0;
+        }
+    };
+
+    measureScalar(samples, range.start);
+
+    if (range.start < range.end) {
+        auto peaks = FloatVector::expand(0.0f);
+        auto sums = FloatVector::expand(0.0f);
+        auto clipped = MaskVector::expand(0);
+        auto clipThreshold = FloatVector::expand(clipLevel);
+
+        for (auto *sample = range.start; sample < range.end; sample += FloatVector::SIMDNumElements) {
+            auto values = FloatVector::fromRawArray(sample);
+            auto magnitudes = FloatVector::abs(values);
+
+            peaks = FloatVector::max(peaks, magnitudes);
+            sums += values * values;
+
+            // Comparison masks are all ones (-1) per clipped lane
+            clipped -= FloatVector::greaterThanOrEqual(magnitudes, clipThreshold);
+        }
+
+        for (size_t lane = 0; lane < FloatVector::SIMDNumElements; ++lane) {
+            peak = juce::jmax(peak, peaks.get(lane));
+            numClipped += (int)clipped.get(lane);
+        }
+        sumOfSquares += sums.sum();
+    }
+
+    measureScalar(range.end, samples + numSamples);
+
+    levels.peak = peak;
+    levels.sumOfSquares += sumOfSquares;
+    levels.numClipped += numClipped;
+    levels.numSamples += numSamples;
+}
+
+void SignalKernels::measureStereo(const float *left, const float *right, int numSamples, StereoSums &sums) {
+    if (numSamples <= 0)
+        return;
+
+    auto leftSquares = 0.0f, rightSquares = 0.0f, products = 0.0f;
+
+    auto measureScalar = [&](int start, int end) {
+        for (int i = start; i < end; ++i) {
+            leftSquares += left[i] * left[i];
+            rightSquares += right[i] * right[i];
+            products += left[i] * right[i];
+        }
+    };
+
+    auto range = getAlignedRange(left, numSamples);
+    auto start = (int)(range.start - left);
+    auto end = (int)(range.end - left);
+    auto isRightAligned = juce::snapPointerToAlignment(right + start, FloatVector::SIMDRegisterSize) == right + start;
+
+    if (start < end && isRightAligned) {
+        measureScalar(0, start);
+
+        auto leftSums = FloatVector::expand(0.0f);
+        auto rightSums = FloatVector::expand(0.0f);
+        auto productSums = FloatVector::expand(0.0f);
+
+        for (int i = start; i < end; i += (int)FloatVector::SIMDNumElements) {
+            auto leftValues = FloatVector::fromRawArray(left + i);
+            auto rightValues = FloatVector::fromRawArray(right + i);
+
+            leftSums += leftValues * leftValues;
+            rightSums += rightValues * rightValues;
+            productSums += leftValues * rightValues;
+        }
+
+        leftSquares += leftSums.sum();
+        rightSquares += rightSums.sum();
+        products += productSums.sum();
+
+        measureScalar(end, numSamples);
+    } else {
+        measureScalar(0, numSamples);
+    }
+
+    sums.leftSquares += leftSquares;
+    sums.rightSquares += rightSquares;
+    sums.products += products;
+}
+
+void SignalKernels::measureTelemetry(const float *samples, int numSamples, Telemetry &telemetry) {
+    if (numSamples <= 0)
+        return;
+
+    constexpr auto largestFinite = std::numeric_limits<float>::max();
+
+    auto range = getAlignedRange(samples, numSamples);
+    auto peak = telemetry.peak;
+    auto sumOfSquares = 0.0f, sum = 0.0f;
+    auto numNaNs = 0, numInfinities = 0, numDenormals = 0;
+
+    auto measureScalar = [&](const float *start, const float *end) {
+        for (auto *sample = start; sample < end; ++sample) {
+            auto value = *sample;
+            auto magnitude = std::abs(value);
+
+            // False for NaNs too
+            if (!(magnitude <= largestFinite)) {
+                if (std::isnan(value))
+                    ++numNaNs;
+                else
+                    ++numInfinities;
+                continue;
+            }
+
+            numDenormals += isDenormal(value) ? 1 : 0;
+            peak = juce::jmax(peak, magnitude);
+            sumOfSquares += value * value;
+            sum += value;
+        }
+    };
+
+    measureScalar(samples, range.start);
+
+    if (range.start < range.end) {
+        auto peaks = FloatVector::expand(0.0f);
+        auto squares = FloatVector::expand(0.0f);
+        auto sums = FloatVector::expand(0.0f);
+        auto finiteCounts = MaskVector::expand(0);
+        auto nanCounts = MaskVector::expand(0);
+        auto denormalCounts = MaskVector::expand(0);
+
+        auto largest = FloatVector::expand(largestFinite);
+
+        for (auto *sample = range.start; sample < range.end; sample += FloatVector::SIMDNumElements) {
+            auto values = FloatVector::fromRawArray(sample);
+            auto magnitudes = FloatVector::abs(values);
+
+            // Comparison masks are all ones (-1) per matching lane; NaNs compare false to everything
+            auto finite = FloatVector::lessThanOrEqual(magnitudes, largest);
+            auto finiteValues = values & finite;
+
+            peaks = FloatVector::max(peaks, magnitudes & finite);
+            squares += finiteValues * finiteValues;
+            sums += finiteValues;
+
+            finiteCounts -= finite;
+            nanCounts -= FloatVector::notEqual(values, values);
+            denormalCounts -= getDenormalMask(sample);
+        }
+
+        auto numFinite = 0, numVectorNaNs = 0;
+        for (size_t lane = 0; lane < FloatVector::SIMDNumElements; ++lane) {
+            peak = juce::jmax(peak, peaks.get(lane));
+            numFinite += (int)finiteCounts.get(lane);
+            numVectorNaNs += (int)nanCounts.get(lane);
+            numDenormals += (int)denormalCounts.get(lane);
+        }
+        numNaNs += numVectorNaNs;
+        numInfinities += (int)(range.end - range.start) - numFinite - numVectorNaNs;
+
+        sumOfSquares += squares.sum();
+        sum += sums.sum();
+    }
+
+    measureScalar(range.end, samples + numSamples);
+
+    telemetry.peak = peak;
+    telemetry.sumOfSquares += sumOfSquares;
+    telemetry.sum += sum;
+    telemetry.numNaNs += numNaNs;
+    telemetry.numInfinities += numInfinities;
+    telemetry.numDenormals += numDenormals;
+    telemetry.numSamples += numSamples;
+}
+
+void SignalKernels::repairSamples(float *samples, int numSamples, Repairs &repairs) {
+    if (numSamples <= 0)
+        return;
+
+    constexpr auto largestFinite = std::numeric_limits<float>::max();
+    constexpr auto smallestNormal = std::numeric_limits<float>::min();
+
+    auto numNonFinite = 0, numDenormals = 0;
+
+    auto repairScalar = [&](int start, int end) {
+        for (int i = start; i < end; ++i) {
+            auto magnitude = std::abs(samples[i]);
+
+            // False for NaNs too
+            if (!(magnitude <= largestFinite)) {
+                ++numNonFinite;
+                samples[i] = 0.0f;
+            } else if (isDenormal(samples[i])) {
+                ++numDenormals;
+                samples[i] = 0.0f;
+            }
+        }
+    };
+
+    auto range = getAlignedRange(samples, numSamples);
+    auto start = (int)(range.start - samples);
+    auto end = (int)(range.end - samples);
+
+    repairScalar(0, start);
+
+    if (start < end) {
+        auto finiteCounts = MaskVector::expand(0);
+        auto denormalCounts = MaskVector::expand(0);
+
+        auto largest = FloatVector::expand(largestFinite);
+        auto smallest = FloatVector::expand(smallestNormal);
+
+        for (int i = start; i < end; i += (int)FloatVector::SIMDNumElements) {
+            auto values = FloatVector::fromRawArray(samples + i);
+            auto magnitudes = FloatVector::abs(values);
+
+            // Comparison masks are all ones (-1) per matching lane; NaNs compare false to everything
+            auto finite = FloatVector::lessThanOrEqual(magnitudes, largest);
+            auto normal = FloatVector::greaterThanOrEqual(magnitudes, smallest) & finite;
+
+            finiteCounts -= finite;
+            denormalCounts -= getDenormalMask(samples + i);
+
+            // Zero stays zero, everything else that isn't a normal number becomes zero
+            (values & normal).copyToRawArray(samples + i);
+        }
+
+        auto numFinite = 0;
+        for (size_t lane = 0; lane < FloatVector::SIMDNumElements; ++lane) {
+            numFinite += (int)finiteCounts.get(lane);
+            numDenormals += (int)denormalCounts.get(lane);
+        }
+        numNonFinite += (end - start) - numFinite;
+    }
+
+    repairScalar(end, numSamples);
+
+    repairs.numNonFinite += numNonFinite;
+    repairs.numDenormals += numDenormals;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    Vectorised measurement passes over blocks of samples, for metering on the
+    audio thread. Each kernel reads the samples once and computes everything it
+    reports in that single pass, using juce::dsp::SIMDRegister (scalar code only
+    for the unaligned head and the tail of a block).
+*/
+class SignalKernels {
+  public:
+    //==============================================================================
+    // Accumulated over any number of calls, e.g. all channels of a block
+    struct Levels {
+        float peak = 0.0f;         // Largest magnitude
+        double sumOfSquares = 0.0; // For RMS
+        int numClipped = 0;        // Samples at or above full scale
+        int numSamples = 0;
+
+        float getRMS() const { return numSamples > 0 ? (float)std::sqrt(sumOfSquares / numSamples) : 0.0f; }
+    };
+
+    // Adds the samples' peak, sum of squares and clipped samples to levels
+    static void measureLevels(const float *samples, int numSamples, Levels &levels);
+
+    //==============================================================================
+    // Dot products of a channel pair, for its correlation
+    struct StereoSums {
+        double leftSquares = 0.0;
+        double rightSquares = 0.0;
+        double products = 0.0;
+
+        // -1 (opposite polarity) to +1 (identical), 0 for silence
+        float getCorrelation() const {
+            auto energy = std::sqrt(leftSquares * rightSquares);
+            return energy > 1.0e-12 ? (float)juce::jlimit(-1.0, 1.0, products / energy) : 0.0f;
+        }
+    };
+
+    // Adds the sums of left * left, right * right and left * right to sums. Vectorised when both
+    // channels have the same alignment, e.g. channels of one juce::AudioBuffer.
+    static void measureStereo(const float *left, const float *right, int numSamples, StereoSums &sums);
+
+    //==============================================================================
+    // What crosses a boundary of the app (device input or output), accumulated over any number of calls.
+    // NaNs and infinities are counted but left out of the levels, so one bad sample can't stick a meter.
+    struct Telemetry {
+        float peak = 0.0f;         // Largest finite magnitude
+        double sumOfSquares = 0.0; // For RMS
+        double sum = 0.0;          // For the DC offset
+        int numNaNs = 0;
+        int numInfinities = 0;
+        int numDenormals = 0;
+        int numSamples = 0;
+
+        float getRMS() const { return numSamples > 0 ? (float)std::sqrt(sumOfSquares / numSamples) : 0.0f; }
+        float getDCOffset() const { return numSamples > 0 ? (float)(sum / numSamples) : 0.0f; }
+    };
+
+    // Adds the samples' peak, sums and NaN, infinity and denormal counts to telemetry. Denormals are
+    // counted under juce::ScopedNoDenormals too, where the CPU reads them as zero.
+    static void measureTelemetry(const float *samples, int numSamples, Telemetry &telemetry);
+
+    //==============================================================================
+    // Samples repairSamples() replaced, accumulated over any number of calls
+    struct Repairs {
+        int numNonFinite = 0; // NaNs and infinities
+        int numDenormals = 0;
+    };
+
+    // Replaces NaNs, infinities and denormals with zero in place, and counts them (denormals by their
+    // bits, like measureTelemetry)
+    static void repairSamples(float *samples, int numSamples, Repairs &repairs);
+
+    static constexpr float clipLevel = 1.0f;
+
+  private:
+    SignalKernels() = delete;
+};
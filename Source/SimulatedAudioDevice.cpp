@@ -0,0 +1,412 @@
+#include "SimulatedAudioDevice.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace {
+// Widest layout a simulated device can have, as wide as the pipeline measures
+constexpr int maxSimulatedChannels = 64;
+
+// Below this, the device thread spins instead of sleeping, as sleeps can overshoot by a millisecond or more
+constexpr double spinMs = 1.5;
+
+const char *getSignalName(SimulatedDeviceSettings::Signal signal) {
+    switch (signal) {
+    case SimulatedDeviceSettings::Signal::silence:
+        return "silence";
+    case SimulatedDeviceSettings::Signal::sine:
+        return "sine";
+    case SimulatedDeviceSettings::Signal::noise:
+        return "noise";
+    case SimulatedDeviceSettings::Signal::impulses:
+        return "impulses";
+    case SimulatedDeviceSettings::Signal::file:
+        return "file";
+    }
+    return "silence";
+}
+
+// Parses a plain decimal number within [minimum, maximum]
+bool parseNumber(const juce::String &text, double minimum, double maximum, double &result) {
+    if (text.isEmpty() || !text.containsOnly("0123456789.-"))
+        return false;
+
+    result = text.getDoubleValue();
+    return result >= minimum && result <= maximum;
+}
+} // namespace
+
+//==============================================================================
+bool SimulatedDeviceSettings::fromString(const juce::String &text, SimulatedDeviceSettings &settings,
+                                         juce::String &error) {
+    auto pairs = juce::StringArray::fromTokens(text, ",", "\"");
+    pairs.trim();
+    pairs.removeEmptyStrings();
+
+    for (const auto &pair : pairs) {
+        auto key = pair.upToFirstOccurrenceOf("=", false, false).trim();
+        auto value = pair.fromFirstOccurrenceOf("=", false, false).trim().unquoted();
+        auto number = 0.0;
+
+        auto parsed = true;
+        if (key == "rate") {
+            parsed = parseNumber(value, 8000.0, 768000.0, number);
+            settings.sampleRate = number;
+        } else if (key == "block") {
+            parsed = parseNumber(value, 16.0, 16384.0, number);
+            settings.blockSize = (int)number;
+        } else if (key == "in") {
+            parsed = parseNumber(value, 0.0, maxSimulatedChannels, number);
+            settings.numInputChannels = (int)number;
+        } else if (key == "out") {
+            parsed = parseNumber(value, 0.0, maxSimulatedChannels, number);
+            settings.numOutputChannels = (int)number;
+        } else if (key == "jitter") {
+            parsed = parseNumber(value, 0.0, 1000.0, number);
+            settings.jitterMs = number;
+        } else if (key == "stall") {
+            parsed = parseNumber(value, 0.0, 10000.0, number);
+            settings.stallMs = number;
+        } else if (key == "stallEvery") {
+            parsed = parseNumber(value, 0.0, 3600000.0, number);
+            settings.stallEveryMs = number;
+        } else if (key == "realtime") {
+            parsed = value == "0" || value == "1";
+            settings.realTime = value == "1";
+        } else if (key == "level") {
+            parsed = parseNumber(value, 0.0, 16.0, number);
+            settings.level = (float)number;
+        } else if (key == "frequency") {
+            parsed = parseNumber(value, 0.01, 100000.0, number);
+            settings.frequency = (float)number;
+        } else if (key == "seed") {
+            parsed = parseNumber(value, 0.0, 1.0e15, number);
+            settings.seed = (juce::int64)number;
+        } else if (key == "file") {
+            parsed = value.isNotEmpty();
+            settings.file = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+        } else if (key == "signal") {
+            parsed = false;
+            for (auto signal : {Signal::silence, Signal::sine, Signal::noise, Signal::impulses, Signal::file}) {
+                if (value == getSignalName(signal)) {
+                    settings.signal = signal;
+                    parsed = true;
+                }
+            }
+        } else {
+            parsed = false;
+        }
+
+        if (!parsed) {
+            error = "Bad simulated device setting: " + pair;
+            return false;
+        }
+    }
+
+    if (settings.numInputChannels == 0 && settings.numOutputChannels == 0) {
+        error = "A simulated device needs at least one input or output channel";
+        return false;
+    }
+
+    if (settings.signal == Signal::file && settings.file == juce::File()) {
+        error = "signal=file needs a file";
+        return false;
+    }
+
+    return true;
+}
+
+juce::String SimulatedDeviceSettings::toString() const {
+    juce::StringArray pairs;
+    pairs.add("rate=" + juce::String(sampleRate));
+    pairs.add("block=" + juce::String(blockSize));
+    pairs.add("in=" + juce::String(numInputChannels));
+    pairs.add("out=" + juce::String(numOutputChannels));
+    pairs.add("jitter=" + juce::String(jitterMs));
+    pairs.add("stall=" + juce::String(stallMs));
+    pairs.add("stallEvery=" + juce::String(stallEveryMs));
+    pairs.add("realtime=" + juce::String(realTime ? 1 : 0));
+    pairs.add("signal=" + juce::String(getSignalName(signal)));
+    pairs.add("level=" + juce::String(level));
+    pairs.add("frequency=" + juce::String(frequency));
+    pairs.add("seed=" + juce::String(seed));
+    if (file != juce::File())
+        pairs.add("file=" + file.getFullPathName().quoted());
+    return pairs.joinIntoString(",");
+}
+
+//==============================================================================
+SimulatedAudioDevice::SimulatedAudioDevice(const juce::String &deviceName, const SimulatedDeviceSettings &s)
+    : juce::AudioIODevice(deviceName, SimulatedAudioDeviceType::typeName), juce::Thread("Simulated audio device"),
+      settings(s) {}
+
+SimulatedAudioDevice::~SimulatedAudioDevice() { close(); }
+
+juce::StringArray SimulatedAudioDevice::getOutputChannelNames() {
+    juce::StringArray names;
+    for (int channel = 0; channel < settings.numOutputChannels; ++channel)
+        names.add("Output " + juce::String(channel + 1));
+    return names;
+}
+
+juce::StringArray SimulatedAudioDevice::getInputChannelNames() {
+    juce::StringArray names;
+    for (int channel = 0; channel < settings.numInputChannels; ++channel)
+        names.add("Input " + juce::String(channel + 1));
+    return names;
+}
+
+// Only the configured rate and block size, so the device manager can't open the device with others
+juce::Array<double> SimulatedAudioDevice::getAvailableSampleRates() { return {settings.sampleRate}; }
+
+juce::Array<int> SimulatedAudioDevice::getAvailableBufferSizes() { return {settings.blockSize}; }
+
+juce::String SimulatedAudioDevice::open(const juce::BigInteger &inputChannels, const juce::BigInteger &outputChannels,
+                                        double sampleRate, int bufferSizeSamples) {
+    close();
+
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : settings.sampleRate;
+    bufferSize = bufferSizeSamples > 0 ? bufferSizeSamples : settings.blockSize;
+
+    // Only the channels the device has
+    activeInputChannels = inputChannels;
+    activeInputChannels.setRange(settings.numInputChannels,
+                                 juce::jmax(0, activeInputChannels.getHighestBit() + 1 - settings.numInputChannels),
+                                 false);
+    activeOutputChannels = outputChannels;
+    activeOutputChannels.setRange(settings.numOutputChannels,
+                                  juce::jmax(0, activeOutputChannels.getHighestBit() + 1 - settings.numOutputChannels),
+                                  false);
+
+    inputBuffer.setSize(activeInputChannels.countNumberOfSetBits(), bufferSize);
+    outputBuffer.setSize(activeOutputChannels.countNumberOfSetBits(), bufferSize);
+    inputBuffer.clear();
+
+    random.setSeed(settings.seed);
+    phase = 0.0;
+    samplePosition = 0;
+    filePosition = 0;
+
+    if (settings.signal == SimulatedDeviceSettings::Signal::file && !loadFile()) {
+        lastError = "Could not read " + settings.file.getFullPathName();
+        return lastError;
+    }
+
+    numCallbacks = 0;
+    numLateCallbacks = 0;
+    numStalls = 0;
+
+    lastError.clear();
+    opened = true;
+    return {};
+}
+
+void SimulatedAudioDevice::close() {
+    stop();
+
+    opened = false;
+    inputBuffer.setSize(0, 0);
+    outputBuffer.setSize(0, 0);
+    fileSamples.setSize(0, 0);
+}
+
+void SimulatedAudioDevice::start(juce::AudioIODeviceCallback *callback) {
+    if (!opened || callback == nullptr || callback == currentCallback)
+        return;
+
+    stop();
+
+    callback->audioDeviceAboutToStart(this);
+    {
+        const juce::ScopedLock lock(callbackLock);
+        currentCallback = callback;
+    }
+
+    startThread(juce::Thread::Priority::highest);
+}
+
+void SimulatedAudioDevice::stop() {
+    stopThread(2000);
+
+    juce::AudioIODeviceCallback *previousCallback = nullptr;
+    {
+        const juce::ScopedLock lock(callbackLock);
+        std::swap(previousCallback, currentCallback);
+    }
+
+    if (previousCallback != nullptr)
+        previousCallback->audioDeviceStopped();
+}
+
+//==============================================================================
+void SimulatedAudioDevice::run() {
+    const auto blockMs = 1000.0 * bufferSize / currentSampleRate;
+
+    auto deadline = juce::Time::getMillisecondCounterHiRes();
+    auto lastStall = deadline;
+
+    // Sleeps until a few ms before the target, then spins
+    auto waitUntil = [this](double targetMs) {
+        for (;;) {
+            auto remainingMs = targetMs - juce::Time::getMillisecondCounterHiRes();
+            if (remainingMs <= 0.0 || threadShouldExit())
+                return;
+
+            if (remainingMs > spinMs)
+                juce::Thread::sleep((int)(remainingMs - spinMs) + 1);
+            else
+                juce::Thread::yield();
+        }
+    };
+
+    while (!threadShouldExit()) {
+        if (settings.realTime) {
+            // Jitter delays this callback only - the schedule stays on the sample clock
+            waitUntil(deadline + random.nextDouble() * settings.jitterMs);
+
+            auto isStallDue = settings.stallEveryMs > 0.0 &&
+                              juce::Time::getMillisecondCounterHiRes() - lastStall >= settings.stallEveryMs;
+            if (isStallDue) {
+                waitUntil(juce::Time::getMillisecondCounterHiRes() + settings.stallMs);
+                lastStall = juce::Time::getMillisecondCounterHiRes();
+                ++numStalls;
+
+                // The samples the stall cost are gone, as with a real xrun
+                deadline = lastStall;
+            }
+
+            if (threadShouldExit())
+                break;
+        }
+
+        generateInput();
+        outputBuffer.clear();
+
+        {
+            const juce::ScopedLock lock(callbackLock);
+            if (currentCallback != nullptr) {
+                currentCallback->audioDeviceIOCallbackWithContext(
+                    inputBuffer.getArrayOfReadPointers(), inputBuffer.getNumChannels(),
+                    outputBuffer.getArrayOfWritePointers(), outputBuffer.getNumChannels(), bufferSize, {});
+            }
+        }
+        ++numCallbacks;
+
+        if (settings.realTime) {
+            deadline += blockMs;
+
+            // More than a block behind: the callback (or the machine) couldn't keep up
+            auto now = juce::Time::getMillisecondCounterHiRes();
+            if (now > deadline + blockMs) {
+                ++numLateCallbacks;
+                deadline = now;
+            }
+        }
+    }
+}
+
+void SimulatedAudioDevice::generateInput() {
+    const auto numChannels = inputBuffer.getNumChannels();
+    const auto level = settings.level;
+
+    if (numChannels == 0) {
+        samplePosition += bufferSize;
+        return;
+    }
+
+    switch (settings.signal) {
+    case SimulatedDeviceSettings::Signal::silence:
+        inputBuffer.clear();
+        break;
+
+    case SimulatedDeviceSettings::Signal::sine: {
+        auto increment = juce::MathConstants<double>::twoPi * settings.frequency / currentSampleRate;
+        auto *first = inputBuffer.getWritePointer(0);
+        for (int i = 0; i < bufferSize; ++i) {
+            first[i] = level * (float)std::sin(phase);
+            phase += increment;
+        }
+        phase = std::fmod(phase, juce::MathConstants<double>::twoPi);
+
+        for (int channel = 1; channel < numChannels; ++channel)
+            inputBuffer.copyFrom(channel, 0, first, bufferSize);
+        break;
+    }
+
+    case SimulatedDeviceSettings::Signal::noise:
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto *samples = inputBuffer.getWritePointer(channel);
+            for (int i = 0; i < bufferSize; ++i)
+                samples[i] = level * (random.nextFloat() * 2.0f - 1.0f);
+        }
+        break;
+
+    case SimulatedDeviceSettings::Signal::impulses: {
+        auto period = juce::jmax((juce::int64)1, (juce::int64)std::llround(currentSampleRate / settings.frequency));
+        inputBuffer.clear();
+        for (auto position = samplePosition + (period - samplePosition % period) % period;
+             position < samplePosition + bufferSize; position += period) {
+            for (int channel = 0; channel < numChannels; ++channel)
+                inputBuffer.setSample(channel, (int)(position - samplePosition), level);
+        }
+        break;
+    }
+
+    case SimulatedDeviceSettings::Signal::file: {
+        // Looped; the file's channels repeat if the device has more
+        auto fileLength = fileSamples.getNumSamples();
+        for (int done = 0; done < bufferSize;) {
+            auto numToCopy = juce::jmin(bufferSize - done, fileLength - filePosition);
+            for (int channel = 0; channel < numChannels; ++channel)
+                inputBuffer.copyFrom(channel, done, fileSamples, channel % fileSamples.getNumChannels(), filePosition,
+                                     numToCopy);
+
+            done += numToCopy;
+            filePosition = (filePosition + numToCopy) % fileLength;
+        }
+        inputBuffer.applyGain(level);
+        break;
+    }
+    }
+
+    samplePosition += bufferSize;
+}
+
+bool SimulatedAudioDevice::loadFile() {
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(settings.file));
+    if (reader == nullptr || reader->numChannels == 0 || reader->lengthInSamples <= 0)
+        return false;
+
+    // Read at open, so the device thread never touches the disk. Long files are cut at 10 minutes.
+    auto length = (int)juce::jmin(reader->lengthInSamples, (juce::int64)(reader->sampleRate * 600.0));
+    fileSamples.setSize((int)reader->numChannels, length);
+    return reader->read(&fileSamples, 0, length, 0, true, true);
+}
+
+//==============================================================================
+SimulatedAudioDeviceType::SimulatedAudioDeviceType() : juce::AudioIODeviceType(typeName) {
+    auto text = juce::SystemStats::getEnvironmentVariable(environmentVariable, {});
+    if (text.isNotEmpty()) {
+        juce::String error;
+        SimulatedDeviceSettings parsed;
+        if (SimulatedDeviceSettings::fromString(text, parsed, error))
+            settings = parsed;
+        else
+            DBG(juce::String(environmentVariable) + ": " + error);
+    }
+}
+
+juce::StringArray SimulatedAudioDeviceType::getDeviceNames(bool) const { return {deviceName}; }
+
+int SimulatedAudioDeviceType::getIndexOfDevice(juce::AudioIODevice *device, bool) const {
+    return dynamic_cast<SimulatedAudioDevice *>(device) != nullptr ? 0 : -1;
+}
+
+juce::AudioIODevice *SimulatedAudioDeviceType::createDevice(const juce::String &outputDeviceName,
+                                                            const juce::String &inputDeviceName) {
+    if (outputDeviceName != deviceName && inputDeviceName != deviceName)
+        return nullptr;
+
+    return new SimulatedAudioDevice(deviceName, settings);
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+//==============================================================================
+/**
+    How a simulated device behaves. Written as a comma separated list of
+    key=value pairs, e.g. "rate=48000,block=128,in=2,out=2,jitter=0.5,signal=noise":
+
+    - rate, block: sample rate and block size
+    - in, out: input and output channels
+    - jitter: each callback comes up to this many ms late (random, not accumulating)
+    - stall, stallEvery: the device thread stops for stall ms every stallEvery ms
+    - realtime: 1 for callbacks paced by the clock, 0 for back to back
+    - signal: silence, sine, noise, impulses or file, at level (gain). Sine and
+      impulses repeat at frequency (Hz).
+    - file: audio file for signal=file, played in a loop at the device's rate
+    - seed: for the noise and jitter, so runs are repeatable
+*/
+struct SimulatedDeviceSettings {
+    enum class Signal { silence, sine, noise, impulses, file };
+
+    double sampleRate = 48000.0;
+    int blockSize = 256;
+    int numInputChannels = 2;
+    int numOutputChannels = 2;
+    double jitterMs = 0.0;
+    double stallMs = 0.0;
+    double stallEveryMs = 0.0; // 0 for no stalls
+    bool realTime = true;
+    Signal signal = Signal::sine;
+    float level = 0.25f;
+    float frequency = 1000.0f;
+    juce::File file;
+    juce::int64 seed = 1;
+
+    // Keys that are missing keep their defaults. Returns false, with the bad pair in error, for
+    // unknown keys or values.
+    static bool fromString(const juce::String &text, SimulatedDeviceSettings &settings, juce::String &error);
+    juce::String toString() const;
+};
+
+//==============================================================================
+/**
+    An audio device without hardware: a thread calls the callback with
+    generated or file input, on the schedule the settings describe. Makes the
+    whole callback path deterministic and runnable on machines without a
+    sound card, e.g. for benchmarks and CI.
+
+    Output is discarded. The device counts its late callbacks (more than one
+    block behind the schedule, which then restarts from the current time) and
+    the stalls it simulated, as xruns.
+*/
+class SimulatedAudioDevice : public juce::AudioIODevice, private juce::Thread {
+  public:
+    //==============================================================================
+    SimulatedAudioDevice(const juce::String &deviceName, const SimulatedDeviceSettings &settings);
+    ~SimulatedAudioDevice() override;
+
+    juce::StringArray getOutputChannelNames() override;
+    juce::StringArray getInputChannelNames() override;
+    juce::Array<double> getAvailableSampleRates() override;
+    juce::Array<int> getAvailableBufferSizes() override;
+    int getDefaultBufferSize() override { return settings.blockSize; }
+
+    juce::String open(const juce::BigInteger &inputChannels, const juce::BigInteger &outputChannels, double sampleRate,
+                      int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override { return opened; }
+    void start(juce::AudioIODeviceCallback *callback) override;
+    void stop() override;
+    bool isPlaying() override { return currentCallback != nullptr; }
+    juce::String getLastError() override { return lastError; }
+
+    int getCurrentBufferSizeSamples() override { return bufferSize; }
+    double getCurrentSampleRate() override { return currentSampleRate; }
+    int getCurrentBitDepth() override { return 32; }
+    juce::BigInteger getActiveOutputChannels() const override { return activeOutputChannels; }
+    juce::BigInteger getActiveInputChannels() const override { return activeInputChannels; }
+    int getOutputLatencyInSamples() override { return 0; }
+    int getInputLatencyInSamples() override { return 0; }
+    int getXRunCount() const noexcept override { return numLateCallbacks.load() + numStalls.load(); }
+
+    //==============================================================================
+    juce::int64 getNumCallbacks() const { return numCallbacks.load(); }
+    int getNumLateCallbacks() const { return numLateCallbacks.load(); }
+    int getNumStalls() const { return numStalls.load(); }
+    const SimulatedDeviceSettings &getSettings() const { return settings; }
+
+  private:
+    //==============================================================================
+    const SimulatedDeviceSettings settings;
+
+    bool opened = false;
+    juce::String lastError;
+    double currentSampleRate = 0.0;
+    int bufferSize = 0;
+    juce::BigInteger activeInputChannels, activeOutputChannels;
+
+    // Block buffers, and the file's samples for signal=file
+    juce::AudioBuffer<float> inputBuffer, outputBuffer;
+    juce::AudioBuffer<float> fileSamples;
+    int filePosition = 0;
+    double phase = 0.0;
+    juce::int64 samplePosition = 0;
+    juce::Random random;
+
+    juce::CriticalSection callbackLock;
+    juce::AudioIODeviceCallback *currentCallback = nullptr;
+
+    std::atomic<juce::int64> numCallbacks{0};
+    std::atomic<int> numLateCallbacks{0};
+    std::atomic<int> numStalls{0};
+
+    void run() override;
+    void generateInput();
+    bool loadFile();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimulatedAudioDevice)
+};
+
+//==============================================================================
+/**
+    Device type with one simulated device, "Simulated Device", so it shows up
+    in the device lists next to the hardware. Its settings come from the
+    AUDIOCHAIN_SIMULATED_DEVICE environment variable (see
+    SimulatedDeviceSettings) unless set explicitly.
+*/
+class SimulatedAudioDeviceType : public juce::AudioIODeviceType {
+  public:
+    //==============================================================================
+    SimulatedAudioDeviceType();
+
+    void setSettings(const SimulatedDeviceSettings &newSettings) { settings = newSettings; }
+    const SimulatedDeviceSettings &getSettings() const { return settings; }
+
+    void scanForDevices() override {}
+    juce::StringArray getDeviceNames(bool wantInputNames) const override;
+    int getDefaultDeviceIndex(bool forInput) const override { return 0; }
+    int getIndexOfDevice(juce::AudioIODevice *device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override { return false; }
+    juce::AudioIODevice *createDevice(const juce::String &outputDeviceName,
+                                      const juce::String &inputDeviceName) override;
+
+    static constexpr const char *typeName = "Simulated";
+    static constexpr const char *deviceName = "Simulated Device";
+    static constexpr const char *environmentVariable = "AUDIOCHAIN_SIMULATED_DEVICE";
+
+  private:
+    //==============================================================================
+    SimulatedDeviceSettings settings;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimulatedAudioDeviceType)
+};
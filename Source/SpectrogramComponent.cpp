@@ -0,0 +1,98 @@
+#include "SpectrogramComponent.h"
+
+//==============================================================================
+SpectrogramComponent::SpectrogramComponent(const SpectrogramHistory &historyToShow) : history(historyToShow) {
+    setOpaque(true);
+    createColourMap();
+    startTimerHz(refreshRateHz);
+}
+
+SpectrogramComponent::~SpectrogramComponent() { stopTimer(); }
+
+//==============================================================================
+void SpectrogramComponent::timerCallback() {
+    if (history.getNumColumnsWritten() == nextColumn)
+        return;
+
+    drawNewColumns();
+    repaint();
+}
+
+void SpectrogramComponent::resized() { rebuildImage(); }
+
+void SpectrogramComponent::rebuildImage() {
+    auto width = getWidth();
+    if (width <= 0) {
+        image = {};
+        return;
+    }
+
+    image = juce::Image(juce::Image::ARGB, width, history.getNumBins(), true);
+    writeX = 0;
+
+    // Refill with as much history as fits
+    auto written = history.getNumColumnsWritten();
+    nextColumn = juce::jmax(history.getOldestReadableColumn(), written > (juce::uint64)width ? written - width : 0);
+    drawNewColumns();
+}
+
+void SpectrogramComponent::drawNewColumns() {
+    if (!image.isValid())
+        return;
+
+    auto width = image.getWidth();
+    auto numBins = history.getNumBins();
+    auto written = history.getNumColumnsWritten();
+
+    // Columns older than the image is wide would be overwritten anyway
+    auto first = juce::jmax(nextColumn, history.getOldestReadableColumn(),
+                            written > (juce::uint64)width ? written - width : (juce::uint64)0);
+    writeX = (writeX + (int)((first - nextColumn) % (juce::uint64)width)) % width;
+
+    juce::Image::BitmapData bitmap(image, juce::Image::BitmapData::writeOnly);
+
+    for (auto column = first; column < written; ++column) {
+        const auto *values = history.getColumn(column);
+
+        // Lowest bin at the bottom
+        for (int bin = 0; bin < numBins; ++bin) {
+            auto *pixel = reinterpret_cast<juce::PixelARGB *>(bitmap.getPixelPointer(writeX, numBins - 1 - bin));
+            pixel->set(colourMap[values[bin]]);
+        }
+
+        writeX = (writeX + 1) % width;
+    }
+
+    nextColumn = written;
+}
+
+void SpectrogramComponent::paint(juce::Graphics &g) {
+    g.fillAll(juce::Colour(0xff0a0a0a));
+
+    if (!image.isValid())
+        return;
+
+    // The oldest column is at writeX: draw from there to the end, then the start up to writeX
+    auto height = getHeight();
+    auto numBins = image.getHeight();
+    auto olderWidth = image.getWidth() - writeX;
+
+    g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+    g.drawImage(image, 0, 0, olderWidth, height, writeX, 0, olderWidth, numBins);
+    if (writeX > 0)
+        g.drawImage(image, olderWidth, 0, writeX, height, 0, 0, writeX, numBins);
+
+    g.setColour(juce::Colours::white.withAlpha(0.2f));
+    g.drawRect(getLocalBounds(), 1);
+}
+
+void SpectrogramComponent::createColourMap() {
+    // Black through blue and green to yellow and white
+    juce::ColourGradient gradient(juce::Colour(0xff0a0a0a), 0.0f, 0.0f, juce::Colours::white, 1.0f, 0.0f, false);
+    gradient.addColour(0.35, juce::Colour(0xff1a3a8a));
+    gradient.addColour(0.6, juce::Colour(0xff00a86b));
+    gradient.addColour(0.85, juce::Colour(0xffffe066));
+
+    for (size_t index = 0; index < colourMap.size(); ++index)
+        colourMap[index] = gradient.getColourAtPosition((double)index / 255.0).getPixelARGB();
+}
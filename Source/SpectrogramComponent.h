@@ -0,0 +1,44 @@
+#pragma once
+
+#include "SpectrogramHistory.h"
+#include <juce_core/juce_core.h>
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <array>
+
+//==============================================================================
+/**
+    Scrolling spectrogram of a SpectrogramHistory, newest column on the right.
+
+    The columns live in a circular image, one pixel column per history column,
+    one pixel row per bin. Each refresh only converts the columns written since
+    the last one and moves the ring offset; paint draws the image in two parts
+    around the offset, scaled to the component. The whole image is only
+    rebuilt (from the history) when the component changes width.
+*/
+class SpectrogramComponent : public juce::Component, private juce::Timer {
+  public:
+    explicit SpectrogramComponent(const SpectrogramHistory &history);
+    ~SpectrogramComponent() override;
+
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+
+  private:
+    //==============================================================================
+    const SpectrogramHistory &history;
+
+    juce::Image image;
+    int writeX = 0;                    // Image column the next history column goes to
+    juce::uint64 nextColumn = 0;       // Next history column to draw
+    std::array<juce::PixelARGB, 256> colourMap;
+
+    static constexpr int refreshRateHz = 30;
+
+    void timerCallback() override;
+    void rebuildImage();
+    void drawNewColumns();
+    void createColourMap();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramComponent)
+};
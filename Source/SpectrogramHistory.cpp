@@ -0,0 +1,28 @@
+#include "SpectrogramHistory.h"
+
+//==============================================================================
+SpectrogramHistory::SpectrogramHistory(int bins, int capacity, float floor)
+    : numBins(bins), numColumns(juce::jmax(capacity, writeMargin * 2)), floorDb(floor) {
+    columns.assign((size_t)numColumns * (size_t)numBins, 0);
+}
+
+void SpectrogramHistory::addColumn(const float *decibels) {
+    auto written = numWritten.load(std::memory_order_relaxed);
+    auto *column = columns.data() + (size_t)(written % (juce::uint64)numColumns) * (size_t)numBins;
+    auto scale = 255.0f / -floorDb;
+
+    for (int bin = 0; bin < numBins; ++bin)
+        column[bin] = (juce::uint8)juce::jlimit(0.0f, 255.0f, (decibels[bin] - floorDb) * scale + 0.5f);
+
+    numWritten.store(written + 1, std::memory_order_release);
+}
+
+juce::uint64 SpectrogramHistory::getOldestReadableColumn() const {
+    auto written = getNumColumnsWritten();
+    auto readable = (juce::uint64)(numColumns - writeMargin);
+    return written > readable ? written - readable : 0;
+}
+
+const juce::uint8 *SpectrogramHistory::getColumn(juce::uint64 column) const {
+    return columns.data() + (size_t)(column % (juce::uint64)numColumns) * (size_t)numBins;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/**
+    Minutes of spectrogram columns, one byte per bin.
+
+    A column is a spectrum in dB, quantised to 256 steps between a floor and
+    0 dB. The analysis thread appends columns; one reader (the spectrogram
+    view) picks up the columns it hasn't seen yet. Columns are never moved, so
+    reading needs no lock - the reader only has to stay within the readable
+    range, which keeps a margin of columns the writer won't touch yet.
+*/
+class SpectrogramHistory {
+  public:
+    //==============================================================================
+    SpectrogramHistory(int numBins, int numColumns, float floorDb);
+
+    // Analysis thread: appends a column of numBins dB values
+    void addColumn(const float *decibels);
+
+    // Reader: columns are numbered from 0 since the start
+    juce::uint64 getNumColumnsWritten() const { return numWritten.load(std::memory_order_acquire); }
+    juce::uint64 getOldestReadableColumn() const;
+    const juce::uint8 *getColumn(juce::uint64 column) const;
+
+    int getNumBins() const { return numBins; }
+    int getCapacity() const { return numColumns; }
+    float getFloorDb() const { return floorDb; }
+
+  private:
+    //==============================================================================
+    const int numBins;
+    const int numColumns;
+    const float floorDb;
+
+    std::vector<juce::uint8> columns; // numColumns x numBins, circular
+    std::atomic<juce::uint64> numWritten{0};
+
+    // Columns behind the writer that readers must leave alone
+    static constexpr int writeMargin = 64;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramHistory)
+};
@@ -0,0 +1,160 @@
+#include "StartupProfiler.h"
+
+//==============================================================================
+StartupProfiler::ScopedPhase::ScopedPhase(const juce::String &phaseName)
+    : name(phaseName), startTicks(juce::Time::getHighResolutionTicks()) {}
+
+StartupProfiler::ScopedPhase::~ScopedPhase() {
+    StartupProfiler::getInstance().addPhase(name, startTicks, juce::Time::getHighResolutionTicks());
+}
+
+//==============================================================================
+StartupProfiler::StartupProfiler() : originTicks(juce::Time::getHighResolutionTicks()) {
+    for (auto &milestone : realtimeMilestones)
+        milestone = 0;
+}
+
+StartupProfiler &StartupProfiler::getInstance() {
+    static StartupProfiler instance;
+    return instance;
+}
+
+//==============================================================================
+void StartupProfiler::addPhase(const juce::String &name, juce::int64 startTicks, juce::int64 endTicks) {
+    DBG("[Startup] " + name + ": " +
+        juce::String(juce::Time::highResolutionTicksToSeconds(endTicks - startTicks) * 1000.0, 1) + " ms");
+    addEvent(name, startTicks, endTicks);
+}
+
+void StartupProfiler::addMilestone(const juce::String &name) {
+    DBG("[Startup] " + name + " at " + juce::String(getElapsedMilliseconds(), 1) + " ms");
+    auto now = juce::Time::getHighResolutionTicks();
+    addEvent(name, now, now);
+}
+
+void StartupProfiler::addEvent(const juce::String &name, juce::int64 startTicks, juce::int64 endTicks) {
+    Event event;
+    event.name = name;
+    event.threadName = juce::Thread::getCurrentThread() != nullptr ? juce::Thread::getCurrentThread()->getThreadName()
+                                                                   : juce::String("Main");
+    event.threadId = (juce::uint64)(juce::pointer_sized_int)juce::Thread::getCurrentThreadId();
+    event.startTicks = startTicks;
+    event.endTicks = endTicks;
+
+    const juce::ScopedLock lock(eventLock);
+    events.add(event);
+}
+
+void StartupProfiler::addMilestone(RealtimeMilestone milestone) noexcept {
+    // Only the first occurrence is kept - no locks or allocation, safe on the audio thread
+    auto &reachedTicks = realtimeMilestones[(size_t)milestone];
+    if (reachedTicks.load(std::memory_order_relaxed) != 0)
+        return;
+
+    juce::int64 notReached = 0;
+    reachedTicks.compare_exchange_strong(notReached, juce::Time::getHighResolutionTicks());
+}
+
+double StartupProfiler::getElapsedMilliseconds() const {
+    return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - originTicks) * 1000.0;
+}
+
+void StartupProfiler::addAudioReadyMilestone() {
+    juce::int64 notReached = 0;
+    if (audioReadyTicks.compare_exchange_strong(notReached, juce::Time::getHighResolutionTicks()))
+        addMilestone("Audio ready");
+}
+
+double StartupProfiler::getTimeToAudioMilliseconds() const {
+    auto ticks = audioReadyTicks.load();
+    if (ticks == 0)
+        return -1.0;
+
+    return juce::Time::highResolutionTicksToSeconds(ticks - originTicks) * 1000.0;
+}
+
+//==============================================================================
+juce::File StartupProfiler::getTraceFile() const {
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("AudioChain")
+        .getChildFile("startup-trace.json");
+}
+
+void StartupProfiler::writeTrace() const {
+    juce::Array<Event> eventsToWrite;
+    {
+        const juce::ScopedLock lock(eventLock);
+        eventsToWrite = events;
+    }
+
+    for (size_t i = 0; i < (size_t)RealtimeMilestone::numMilestones; ++i) {
+        if (auto ticks = realtimeMilestones[i].load()) {
+            Event event;
+            event.name = getRealtimeMilestoneName((RealtimeMilestone)i);
+            event.threadName = "Audio";
+            event.startTicks = event.endTicks = ticks;
+            eventsToWrite.add(event);
+        }
+    }
+
+    // Chrome trace event format: complete events ("X") for phases, instant events ("i") for milestones
+    juce::Array<juce::var> traceEvents;
+    for (const auto &event : eventsToWrite) {
+        auto *traceEvent = new juce::DynamicObject();
+        traceEvent->setProperty("name", event.name);
+        traceEvent->setProperty("cat", "startup");
+        traceEvent->setProperty("pid", 1);
+        traceEvent->setProperty("tid", (juce::int64)event.threadId);
+        traceEvent->setProperty("ts", ticksToMicroseconds(event.startTicks));
+
+        if (event.endTicks > event.startTicks) {
+            traceEvent->setProperty("ph", "X");
+            traceEvent->setProperty("dur", ticksToMicroseconds(event.endTicks) - ticksToMicroseconds(event.startTicks));
+        } else {
+            traceEvent->setProperty("ph", "i");
+            traceEvent->setProperty("s", "g");
+        }
+
+        auto *args = new juce::DynamicObject();
+        args->setProperty("thread", event.threadName);
+        traceEvent->setProperty("args", juce::var(args));
+
+        traceEvents.add(juce::var(traceEvent));
+    }
+
+    auto *trace = new juce::DynamicObject();
+    trace->setProperty("traceEvents", traceEvents);
+    trace->setProperty("displayTimeUnit", "ms");
+
+    auto timeToAudioMs = getTimeToAudioMilliseconds();
+    if (timeToAudioMs >= 0.0) {
+        trace->setProperty("timeToAudioMs", timeToAudioMs);
+        trace->setProperty("timeToAudioTargetMs", timeToAudioTargetMs);
+
+        DBG("[Startup] Time to audio: " + juce::String(timeToAudioMs, 1) + " ms" +
+            (timeToAudioMs > timeToAudioTargetMs
+                 ? " - over the " + juce::String(timeToAudioTargetMs, 0) + " ms target"
+                 : juce::String()));
+    }
+
+    auto traceFile = getTraceFile();
+    traceFile.getParentDirectory().createDirectory();
+
+    if (traceFile.replaceWithText(juce::JSON::toString(juce::var(trace))))
+        DBG("[Startup] Trace written to " + traceFile.getFullPathName());
+}
+
+//==============================================================================
+juce::String StartupProfiler::getRealtimeMilestoneName(RealtimeMilestone milestone) {
+    switch (milestone) {
+    case RealtimeMilestone::firstAudioCallback:
+        return "First audio callback";
+    case RealtimeMilestone::numMilestones:
+    default:
+        return {};
+    }
+}
+
+double StartupProfiler::ticksToMicroseconds(juce::int64 ticks) const {
+    return juce::Time::highResolutionTicksToSeconds(ticks - originTicks) * 1000000.0;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+
+//==============================================================================
+/**
+    Phase-level startup tracing.
+
+    - Phases are timed with ScopedPhase, from any thread
+    - Milestones (window shown, devices ready, first audio callback...) are
+      instant events; the realtime variant is lock and allocation free
+    - The trace is written as Chrome trace event JSON (chrome://tracing, Perfetto)
+      to AudioChain/startup-trace.json, and summarised with DBG
+    - Time to audio (until the device is open and ready) is checked against a one second target
+
+    Times are relative to the first use of the profiler, which should be as
+    early as possible in JUCEApplication::initialise.
+*/
+class StartupProfiler {
+  public:
+    //==============================================================================
+    class ScopedPhase {
+      public:
+        explicit ScopedPhase(const juce::String &phaseName);
+        ~ScopedPhase();
+
+      private:
+        juce::String name;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedPhase)
+    };
+
+    // Milestones that may be reached on the audio thread
+    enum class RealtimeMilestone { firstAudioCallback, numMilestones };
+
+    //==============================================================================
+    static StartupProfiler &getInstance();
+
+    void addPhase(const juce::String &name, juce::int64 startTicks, juce::int64 endTicks);
+    void addMilestone(const juce::String &name);
+    void addMilestone(RealtimeMilestone milestone) noexcept;
+
+    // Milliseconds since the profiler started
+    double getElapsedMilliseconds() const;
+
+    // Marks the audio device as open and ready to run the chain, the end of time to audio. Only the
+    // first call counts. (The first audio callback waits for the user to start processing, so it
+    // stays in the trace as extra information.)
+    void addAudioReadyMilestone();
+
+    // Milliseconds from the start to the audio ready milestone, or -1 before it. With a warm plugin
+    // cache it should stay below the target; the trace notes when it doesn't.
+    double getTimeToAudioMilliseconds() const;
+    static constexpr double timeToAudioTargetMs = 1000.0;
+
+    // Writes the trace collected so far. Can be called again later to include more events.
+    void writeTrace() const;
+    juce::File getTraceFile() const;
+
+  private:
+    //==============================================================================
+    struct Event {
+        juce::String name;
+        juce::String threadName;
+        juce::uint64 threadId = 0;
+        juce::int64 startTicks = 0;
+        juce::int64 endTicks = 0; // Same as startTicks for milestones
+    };
+
+    StartupProfiler();
+
+    const juce::int64 originTicks;
+    juce::Array<Event> events;
+    mutable juce::CriticalSection eventLock;
+
+    std::atomic<juce::int64> realtimeMilestones[(size_t)RealtimeMilestone::numMilestones];
+    std::atomic<juce::int64> audioReadyTicks{0};
+
+    void addEvent(const juce::String &name, juce::int64 startTicks, juce::int64 endTicks);
+    static juce::String getRealtimeMilestoneName(RealtimeMilestone milestone);
+    double ticksToMicroseconds(juce::int64 ticks) const;
+
+    JUCE_DECLARE_NON_COPYABLE(StartupProfiler)
+};
@@ -0,0 +1,84 @@
+#include "StereoFieldComponent.h"
+
+//==============================================================================
+StereoFieldComponent::StereoFieldComponent(AudioProcessor &processor) : audioProcessor(processor) {
+    setOpaque(true);
+    trace.preallocateSpace(AudioAnalyser::numGoniometerPoints * 3);
+    startTimerHz(refreshRateHz);
+}
+
+StereoFieldComponent::~StereoFieldComponent() { stopTimer(); }
+
+//==============================================================================
+void StereoFieldComponent::timerCallback() {
+    // Only repaints when the analyser published something new
+    if (audioProcessor.getAnalysisSnapshot(snapshot))
+        repaint();
+}
+
+void StereoFieldComponent::resized() {
+    auto bounds = getLocalBounds().toFloat();
+
+    correlationBounds = bounds.removeFromBottom((float)correlationHeight).reduced(2.0f, 1.0f);
+    bounds.removeFromBottom(4.0f);
+
+    auto size = juce::jmin(bounds.getWidth(), bounds.getHeight());
+    scopeBounds = bounds.withSizeKeepingCentre(size, size).reduced(2.0f);
+}
+
+void StereoFieldComponent::paint(juce::Graphics &g) {
+    g.fillAll(juce::Colour(0xff0a0a0a));
+
+    drawScope(g);
+    drawCorrelation(g);
+}
+
+void StereoFieldComponent::drawScope(juce::Graphics &g) {
+    g.setColour(juce::Colours::white.withAlpha(0.2f));
+    g.drawRect(scopeBounds, 1.0f);
+
+    // Mid and side axes, and the left and right diagonals
+    auto centre = scopeBounds.getCentre();
+    g.setColour(juce::Colour(0xff404040));
+    g.drawLine(centre.x, scopeBounds.getY(), centre.x, scopeBounds.getBottom(), 1.0f);
+    g.drawLine(scopeBounds.getX(), centre.y, scopeBounds.getRight(), centre.y, 1.0f);
+    g.drawLine({scopeBounds.getTopLeft(), scopeBounds.getBottomRight()}, 0.5f);
+    g.drawLine({scopeBounds.getTopRight(), scopeBounds.getBottomLeft()}, 0.5f);
+
+    auto numPoints = snapshot.getNumGoniometerPoints();
+    if (numPoints == 0)
+        return;
+
+    // Full scale reaches the edge; y grows downwards
+    auto scale = scopeBounds.getWidth() * 0.5f;
+    const auto *points = snapshot.goniometer.data();
+
+    trace.clear();
+    trace.startNewSubPath(centre.x + points[0] * scale, centre.y - points[1] * scale);
+    for (int i = 1; i < numPoints; ++i)
+        trace.lineTo(centre.x + points[i * 2] * scale, centre.y - points[i * 2 + 1] * scale);
+
+    g.saveState();
+    g.reduceClipRegion(scopeBounds.toNearestInt());
+    g.setColour(juce::Colour(0xff00ff88).withAlpha(0.6f));
+    g.strokePath(trace, juce::PathStrokeType(1.0f));
+    g.restoreState();
+}
+
+void StereoFieldComponent::drawCorrelation(juce::Graphics &g) {
+    g.setColour(juce::Colour(0xff1a1a1a));
+    g.fillRect(correlationBounds);
+
+    // Bar from the centre (0) towards -1 on the left or +1 on the right
+    auto correlation = snapshot.correlation;
+    auto centreX = correlationBounds.getCentreX();
+    auto endX = centreX + correlation * correlationBounds.getWidth() * 0.5f;
+
+    g.setColour(correlation < 0.0f ? juce::Colour(0xffff6666) : juce::Colour(0xff00ff88));
+    g.fillRect(juce::Rectangle<float>::leftTopRightBottom(juce::jmin(centreX, endX), correlationBounds.getY(),
+                                                          juce::jmax(centreX, endX), correlationBounds.getBottom()));
+
+    g.setColour(juce::Colours::white.withAlpha(0.4f));
+    g.drawVerticalLine((int)centreX, correlationBounds.getY(), correlationBounds.getBottom());
+    g.drawRect(correlationBounds, 1.0f);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "AudioProcessor.h"
+#include <juce_core/juce_core.h>
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+//==============================================================================
+/**
+    Goniometer (vectorscope) with a phase correlation meter below it.
+
+    Both come from the analyser's snapshots, so the message thread only copies
+    a fixed number of points per frame. The points are drawn as one path
+    stroked once per frame, whose storage is kept between frames.
+*/
+class StereoFieldComponent : public juce::Component, private juce::Timer {
+  public:
+    explicit StereoFieldComponent(AudioProcessor &processor);
+    ~StereoFieldComponent() override;
+
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+
+  private:
+    //==============================================================================
+    AudioProcessor &audioProcessor;
+    AnalysisSnapshot snapshot;
+
+    juce::Path trace;
+    juce::Rectangle<float> scopeBounds;
+    juce::Rectangle<float> correlationBounds;
+
+    static constexpr int refreshRateHz = 30;
+    static constexpr int correlationHeight = 12;
+
+    void timerCallback() override;
+    void drawScope(juce::Graphics &g);
+    void drawCorrelation(juce::Graphics &g);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StereoFieldComponent)
+};
@@ -1,4 +1,5 @@
 #include "UserConfig.h"
+#include "SessionFile.h"
 
 UserConfig::UserConfig() {
     // Get application data directory for storing config
@@ -9,12 +10,18 @@ UserConfig::UserConfig() {
         audioChainDir.createDirectory();
 
     configFile = audioChainDir.getChildFile("config.xml");
+    sessionFile = audioChainDir.getChildFile("session.acsn");
+    legacySessionFile = audioChainDir.getChildFile("session.xml");
+    presetsDirectory = audioChainDir.getChildFile("presets");
 
     initializeDefaults();
     loadFromFile();
 }
 
-UserConfig::~UserConfig() { saveToFile(); }
+UserConfig::~UserConfig() {
+    stopTimer();
+    saveToFile();
+}
 
 void UserConfig::addVSTSearchPath(const juce::String &path) {
     if (path.isNotEmpty() && !vstSearchPaths.contains(path)) {
@@ -40,6 +47,35 @@ void UserConfig::setVSTSearchPaths(const juce::StringArray &paths) {
     saveToFile();
 }
 
+void UserConfig::notePluginUsed(const juce::String &identifier, const juce::String &file) {
+    if (identifier.isEmpty())
+        return;
+
+    auto &usage = pluginUsage[identifier];
+    usage.file = file;
+    usage.lastUsed = juce::Time::getCurrentTime();
+    ++usage.useCount;
+
+    // Forget the least recently used plugins once the list gets long
+    while ((int)pluginUsage.size() > maxRecentPlugins) {
+        auto oldest = pluginUsage.begin();
+        for (auto it = pluginUsage.begin(); it != pluginUsage.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed)
+                oldest = it;
+        }
+        pluginUsage.erase(oldest);
+    }
+
+    // Loading a whole chain is one save, not one per plugin
+    if (!isTimerRunning())
+        startTimer(usageSaveDelayMs);
+}
+
+void UserConfig::timerCallback() {
+    stopTimer();
+    saveToFile();
+}
+
 void UserConfig::saveToFile() {
     juce::XmlElement config("AudioChainConfig");
 
@@ -49,6 +85,15 @@ void UserConfig::saveToFile() {
         pathElement->addTextElement(path);
     }
 
+    auto recentPluginsElement = config.createNewChildElement("RecentPlugins");
+    for (const auto &[identifier, usage] : pluginUsage) {
+        auto pluginElement = recentPluginsElement->createNewChildElement("Plugin");
+        pluginElement->setAttribute("identifier", identifier);
+        pluginElement->setAttribute("file", usage.file);
+        pluginElement->setAttribute("lastUsed", juce::String(usage.lastUsed.toMilliseconds()));
+        pluginElement->setAttribute("count", usage.useCount);
+    }
+
     config.writeTo(configFile);
 }
 
@@ -71,6 +116,84 @@ void UserConfig::loadFromFile() {
             }
         }
     }
+
+    auto recentPluginsElement = config->getChildByName("RecentPlugins");
+    if (recentPluginsElement != nullptr) {
+        pluginUsage.clear();
+        for (auto *pluginElement : recentPluginsElement->getChildWithTagNameIterator("Plugin")) {
+            auto identifier = pluginElement->getStringAttribute("identifier");
+            if (identifier.isEmpty())
+                continue;
+
+            PluginUsage usage;
+            usage.file = pluginElement->getStringAttribute("file");
+            usage.lastUsed = juce::Time(pluginElement->getStringAttribute("lastUsed").getLargeIntValue());
+            usage.useCount = pluginElement->getIntAttribute("count", 1);
+            pluginUsage[identifier] = usage;
+        }
+    }
+}
+
+void UserConfig::saveSession(const juce::ValueTree &session) const {
+    if (SessionFile::write(session, sessionFile, SessionFile::Compression::zlib, &PluginStateStore::getInstance())) {
+        // The binary session supersedes the XML one from older versions
+        legacySessionFile.deleteFile();
+    }
+}
+
+juce::ValueTree UserConfig::loadSession() const {
+    if (sessionFile.existsAsFile())
+        return SessionFile::read(sessionFile, &PluginStateStore::getInstance());
+
+    return SessionFile::readXml(legacySessionFile);
+}
+
+bool UserConfig::savePreset(const juce::String &name, const juce::ValueTree &chain) const {
+    auto presetFile = getPresetFile(name);
+    if (presetFile == juce::File() || !presetsDirectory.createDirectory())
+        return false;
+
+    return SessionFile::write(chain, presetFile, SessionFile::Compression::zlib, &PluginStateStore::getInstance());
+}
+
+juce::ValueTree UserConfig::loadPreset(const juce::String &name) const {
+    auto presetFile = getPresetFile(name);
+    if (!presetFile.existsAsFile())
+        return {};
+
+    return SessionFile::read(presetFile, &PluginStateStore::getInstance());
+}
+
+bool UserConfig::deletePreset(const juce::String &name) const {
+    auto presetFile = getPresetFile(name);
+    return presetFile.existsAsFile() && presetFile.deleteFile();
+}
+
+juce::StringArray UserConfig::getPresetNames() const {
+    juce::StringArray names;
+    for (const auto &presetFile : presetsDirectory.findChildFiles(juce::File::findFiles, false, "*.acsn"))
+        names.add(presetFile.getFileNameWithoutExtension());
+
+    names.sortNatural();
+    return names;
+}
+
+int UserConfig::removeUnusedPluginStates() const {
+    // Every file written with the state store - the session and the presets
+    auto referencedHashes = SessionFile::getStateHashes(sessionFile);
+    for (const auto &presetFile : presetsDirectory.findChildFiles(juce::File::findFiles, false, "*.acsn"))
+        referencedHashes.addArray(SessionFile::getStateHashes(presetFile));
+
+    // Recent states are kept, as another instance (or an autosave in flight) may still refer to them
+    return PluginStateStore::getInstance().removeUnreferenced(referencedHashes, juce::RelativeTime::hours(1));
+}
+
+juce::File UserConfig::getPresetFile(const juce::String &name) const {
+    auto fileName = juce::File::createLegalFileName(name.trim());
+    if (fileName.isEmpty())
+        return {};
+
+    return presetsDirectory.getChildFile(fileName + ".acsn");
 }
 
 juce::StringArray UserConfig::getDefaultVSTSearchPaths() {
@@ -2,11 +2,21 @@
 
 #include <juce_core/juce_core.h>
 #include <juce_data_structures/juce_data_structures.h>
+#include <juce_events/juce_events.h>
+#include <map>
 
-class UserConfig {
+class UserConfig : private juce::Timer {
   public:
+    // How often and how recently a plugin was loaded, keyed by plugin identifier
+    struct PluginUsage {
+        juce::String file; // Plugin file or bundle, so scans can prioritise it
+        juce::Time lastUsed;
+        int useCount = 0;
+    };
+    using PluginUsageMap = std::map<juce::String, PluginUsage>;
+
     UserConfig();
-    ~UserConfig();
+    ~UserConfig() override;
 
     // VST Search Paths
     void addVSTSearchPath(const juce::String &path);
@@ -15,6 +25,25 @@ class UserConfig {
     juce::StringArray getVSTSearchPaths() const;
     void setVSTSearchPaths(const juce::StringArray &paths);
 
+    // Recently used plugins (used to rank plugin search results). Saved a few seconds after the last use
+    // on the message thread, or when the config is destroyed.
+    void notePluginUsed(const juce::String &identifier, const juce::String &file);
+    PluginUsageMap getPluginUsage() const { return pluginUsage; }
+
+    // Last session's plugin chain, restored at startup
+    void saveSession(const juce::ValueTree &session) const;
+    juce::ValueTree loadSession() const;
+    juce::File getSessionFile() const { return sessionFile; }
+
+    // Named plugin chains, kept in AudioChain/presets. Large states go into the state store like the session's.
+    bool savePreset(const juce::String &name, const juce::ValueTree &chain) const;
+    juce::ValueTree loadPreset(const juce::String &name) const;
+    bool deletePreset(const juce::String &name) const;
+    juce::StringArray getPresetNames() const;
+
+    // Deletes stored plugin states that neither the session nor any preset refers to
+    int removeUnusedPluginStates() const;
+
     // Configuration persistence
     void saveToFile();
     void loadFromFile();
@@ -24,9 +53,18 @@ class UserConfig {
 
   private:
     juce::StringArray vstSearchPaths;
+    PluginUsageMap pluginUsage;
     juce::File configFile;
+    juce::File sessionFile;
+    juce::File legacySessionFile; // session.xml, read if there's no binary session yet
+    juce::File presetsDirectory;
+
+    static constexpr int maxRecentPlugins = 100;
+    static constexpr int usageSaveDelayMs = 5000;
 
     void initializeDefaults();
+    juce::File getPresetFile(const juce::String &name) const;
+    void timerCallback() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UserConfig)
 };
\ No newline at end of file